@@ -62,6 +62,123 @@ log_response_t LOG_FILTER[BLOB_FILTER_HEIGHT][BLOB_FILTER_WIDTH] = {
     {-0.0239, -0.0460, -0.0499, -0.0460, -0.0239},
 };
 
+/**
+ * The reduced-precision LoG filter kernel, and the threshold on its response.
+ * These are 7-bit integer weights, the full kernel scaled by a common factor
+ * and rounded, that make the same decisions as the full kernel on every window
+ * of the headlight images (see src/log_quantize.cpp), so the response only
+ * needs an 8-bit adder tree.
+ **/
+static const int LOG_NARROW_WEIGHT_BITS = 7;
+static const int LOG_NARROW_RESPONSE_BITS = 8;
+typedef ap_int<LOG_NARROW_RESPONSE_BITS> log_narrow_response_t;
+
+static const log_narrow_response_t LOG_NARROW_RESPONSE_THRESHOLD = 74;
+static const ap_int<LOG_NARROW_WEIGHT_BITS>
+LOG_NARROW_FILTER[BLOB_FILTER_HEIGHT][BLOB_FILTER_WIDTH] = {
+    { -4,  -7,  -8,  -7,  -4},
+    { -7,  -1,  14,  -1,  -7},
+    { -8,  14,  48,  14,  -8},
+    { -7,  -1,  14,  -1,  -7},
+    { -4,  -7,  -8,  -7,  -4},
+};
+
+/**
+ * The response type, kernel, and threshold used by the blob filter. With
+ * NARROW_LOG_FILTER defined, the blob filter uses the reduced-precision kernel.
+ * The filter bank always uses the full kernels, as its kernels' responses are
+ * compared with each other.
+ **/
+#ifdef NARROW_LOG_FILTER
+typedef log_narrow_response_t detection_response_t;
+#define DETECTION_FILTER            LOG_NARROW_FILTER
+#define DETECTION_THRESHOLD         LOG_NARROW_RESPONSE_THRESHOLD
+#else
+typedef log_response_t detection_response_t;
+#define DETECTION_FILTER            LOG_FILTER
+#define DETECTION_THRESHOLD         LOG_RESPONSE_THRESHOLD
+#endif /* NARROW_LOG_FILTER */
+
+/**
+ * The larger LoG filter kernels of the filter bank. Each has a larger sigma
+ * than the one before it, and is scaled by its sigma squared, so that the
+ * responses of the kernels are comparable, and share the blob filter's
+ * threshold. The blob filter is the bank's first kernel.
+ **/
+static const log_response_t LOG_FILTER_7[7][7] = {
+    {-0.0094, -0.0173, -0.0234, -0.0250, -0.0234, -0.0173, -0.0094},
+    {-0.0173, -0.0258, -0.0161, -0.0046, -0.0161, -0.0258, -0.0173},
+    {-0.0234, -0.0161,  0.0454,  0.0924,  0.0454, -0.0161, -0.0234},
+    {-0.0250, -0.0046,  0.0924,  0.1626,  0.0924, -0.0046, -0.0250},
+    {-0.0234, -0.0161,  0.0454,  0.0924,  0.0454, -0.0161, -0.0234},
+    {-0.0173, -0.0258, -0.0161, -0.0046, -0.0161, -0.0258, -0.0173},
+    {-0.0094, -0.0173, -0.0234, -0.0250, -0.0234, -0.0173, -0.0094},
+};
+
+static const log_response_t LOG_FILTER_9[9][9] = {
+    {-0.0049, -0.0082, -0.0117, -0.0139, -0.0146, -0.0139, -0.0117, -0.0082,
+     -0.0049},
+    {-0.0082, -0.0132, -0.0157, -0.0138, -0.0118, -0.0138, -0.0157, -0.0132,
+     -0.0082},
+    {-0.0117, -0.0157, -0.0090,  0.0085,  0.0187,  0.0085, -0.0090, -0.0157,
+     -0.0117},
+    {-0.0139, -0.0138,  0.0085,  0.0489,  0.0707,  0.0489,  0.0085, -0.0138,
+     -0.0139},
+    {-0.0146, -0.0118,  0.0187,  0.0707,  0.0984,  0.0707,  0.0187, -0.0118,
+     -0.0146},
+    {-0.0139, -0.0138,  0.0085,  0.0489,  0.0707,  0.0489,  0.0085, -0.0138,
+     -0.0139},
+    {-0.0117, -0.0157, -0.0090,  0.0085,  0.0187,  0.0085, -0.0090, -0.0157,
+     -0.0117},
+    {-0.0082, -0.0132, -0.0157, -0.0138, -0.0118, -0.0138, -0.0157, -0.0132,
+     -0.0082},
+    {-0.0049, -0.0082, -0.0117, -0.0139, -0.0146, -0.0139, -0.0117, -0.0082,
+     -0.0049},
+};
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+/* Computes the response of a SIZE by SIZE kernel to the part of the filter
+ * bank's window centered on its center. The window's top-left corner is at
+ * (start_row, start_col), wrapping around. */
+template <int SIZE>
+static log_response_t bank_response(monochrome_bank_window_t window,
+        int start_row, int start_col, const log_response_t filter[SIZE][SIZE]) {
+#pragma HLS INLINE
+
+    static const int OFFSET = (BLOB_BANK_WIDTH - SIZE) / 2;
+    log_response_t response = 0;
+    bank_response_row: for (int i = 0; i < SIZE; i++) {
+        bank_response_col: for (int j = 0; j < SIZE; j++) {
+            int row = start_row + OFFSET + i;
+            int col = start_col + OFFSET + j;
+            row = (row < BLOB_BANK_HEIGHT) ? row : row - BLOB_BANK_HEIGHT;
+            col = (col < BLOB_BANK_WIDTH) ? col : col - BLOB_BANK_WIDTH;
+            if (window[row][col]) {
+                response += filter[i][j];
+            }
+        }
+    }
+
+    return response;
+}
+
+/* Computes the response of each of the filter bank's kernels to the window. */
+static void bank_responses(monochrome_bank_window_t window, int start_row,
+        int start_col, log_response_t responses[NUM_BLOB_KERNELS]) {
+#pragma HLS INLINE
+
+    responses[0] = bank_response<BLOB_FILTER_WIDTH>(window, start_row,
+            start_col, LOG_FILTER);
+    responses[1] = bank_response<7>(window, start_row, start_col,
+            LOG_FILTER_7);
+    responses[2] = bank_response<9>(window, start_row, start_col,
+            LOG_FILTER_9);
+    return;
+}
+
 /*----------------------------------------------------------------------------
  * LoG Filter Module
  *----------------------------------------------------------------------------*/
@@ -80,7 +197,7 @@ blob_detection_t compute_blob_detection(monochrome_window_t window,
         int start_row, int start_col) {
 #pragma HLS INLINE
 
-    log_response_t response = 0;
+    detection_response_t response = 0;
     blob_detect_row: for(int i = 0; i < BLOB_FILTER_HEIGHT ; i++) {
         blob_detect_col: for(int j = 0; j < BLOB_FILTER_WIDTH; j++) {
             int row = (start_row + i < BLOB_FILTER_HEIGHT) ? start_row + i
@@ -88,12 +205,63 @@ blob_detection_t compute_blob_detection(monochrome_window_t window,
             int col = (start_col + j < BLOB_FILTER_WIDTH) ? start_col + j
                     : start_col + j - BLOB_FILTER_WIDTH;
             if (window[row][col]) {
-                response += LOG_FILTER[i][j];
+                response += DETECTION_FILTER[i][j];
             }
         }
     }
 
-    return response >= LOG_RESPONSE_THRESHOLD;
+    return response >= DETECTION_THRESHOLD;
+}
+
+/*----------------------------------------------------------------------------
+ * LoG Filter Bank Module
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Decides which of the filter bank's kernels detect a blob in the given
+ * window in the image.
+ *
+ * This is the combinational interface to the filter bank.
+ **/
+blob_kernel_mask_t compute_blob_kernel_mask(monochrome_bank_window_t window,
+        int start_row, int start_col) {
+#pragma HLS INLINE
+
+    log_response_t responses[NUM_BLOB_KERNELS];
+    bank_responses(window, start_row, start_col, responses);
+
+    blob_kernel_mask_t mask = 0;
+    kernel_mask_loop: for (int k = 0; k < NUM_BLOB_KERNELS; k++) {
+        mask[k] = responses[k] >= LOG_RESPONSE_THRESHOLD;
+    }
+
+    return mask;
+}
+
+/**
+ * Decides which of the filter bank's kernels responds the most strongly to
+ * a blob in the given window in the image. Ties go to the smaller kernel.
+ *
+ * This is the combinational interface to the filter bank.
+ **/
+blob_kernel_id_t compute_blob_kernel_id(monochrome_bank_window_t window,
+        int start_row, int start_col) {
+#pragma HLS INLINE
+
+    log_response_t responses[NUM_BLOB_KERNELS];
+    bank_responses(window, start_row, start_col, responses);
+
+    blob_kernel_id_t best_id = 0;
+    log_response_t best_response = LOG_RESPONSE_THRESHOLD;
+    kernel_id_loop: for (int k = 0; k < NUM_BLOB_KERNELS; k++) {
+        if (responses[k] >= best_response && (best_id == 0 ||
+                responses[k] > best_response)) {
+            best_id = k + 1;
+            best_response = responses[k];
+        }
+    }
+
+    return best_id;
 }
 
 /*----------------------------------------------------------------------------
@@ -116,3 +284,27 @@ void blob_detection_top(monochrome_stream_t& monochrome_stream,
             blob_detection_stream);
     return;
 }
+
+/**
+ * The top functions for the filter bank, with each of its outputs, when it is
+ * synthesized by itself.
+ **/
+void blob_filter_bank_top(monochrome_stream_t& monochrome_stream,
+        blob_kernel_mask_stream_t& kernel_mask_stream) {
+#pragma HLS INTERFACE axis port=monochrome_stream
+#pragma HLS INTERFACE axis port=kernel_mask_stream
+
+    blob_filter_bank<IMAGE_WIDTH, IMAGE_HEIGHT>(monochrome_stream,
+            kernel_mask_stream);
+    return;
+}
+
+void blob_best_kernel_top(monochrome_stream_t& monochrome_stream,
+        blob_kernel_id_stream_t& kernel_id_stream) {
+#pragma HLS INTERFACE axis port=monochrome_stream
+#pragma HLS INTERFACE axis port=kernel_id_stream
+
+    blob_best_kernel<IMAGE_WIDTH, IMAGE_HEIGHT>(monochrome_stream,
+            kernel_id_stream);
+    return;
+}
@@ -107,15 +107,19 @@ int main()
 	monochrome_stream_t monochrome_stream;
     blob_detection_stream_t blob_detection_stream;
 
-    for (int i = 0; i < TEST_VEC_WIDTH*TEST_VEC_HEIGHT; i++) {
-    	blob_detection_axis_t inpkt;
-    	inpkt.tdata = INPUT_MONOCHROME[0][i];
+    for (int i = 0; i < TEST_VEC_WIDTH*TEST_VEC_HEIGHT; i += PIXELS_PER_BEAT) {
+    	monochrome_axis_t inpkt;
+    	for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+    		int pixel = i + lane;
+    		inpkt.tdata[lane] = INPUT_MONOCHROME[pixel / TEST_VEC_WIDTH][pixel % TEST_VEC_WIDTH];
+    	}
     	inpkt.tkeep = -1;
-    	inpkt.tlast = (i == TEST_VEC_WIDTH*TEST_VEC_HEIGHT-1) ? 1 : 0;
+    	inpkt.tlast = (i + PIXELS_PER_BEAT == TEST_VEC_WIDTH*TEST_VEC_HEIGHT) ? 1 : 0;
     	monochrome_stream << inpkt;
     }
 
-	blob_detection(monochrome_stream, blob_detection_stream);
+	blob_detection<TEST_VEC_WIDTH, TEST_VEC_HEIGHT>(monochrome_stream,
+			blob_detection_stream);
 
 	int last = 0;
 	int count = 0;
@@ -126,22 +130,29 @@ int main()
 			blob_detection_axis_t outpkt;
 			blob_detection_stream >> outpkt;
 			last = outpkt.tlast.to_int();
-			image[0][count] = outpkt.tdata.to_int();
-			count += 1;
+			for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+				image[count / TEST_VEC_WIDTH][count % TEST_VEC_WIDTH] = outpkt.tdata[lane].to_int();
+				count += 1;
+			}
 		}
 	}
 	printf("Count: %d\n", count);
+	int errors = (count == TEST_VEC_WIDTH*TEST_VEC_HEIGHT) ? 0 : 1;
 	for (int i = 0; i < TEST_VEC_HEIGHT; i++) {
 		for (int j = 0; j < TEST_VEC_WIDTH; j++) {
 			if (image[i][j]) {
 				if (OUTPUT_DETECTIONS[i][j])
 					printf("Blob Detected Successfully at row: %d, col: %d\n", i, j);
-				else
+				else {
 					printf("Error: False Positive at row: %d, col: %d\n", i, j);
+					errors++;
+				}
 			}
 			else {
-				if (OUTPUT_DETECTIONS[i][j])
+				if (OUTPUT_DETECTIONS[i][j]) {
 					printf("Blob Missed at row: %d, col: %d\n", i, j);
+					errors++;
+				}
 			}
 		}
 	}
@@ -153,5 +164,5 @@ int main()
 		printf("\n");
 	}
 
-	return 0;
+	return (errors == 0) ? 0 : 1;
 }
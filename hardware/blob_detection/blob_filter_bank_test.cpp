@@ -0,0 +1,171 @@
+/**
+ * @file blob_filter_bank_test.cpp
+ * @date Tuesday, October 27, 2026 at 10:12:39 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the testbench for the LoG filter bank.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <assert.h>                 // Assert macro
+#include <stdio.h>                  // Printf function
+
+#include "monochrome.h"             // Definition of the monochrome types
+#include "blob_detection.h"         // Filter bank interface and types
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The size of the test image, which is a few beats wide at any beat width
+static const int TEST_WIDTH = 32;
+static const int TEST_HEIGHT = 32;
+
+// The distance from the center of the bank's window to its edge
+static const int BANK_REACH = BLOB_BANK_WIDTH / 2;
+
+// A blob in the test image, and what the filter bank should say about it
+typedef struct test_blob {
+    int cx, cy;                     // The center of the blob
+    double radius;                  // The radius of the blob
+    int mask;                       // The expected mask at the center
+    int id;                         // The expected kernel ID at the center
+} test_blob_t;
+
+/* A plus sign is best matched by the smallest kernel, a 3x3 square by the
+ * middle one, and a disc of 21 pixels by the largest, which the smallest
+ * barely responds to. */
+static const test_blob_t TEST_BLOBS[] = {
+    {8, 8, 1.0, 0x3, 1},
+    {23, 8, 1.5, 0x7, 2},
+    {16, 23, 2.5, 0x6, 3},
+};
+static const int NUM_TEST_BLOBS = sizeof(TEST_BLOBS) / sizeof(TEST_BLOBS[0]);
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Streams in the image, a beat at a time
+static void stream_image(const int image[TEST_HEIGHT][TEST_WIDTH],
+        monochrome_stream_t& stream)
+{
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x += PIXELS_PER_BEAT) {
+            monochrome_axis_t pkt;
+            for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+                pkt.tdata[i] = image[y][x+i];
+            }
+            pkt.tkeep = -1;
+            pkt.tlast = (y == TEST_HEIGHT - 1) &&
+                    (x + PIXELS_PER_BEAT == TEST_WIDTH);
+            stream << pkt;
+        }
+    }
+}
+
+// Collects the bank's window centered on the pixel, which must be interior
+static void fetch_window(const int image[TEST_HEIGHT][TEST_WIDTH], int x, int y,
+        monochrome_bank_window_t window)
+{
+    for (int i = 0; i < BLOB_BANK_HEIGHT; i++) {
+        for (int j = 0; j < BLOB_BANK_WIDTH; j++) {
+            window[i][j] = image[y-BANK_REACH+i][x-BANK_REACH+j];
+        }
+    }
+}
+
+// Checks if the pixel is far enough from the edge for the bank's window
+static bool interior(int x, int y)
+{
+    return x >= BANK_REACH && x < TEST_WIDTH - BANK_REACH &&
+            y >= BANK_REACH && y < TEST_HEIGHT - BANK_REACH;
+}
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+int main()
+{
+    // Draw each blob as the pixels within its radius of its center
+    int image[TEST_HEIGHT][TEST_WIDTH] = {{0}};
+    for (int b = 0; b < NUM_TEST_BLOBS; b++) {
+        const test_blob_t& blob = TEST_BLOBS[b];
+        for (int y = 0; y < TEST_HEIGHT; y++) {
+            for (int x = 0; x < TEST_WIDTH; x++) {
+                int dx = x - blob.cx;
+                int dy = y - blob.cy;
+                if (dx * dx + dy * dy <= blob.radius * blob.radius) {
+                    image[y][x] = 1;
+                }
+            }
+        }
+    }
+
+    // The combinational interface picks the expected kernels at the centers
+    for (int b = 0; b < NUM_TEST_BLOBS; b++) {
+        const test_blob_t& blob = TEST_BLOBS[b];
+        monochrome_bank_window_t window;
+        fetch_window(image, blob.cx, blob.cy, window);
+        assert(compute_blob_kernel_mask(window, 0, 0).to_int() == blob.mask);
+        assert(compute_blob_kernel_id(window, 0, 0).to_int() == blob.id);
+
+        // The window's start wraps around, as it does in the pipeline
+        monochrome_bank_window_t rotated;
+        for (int i = 0; i < BLOB_BANK_HEIGHT; i++) {
+            for (int j = 0; j < BLOB_BANK_WIDTH; j++) {
+                rotated[(i + 3) % BLOB_BANK_HEIGHT][(j + 5) % BLOB_BANK_WIDTH]
+                        = window[i][j];
+            }
+        }
+        assert(compute_blob_kernel_mask(rotated, 3, 5).to_int() == blob.mask);
+        assert(compute_blob_kernel_id(rotated, 3, 5).to_int() == blob.id);
+    }
+
+    // Run both sequential interfaces over the image
+    monochrome_stream_t mask_input, id_input;
+    blob_kernel_mask_stream_t mask_stream;
+    blob_kernel_id_stream_t id_stream;
+    stream_image(image, mask_input);
+    stream_image(image, id_input);
+    blob_filter_bank<TEST_WIDTH, TEST_HEIGHT>(mask_input, mask_stream);
+    blob_best_kernel<TEST_WIDTH, TEST_HEIGHT>(id_input, id_stream);
+
+    /* Every pixel matches the combinational interface, or is zero near the
+     * edges, and the best kernel is always one of the kernels that fired. */
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x += PIXELS_PER_BEAT) {
+            blob_kernel_mask_axis_t mask_pkt;
+            blob_kernel_id_axis_t id_pkt;
+            mask_stream >> mask_pkt;
+            id_stream >> id_pkt;
+            for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+                int mask = mask_pkt.tdata[i].to_int();
+                int id = id_pkt.tdata[i].to_int();
+                if (!interior(x + i, y)) {
+                    assert(mask == 0 && id == 0);
+                    continue;
+                }
+
+                monochrome_bank_window_t window;
+                fetch_window(image, x + i, y, window);
+                assert(mask == compute_blob_kernel_mask(window, 0, 0));
+                assert(id == compute_blob_kernel_id(window, 0, 0));
+                assert((id == 0) == (mask == 0));
+                assert(id == 0 || ((mask >> (id - 1)) & 1));
+            }
+
+            bool last = (y == TEST_HEIGHT - 1) &&
+                    (x + PIXELS_PER_BEAT == TEST_WIDTH);
+            assert(mask_pkt.tlast.to_int() == last);
+            assert(id_pkt.tlast.to_int() == last);
+        }
+    }
+    assert(mask_input.empty() && mask_stream.empty());
+    assert(id_input.empty() && id_stream.empty());
+
+    printf("Filter bank testbench passed.\n");
+    return 0;
+}
@@ -11,66 +11,75 @@
  * hardware. The bounding boxes of the blobs results are recombined at the
  * end and streamed back to the processor.
  *
+ * The pipeline is free-running, with no start or done handshake, so it can be
+ * fed a continuous stream of frames, such as a camera's, at full rate. Each
+ * frame is ended by tlast on its last beat, and the first stage passes exactly
+ * a frame's worth of beats to the rest of the pipeline, padding out a frame
+ * that ends early and dropping the extra beats of one that runs long. This way,
+ * a truncated or overlong DMA transfer only spoils its own frame's boxes, and
+ * every stage reads and writes whole frames, so nothing is left in the streams
+ * between them from one frame to the next.
+ *
+ * The image streams through each level PIXELS_PER_BEAT pixels at a time, with
+ * every stage handling a beat per cycle, so the pipeline's throughput scales
+ * with the width of the beats (see image.h). The image is streamed in as RGBA
+ * pixels, a luma plane, or a Bayer mosaic, depending on the input format the
+ * pipeline is built for (also see image.h). RGBA pixels are converted to the
+ * average of their channels, or to BT.601 luma when built with BT601_GRAYSCALE
+ * defined, with fixed-point weights rather than a divider (see grayscale.h).
+ *
+ * When built with STRIPE_WIDTH defined, the pipeline only processes a vertical
+ * stripe of the frame at a time, that many columns wide plus a halo on either
+ * side, and the processor sends each frame as a series of stripes and stitches
+ * their boxes together. Every line buffer is sized by the stripe rather than
+ * the frame, so the memory stays the same however wide the frames are (see
+ * image.h). The pipeline counts the stripes of each frame, so the ROI mask
+ * still applies to the frame's columns, rather than the stripe's.
+ *
+ * When built with BLOB_FILTER_BANK defined, each scale runs the LoG filter bank
+ * instead of the single blob filter, so the scale space is denser without
+ * adding levels to the pyramid, and each box's size comes from the kernel that
+ * responded most strongly (see blob_detection.h).
+ *
+ * When built with NARROW_LOG_FILTER defined, the blob filter uses 7-bit integer
+ * weights instead of the 16-bit fixed-point ones, which make the same
+ * decisions on the headlight images with a much narrower adder tree (see
+ * blob_detection.cpp).
+ *
+ * When built with ADAPTIVE_THRESHOLD defined, the monochrome threshold is not
+ * fixed, but computed from the histogram of the last frame's grayscale values,
+ * which is accumulated as the grayscale image streams through (see
+ * threshold.h).
+ *
+ * When built with BLOB_DETECTOR_STATS defined, the detector also counts the
+ * monochrome pixels and detections at each scale, and the boxes sent back, and
+ * streams the counts to the processor on a status stream after each frame,
+ * along with the frame's number and the number of beats that came in for it,
+ * so the processor can tell which frame the boxes are for, and whether it was
+ * malformed.
+ *
  * @bug No known bugs.
  **/
 
+#include "blob_detector.h"      // Our interface
 #include "monochrome.h"         // Definition of the monochrome types
-#include "blob_detection.h"     // Our interface and blob detection types
+#include "blob_detection.h"     // Definition of the blob detection types
 #include "image.h"              // Definition of image info
 #include "grayscale.h"          // Definition of grayscale info
+#include "bayer.h"              // Definition of the Bayer demosaic
 #include "downscale.h"          // Definition of downscale
+#include "roi_mask.h"           // Definition of the region of interest mask
+#include "stage_stats.h"        // Definition of the statistics modules
+#include "threshold.h"          // Definition of the adaptive threshold
 
 /*----------------------------------------------------------------------------
  * Internal Definitions
  *----------------------------------------------------------------------------*/
 
-// The type used to represent a coordinate in the image
-typedef ap_int<16> coord_t;
-
-/* The data sent back to the processor, a list of bounding boxes, (x,y) points,
- * in the image where the blobs have been detected. The list is terminated with
- * the point (-1, -1, -1, -1). */
-typedef struct bounding_box {
-
-private:
-    ap_int<64> coords;             // (x1, y1), (x2, y2) coordainte
-
-public:
-    // Default constructor
-    bounding_box() {}
-
-    // Constructor from four points
-    bounding_box(coord_t& x1, coord_t& y1, coord_t& x2, coord_t& y2) {
-    #pragma HLS INLINE
-
-        this->coords = (y2 << 48) | (x2 << 32) | (y1 << 16) | x1;
-    }
-
-    // Constructor from points a centerpoint and radius
-    bounding_box(coord_t& cx, coord_t& cy, coord_t& radius) {
-    #pragma HLS INLINE
-
-        this->coords = ((cy + radius) << 48) | ((cx + radius) << 32) |
-                ((cy - radius) << 16) | (cx - radius);
-    }
-} bbox_t;
-
-// Definition of the packet and stream types for bounding boxes
-typedef axis<bbox_t, 64> bbox_axis_t;
-typedef hls::stream<bbox_axis_t> bbox_stream_t;
-
 /* Unfortunately, there's no equivalent of a generate (compile-time) loop in
  * C++, so we manually enumerate the image sizes for each level. */
 static const int NUM_SCALES     = 5;
 
-/* The maximum number of permitted bounding boxes in the image. This is done
- * simply so that HLS can provide a timing estimate. */
-static const int MAX_BBOXES     = 100;
-
-/* To increase throughput, the image image is split into 4 sections
- * horizontally (row-wise), and this module is instantiated 4 times. */
-static const int IMAGE_SPLITS 	= 4;
-
 // Enumeration of the factors of each scale level
 static const int SCALE0         = 1;
 static const int SCALE1         = SCALE0 * DOWNSCALE_FACTOR;
@@ -85,13 +94,35 @@ static const int IMAGE_WIDTH2   = IMAGE_WIDTH / SCALE2;
 static const int IMAGE_WIDTH3   = IMAGE_WIDTH / SCALE3;
 static const int IMAGE_WIDTH4   = IMAGE_WIDTH / SCALE4;
 
+// Every level's rows must split into whole beats, down to the smallest level
+static_assert(IMAGE_WIDTH4 % PIXELS_PER_BEAT == 0,
+        "The smallest level's width must be a multiple of the beat's pixels.");
+
+/* The stripes start on the coarsest level's pixels, and their halos cover the
+ * blob filter's window there (see image.h). */
+#ifdef STRIPE_WIDTH
+static_assert(SCALE4 == STRIPE_ALIGN,
+        "The stripe alignment must be a pixel at the coarsest level.");
+static_assert(BLOB_FILTER_WIDTH / 2 <= STRIPE_FILTER_REACH,
+        "The stripes' halos must cover the blob filter's window.");
+
+// A stream of the stripe's first column in the frame, for each scale level
+typedef hls::stream<coord_t> origin_stream_t;
+#endif /* STRIPE_WIDTH */
+
 // Enumeration of the image heights at each scale level
-static const int IMAGE_HSECTION	= IMAGE_HEIGHT / IMAGE_SPLITS;
-static const int IMAGE_HEIGHT0  = IMAGE_HSECTION / SCALE0;
-static const int IMAGE_HEIGHT1  = IMAGE_HSECTION / SCALE1;
-static const int IMAGE_HEIGHT2  = IMAGE_HSECTION / SCALE2;
-static const int IMAGE_HEIGHT3  = IMAGE_HSECTION / SCALE3;
-static const int IMAGE_HEIGHT4  = IMAGE_HSECTION / SCALE4;
+static const int IMAGE_HEIGHT0  = IMAGE_HEIGHT / SCALE0;
+static const int IMAGE_HEIGHT1  = IMAGE_HEIGHT / SCALE1;
+static const int IMAGE_HEIGHT2  = IMAGE_HEIGHT / SCALE2;
+static const int IMAGE_HEIGHT3  = IMAGE_HEIGHT / SCALE3;
+static const int IMAGE_HEIGHT4  = IMAGE_HEIGHT / SCALE4;
+
+// Enumeration of the number of pixels at each scale level
+static const int SCALE_PIXELS[NUM_SCALES] = {
+    IMAGE_WIDTH0 * IMAGE_HEIGHT0, IMAGE_WIDTH1 * IMAGE_HEIGHT1,
+    IMAGE_WIDTH2 * IMAGE_HEIGHT2, IMAGE_WIDTH3 * IMAGE_HEIGHT3,
+    IMAGE_WIDTH4 * IMAGE_HEIGHT4,
+};
 
 /*----------------------------------------------------------------------------
  * Helper Functions
@@ -102,9 +133,10 @@ void duplicate_stream(hls::stream<T>& input, hls::stream<T>& output1,
         hls::stream<T>& output2) {
 #pragma HLS INLINE
 
-    // While the stream is not empty, send the next packet to both outputs
+    // While the stream is not empty, send the next beat to both outputs
     dup_row_loop: for (int row = 0; row < IMAGE_HEIGHT; row++) {
-        dup_col_loop: for (int col = 0; col < IMAGE_WIDTH; col++) {
+        dup_col_loop: for (int col = 0; col < IMAGE_WIDTH;
+                col += PIXELS_PER_BEAT) {
         #pragma HLS PIPELINE II=1
 
             const T& in_pkt = input.read();
@@ -116,25 +148,65 @@ void duplicate_stream(hls::stream<T>& input, hls::stream<T>& output1,
     return;
 }
 
+/* Merges the lists of boxes from each scale into a single list, in the order
+ * of the scales, finest first, so the list and which boxes fit in it don't
+ * depend on when each scale finds its boxes. A box is read from the first
+ * scale that has one ready each cycle, so a scale with no boxes yet never
+ * holds up the others. The finest scale's boxes are sent as they arrive, and
+ * the others' are buffered, and sent in order once every scale's list has
+ * ended. The scales' terminators are dropped, and the merged list gets its
+ * own. Only the first MAX_ELEMS boxes are sent, but the rest are still read,
+ * so every list is drained before the next frame's. */
 template <int N, int MAX_ELEMS>
 void combine_streams(bbox_stream_t (&streams)[N], bbox_stream_t& output) {
-    // Keep track of which last values were seen for each stream
-    ap_uint<1> last_seen[N] = {0};
-    ap_uint<1> last_count = 0;
+    // The boxes of every scale but the finest, until they can be sent
+    bbox_t buffered[N-1][MAX_ELEMS];
+    int num_buffered[N-1];
+    #pragma HLS ARRAY_PARTITION complete variable=num_buffered
+    buffer_reset_loop: for (int j = 0; j < N - 1; j++) {
+    #pragma HLS UNROLL
+        num_buffered[j] = 0;
+    }
+
+    // Keep track of which scales' lists have ended, and the boxes sent
+    ap_uint<N> last_seen = 0;
+    int bboxes_sent = 0;
+
+    combine_packet: while (last_seen != ap_uint<N>(-1)) {
+    #pragma HLS PIPELINE II=1
 
-    combine_packet: for (int i = 0; i < MAX_ELEMS && last_count < N; i++) {
+        bool taken = false;
         combine_streams: for (int j = 0; j < N; j++) {
         #pragma HLS UNROLL
 
-            if (!last_seen[j]) {
-                const bbox_axis_t& in_pkt = streams[i].read();
-                output.write(in_pkt);
-                last_seen[j] = in_pkt.tlast;
-                last_count += 1;
+            bbox_axis_t in_pkt;
+            if (!taken && !last_seen[j] && streams[j].read_nb(in_pkt)) {
+                taken = true;
+                if (in_pkt.tlast) {
+                    last_seen[j] = 1;
+                } else if (j == 0) {
+                    if (bboxes_sent < MAX_ELEMS) {
+                        output.write(in_pkt);
+                        bboxes_sent++;
+                    }
+                } else if (num_buffered[j-1] < MAX_ELEMS) {
+                    buffered[j-1][num_buffered[j-1]] = in_pkt.tdata;
+                    num_buffered[j-1]++;
+                }
             }
         }
     }
 
+    // Send the buffered boxes, a scale at a time, until the list is full
+    combine_buffered: for (int j = 0; j < N - 1; j++) {
+        combine_scale: for (int i = 0; i < num_buffered[j] &&
+                bboxes_sent < MAX_ELEMS; i++) {
+        #pragma HLS PIPELINE II=1
+            output.write(bbox_axis_t(buffered[j][i], 0));
+            bboxes_sent++;
+        }
+    }
+
     // Terminate the output stream with the terminator
     coord_t term_coord = -1;
     bbox_t terminator = bbox_t(term_coord, term_coord, term_coord, term_coord);
@@ -142,47 +214,252 @@ void combine_streams(bbox_stream_t (&streams)[N], bbox_stream_t& output) {
     return;
 }
 
+// Returns a beat of black pixels, in the input format
+static input_axis_t blank_beat() {
+#pragma HLS INLINE
+
+    input_axis_t pkt;
+    blank_lane_loop: for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+#if defined(LUMA_INPUT) || defined(BAYER_INPUT)
+        pkt.tdata[i] = 0;
+#else
+        pkt.tdata[i] = pixel_t(0, 0, 0, 0);
+#endif /* defined(LUMA_INPUT) || defined(BAYER_INPUT) */
+    }
+    pkt.tlast = 0;
+    pkt.tkeep = -1;
+    return pkt;
+}
+
+/* Passes exactly one frame's worth of beats from the input to the pipeline, so
+ * every stage after it can count on whole frames. The end of the input frame
+ * is found by its tlast, rather than by counting. A frame whose tlast comes
+ * early is padded out with black beats, and the beats of one that runs long
+ * are dropped up to its tlast, so a malformed frame never shifts the frames
+ * after it. With statistics, the frame's number and the number of beats that
+ * came in for it are counted. */
+static void frame_sync(input_stream_t& input, input_stream_t& output
+#ifdef BLOB_DETECTOR_STATS
+        , stats_count_stream_t& frame_counts
+#endif /* BLOB_DETECTOR_STATS */
+        ) {
+#pragma HLS INLINE
+
+    static const int FRAME_BEATS = IMAGE_WIDTH * IMAGE_HEIGHT /
+            PIXELS_PER_BEAT;
+
+    bool last_seen = false;
+    stats_count_t beats_read = 0;
+    frame_sync_loop: for (int i = 0; i < FRAME_BEATS || !last_seen; i++) {
+    #pragma HLS PIPELINE II=1
+
+        // Once the frame's tlast has been seen, pad it with black beats
+        input_axis_t pkt = blank_beat();
+        if (!last_seen) {
+            pkt = input.read();
+            last_seen = pkt.tlast;
+            beats_read++;
+        }
+
+        // Forward the frame's beats, marking its last one, and drop the rest
+        if (i < FRAME_BEATS) {
+            pkt.tlast = (i == FRAME_BEATS - 1);
+            output.write(pkt);
+        }
+    }
+
+#ifdef BLOB_DETECTOR_STATS
+    static stats_count_t frame_number = 0;
+    frame_counts.write(frame_number);
+    frame_counts.write(beats_read);
+    frame_number++;
+#endif /* BLOB_DETECTOR_STATS */
+    return;
+}
+
+#ifdef STRIPE_WIDTH
+/* Sends the first column of the stripe in the frame to each scale level, so
+ * their ROI masks line up with the frame's tiles. The processor sends a frame's
+ * stripes in order from the left, and frame_sync passes exactly one stripe per
+ * run, so the stripes are counted here, wrapping around at each frame. */
+template <int N>
+void stripe_origins(origin_stream_t (&origins)[N]) {
+#pragma HLS INLINE
+
+    static int stripe = 0;
+    coord_t x0 = stripe_origin(FRAME_WIDTH, STRIPE_WIDTH, stripe);
+    origins_loop: for (int i = 0; i < N; i++) {
+    #pragma HLS UNROLL
+        origins[i].write(x0);
+    }
+    stripe = (stripe == NUM_STRIPES - 1) ? 0 : stripe + 1;
+    return;
+}
+#endif /* STRIPE_WIDTH */
+
+/* Sends the statistics for the frame to the processor on the status stream.
+ * This is the frame's number, counting from 0 since the pipeline started, and
+ * the number of beats that came in for it, which only differs from a frame's
+ * when it was malformed. Then for each scale level, it is the number of
+ * pixels, the set monochrome pixels, and the detections, followed by the
+ * number of boxes sent, and the number dropped because there were more than
+ * MAX_BBOXES. */
+template <int N>
+void write_stats(stats_count_stream_t& frame_counts,
+        stats_count_stream_t (&mono_counts)[N],
+        stats_count_stream_t (&detection_counts)[N],
+        stats_count_stream_t& bbox_count, stats_stream_t& stats) {
+    stats.write(stats_axis_t(frame_counts.read(), 0));
+    stats.write(stats_axis_t(frame_counts.read(), 0));
+
+    stats_count_t detections = 0;
+    write_stats_loop: for (int i = 0; i < N; i++) {
+        stats_count_t scale_detections = detection_counts[i].read();
+        stats.write(stats_axis_t(SCALE_PIXELS[i], 0));
+        stats.write(stats_axis_t(mono_counts[i].read(), 0));
+        stats.write(stats_axis_t(scale_detections, 0));
+        detections += scale_detections;
+    }
+
+    stats_count_t bboxes = bbox_count.read();
+    stats.write(stats_axis_t(bboxes, 0));
+    stats.write(stats_axis_t(detections - bboxes, 1));
+    return;
+}
+
 /*----------------------------------------------------------------------------
  * Multiscale Blob Detector
  *----------------------------------------------------------------------------*/
 
+/* Converts the input image to the grayscale image, from the input format. A
+ * luma plane already is the grayscale image, so it is passed through. */
+static void input_to_grayscale(input_stream_t& input_image,
+        grayscale_stream_t& gray_image) {
+#pragma HLS INLINE
+
+#if defined(LUMA_INPUT)
+    luma_row_loop: for (int row = 0; row < IMAGE_HEIGHT; row++) {
+        luma_col_loop: for (int col = 0; col < IMAGE_WIDTH;
+                col += PIXELS_PER_BEAT) {
+        #pragma HLS PIPELINE II=1
+            gray_image.write(input_image.read());
+        }
+    }
+#elif defined(BAYER_INPUT)
+    bayer_luma<IMAGE_WIDTH, IMAGE_HEIGHT>(input_image, gray_image);
+#else
+    gray_row_loop: for (int row = 0; row < IMAGE_HEIGHT; row++) {
+        gray_col_loop: for (int col = 0; col < IMAGE_WIDTH;
+                col += PIXELS_PER_BEAT) {
+        #pragma HLS PIPELINE II=1
+            grayscale(input_image, gray_image);
+        }
+    }
+#endif /* defined(LUMA_INPUT) */
+    return;
+}
+
+/* The detections at each scale. With the filter bank, these are the IDs of the
+ * best kernels. Otherwise, they are the blob filter's detections, which are 1,
+ * the ID of the bank's first kernel, the blob filter. */
+#ifdef BLOB_FILTER_BANK
+typedef blob_kernel_id_beat_t detection_beat_t;
+typedef blob_kernel_id_axis_t detection_axis_t;
+typedef blob_kernel_id_stream_t detection_stream_t;
+#else
+typedef blob_detection_beat_t detection_beat_t;
+typedef blob_detection_axis_t detection_axis_t;
+typedef blob_detection_stream_t detection_stream_t;
+#endif /* BLOB_FILTER_BANK */
+
+// Detects the blobs in the monochrome image, with the bank or the blob filter
+template <int IMAGE_WIDTH, int IMAGE_HEIGHT>
+static void detect_blobs(monochrome_stream_t& mono_image,
+        detection_stream_t& blob_mask) {
+#pragma HLS INLINE
+
+#ifdef BLOB_FILTER_BANK
+    blob_best_kernel<IMAGE_WIDTH, IMAGE_HEIGHT>(mono_image, blob_mask);
+#else
+    blob_detection<IMAGE_WIDTH, IMAGE_HEIGHT>(mono_image, blob_mask);
+#endif /* BLOB_FILTER_BANK */
+    return;
+}
+
 template <int IMAGE_WIDTH, int IMAGE_HEIGHT>
 static void downscale_image(grayscale_stream_t& image,
         grayscale_stream_t& downscaled1, grayscale_stream_t& downscaled2) {
 #pragma HLS INLINE
 
-    // Downscale the image, and duplicate the stream
+    // Downscale the image, and duplicate the stream at the downscaled size
     grayscale_stream_t downscaled_image;
     downscale<IMAGE_WIDTH, IMAGE_HEIGHT>(image, downscaled_image);
-    duplicate_stream<grayscale_axis_t, IMAGE_WIDTH, IMAGE_HEIGHT>(
-            downscaled_image, downscaled1, downscaled2);
+    duplicate_stream<grayscale_axis_t, IMAGE_WIDTH / DOWNSCALE_FACTOR,
+            IMAGE_HEIGHT / DOWNSCALE_FACTOR>(downscaled_image, downscaled1,
+            downscaled2);
     return;
 }
 
+/* Converts the detections into bounding boxes. The boxes go out one per cycle,
+ * so a beat's detections are drained one at a time, lowest lane first, while
+ * the next beat waits. Detections are sparse, so a beat usually has at most
+ * one, and this keeps up with the mask's beat per cycle. */
 template <int IMAGE_WIDTH, int IMAGE_HEIGHT, int SCALE>
-static void blob_bounding_boxes(blob_detection_stream_t& blob_mask,
+static void blob_bounding_boxes(detection_stream_t& blob_mask,
         bbox_stream_t& blobs) {
 #pragma HLS INLINE
 
-    bbox_cy_loop: for (coord_t cy = 0; cy < IMAGE_HEIGHT; cy++) {
-        bbox_cx_loop: for (coord_t cx = 0; cx < IMAGE_WIDTH; cx++) {
-        #pragma HLS PIPELINE II=1
+    static const int ROW_BEATS = IMAGE_WIDTH / PIXELS_PER_BEAT;
+    static const int BEATS = IMAGE_HEIGHT * ROW_BEATS;
 
-            ap_int<1> detection = blob_mask.read().tdata;
-            if (detection) {
-                coord_t scaled_cx = SCALE * cx;
-                coord_t scaled_cy = SCALE * cy;
-                coord_t radius = SCALE * (BLOB_FILTER_WIDTH + 1) / 2;
-                bbox_t bbox = bbox_t(scaled_cx, scaled_cy, radius);
-                bbox_axis_t bbox_pkt = bbox_axis_t(bbox, 0);
-                blobs.write(bbox_pkt);
-            }
-            if (cy == IMAGE_HEIGHT - 1 && cx == IMAGE_WIDTH - 1) {
+    // The detections of the current beat, those not yet sent, and its position
+    detection_beat_t detections;
+    ap_uint<PIXELS_PER_BEAT> pending = 0;
+    coord_t cy = 0;
+    coord_t beat_cx = 0;
+    int beats_read = 0;
+
+    bool done = false;
+    bbox_loop: for (int i = 0; i < BEATS * PIXELS_PER_BEAT + 1 && !done; i++) {
+    #pragma HLS PIPELINE II=1
+
+        // Move on to the next beat once this one's detections are sent
+        if (pending == 0) {
+            if (beats_read == BEATS) {
                 // Write the -1 terminator to the output stream
                 coord_t term_coord = -1;
                 bbox_t terminator = bbox_t(term_coord, term_coord, term_coord, term_coord);
                 blobs.write(bbox_axis_t(terminator, 1));
+                done = true;
+                continue;
+            }
+
+            detections = blob_mask.read().tdata;
+            for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+                pending[lane] = (detections[lane] != 0);
+            }
+            cy = beats_read / ROW_BEATS;
+            beat_cx = (beats_read % ROW_BEATS) * PIXELS_PER_BEAT;
+            beats_read++;
+        }
+
+        // Send the box for the lowest lane with a detection
+        if (pending != 0) {
+            coord_t lane = 0;
+            for (int j = PIXELS_PER_BEAT - 1; j >= 0; j--) {
+                if (pending[j]) {
+                    lane = j;
+                }
             }
+            pending[lane] = 0;
+
+            coord_t scaled_cx = SCALE * (beat_cx + lane);
+            coord_t scaled_cy = SCALE * cy;
+            int kernel_size = BLOB_KERNEL_SIZES[detections[lane] - 1];
+            coord_t radius = SCALE * (kernel_size + 1) / 2;
+            bbox_t bbox = bbox_t(scaled_cx, scaled_cy, radius);
+            bbox_axis_t bbox_pkt = bbox_axis_t(bbox, 0);
+            blobs.write(bbox_pkt);
         }
     }
 
@@ -190,33 +467,118 @@ static void blob_bounding_boxes(blob_detection_stream_t& blob_mask,
 }
 
 template <int IMAGE_WIDTH, int IMAGE_HEIGHT, int SCALE>
-static void single_scale_blob_detector(grayscale_stream_t& image,
-        bbox_stream_t& blobs) {
+static void single_scale_blob_detector(const roi_skip_tiles_t skip_tiles,
+        grayscale_stream_t& image, bbox_stream_t& blobs
+#ifdef STRIPE_WIDTH
+        , origin_stream_t& origin
+#endif /* STRIPE_WIDTH */
+#ifdef ADAPTIVE_THRESHOLD
+        , threshold_stream_t& threshold
+#endif /* ADAPTIVE_THRESHOLD */
+#ifdef BLOB_DETECTOR_STATS
+        , stats_count_stream_t& mono_counts,
+        stats_count_stream_t& detection_counts
+#endif /* BLOB_DETECTOR_STATS */
+        ) {
 #pragma HLS INLINE
 
+    // Drop the pixels outside of the region of interest, placed by the stripe
+    grayscale_stream_t roi_image;
+#ifdef STRIPE_WIDTH
+    int x0 = origin.read();
+#else
+    int x0 = 0;
+#endif /* STRIPE_WIDTH */
+    roi_mask<IMAGE_WIDTH, IMAGE_HEIGHT, SCALE>(skip_tiles, x0, image,
+            roi_image);
+
     // Convert the image to monochrome, and perform blob detection
     monochrome_stream_t mono_image;
-    blob_detection_stream_t blob_mask;
-    monochrome(image, mono_image);
-    blob_detection<IMAGE_WIDTH, IMAGE_HEIGHT>(mono_image, blob_mask);
+    detection_stream_t blob_mask;
+#ifdef ADAPTIVE_THRESHOLD
+    grayscale_t level_threshold = threshold.read();
+#endif /* ADAPTIVE_THRESHOLD */
+    mono_row_loop: for (int row = 0; row < IMAGE_HEIGHT; row++) {
+        mono_col_loop: for (int col = 0; col < IMAGE_WIDTH;
+                col += PIXELS_PER_BEAT) {
+        #pragma HLS PIPELINE II=1
+#ifdef ADAPTIVE_THRESHOLD
+            monochrome(roi_image, mono_image, level_threshold);
+#else
+            monochrome(roi_image, mono_image);
+#endif /* ADAPTIVE_THRESHOLD */
+        }
+    }
+#ifdef BLOB_DETECTOR_STATS
+    // Count the set monochrome pixels and the detections on their way through
+    monochrome_stream_t counted_mono;
+    detection_stream_t uncounted_mask;
+    count_stream<monochrome_axis_t, IMAGE_WIDTH, IMAGE_HEIGHT,
+            PIXELS_PER_BEAT>(mono_image, counted_mono, mono_counts);
+    detect_blobs<IMAGE_WIDTH, IMAGE_HEIGHT>(counted_mono, uncounted_mask);
+    count_stream<detection_axis_t, IMAGE_WIDTH, IMAGE_HEIGHT,
+            PIXELS_PER_BEAT>(uncounted_mask, blob_mask, detection_counts);
+#else
+    detect_blobs<IMAGE_WIDTH, IMAGE_HEIGHT>(mono_image, blob_mask);
+#endif /* BLOB_DETECTOR_STATS */
 
     // Convert the blob detections into a stream of bounding boxes
     blob_bounding_boxes<IMAGE_WIDTH, IMAGE_HEIGHT, SCALE>(blob_mask, blobs);
     return;
 }
 
-void blob_detector(pixel_stream_t& rgba_image, bbox_stream_t& blobs) {
-#pragma HLS INTERFACE axis port=rgba_image
+void blob_detector(input_stream_t& input_image, bbox_stream_t& blobs,
+        const roi_skip_tiles_t skip_tiles
+#ifdef BLOB_DETECTOR_STATS
+        , stats_stream_t& stats
+#endif /* BLOB_DETECTOR_STATS */
+        ) {
+#pragma HLS INTERFACE axis port=input_image
 #pragma HLS INTERFACE axis port=blobs
+#pragma HLS INTERFACE s_axilite port=skip_tiles
+#ifdef BLOB_DETECTOR_STATS
+#pragma HLS INTERFACE axis port=stats
+#endif /* BLOB_DETECTOR_STATS */
 #pragma HLS INTERFACE ap_ctrl_none port=return
 
 #pragma HLS DATAFLOW
 
+    // Take exactly one frame from the input, resynchronizing on its tlast
+    input_stream_t frame_image;
+#ifdef BLOB_DETECTOR_STATS
+    stats_count_stream_t frame_counts;
+    frame_sync(input_image, frame_image, frame_counts);
+#else
+    frame_sync(input_image, frame_image);
+#endif /* BLOB_DETECTOR_STATS */
+
+#ifdef STRIPE_WIDTH
+    // Tell each scale level where the stripe is in the frame
+    origin_stream_t origins[NUM_SCALES];
+    #pragma HLS ARRAY_PARTITION complete variable=origins
+    stripe_origins<NUM_SCALES>(origins);
+#define SCALE_ORIGIN(i)     , origins[i]
+#else
+#define SCALE_ORIGIN(i)
+#endif /* STRIPE_WIDTH */
+
     // Convert the image to grayscale, and duplicate the stream
     grayscale_stream_t gray_image, images1[NUM_SCALES], images2[NUM_SCALES-1];
     #pragma HLS ARRAY_PARTITION complete variable=images1
     #pragma HLS ARRAY_PARTITION complete variable=images2
-    grayscale(rgba_image, gray_image);
+#ifdef ADAPTIVE_THRESHOLD
+    // Measure the histogram of the frame for the next one's threshold
+    grayscale_stream_t measured_image;
+    threshold_stream_t thresholds[NUM_SCALES];
+    #pragma HLS ARRAY_PARTITION complete variable=thresholds
+    input_to_grayscale(frame_image, measured_image);
+    adaptive_threshold<IMAGE_WIDTH, IMAGE_HEIGHT, NUM_SCALES>(measured_image,
+            gray_image, thresholds);
+#define SCALE_THRESHOLD(i)  , thresholds[i]
+#else
+    input_to_grayscale(frame_image, gray_image);
+#define SCALE_THRESHOLD(i)
+#endif /* ADAPTIVE_THRESHOLD */
     duplicate_stream<grayscale_axis_t, IMAGE_WIDTH, IMAGE_HEIGHT>(gray_image,
             images1[0], images2[0]);
 
@@ -232,18 +594,44 @@ void blob_detector(pixel_stream_t& rgba_image, bbox_stream_t& blobs) {
     // Run blob detection on each of the 5 scale levels
     bbox_stream_t scale_blobs[NUM_SCALES];
     #pragma HLS ARRAY_PARTITION complete variable=scale_blobs
-    single_scale_blob_detector<IMAGE_WIDTH0, IMAGE_HEIGHT0, SCALE0>(images1[0],
-            scale_blobs[0]);
-    single_scale_blob_detector<IMAGE_WIDTH1, IMAGE_HEIGHT1, SCALE1>(images1[1],
-            scale_blobs[1]);
-    single_scale_blob_detector<IMAGE_WIDTH2, IMAGE_HEIGHT2, SCALE2>(images1[2],
-            scale_blobs[2]);
-    single_scale_blob_detector<IMAGE_WIDTH3,IMAGE_HEIGHT3, SCALE3>(images1[3],
-            scale_blobs[3]);
-    single_scale_blob_detector<IMAGE_WIDTH4, IMAGE_HEIGHT4, SCALE4>(images1[4],
-            scale_blobs[4]);
+#ifdef BLOB_DETECTOR_STATS
+    stats_count_stream_t mono_counts[NUM_SCALES];
+    stats_count_stream_t detection_counts[NUM_SCALES];
+    #pragma HLS ARRAY_PARTITION complete variable=mono_counts
+    #pragma HLS ARRAY_PARTITION complete variable=detection_counts
+#define SCALE_STATS(i)  , mono_counts[i], detection_counts[i]
+#else
+#define SCALE_STATS(i)
+#endif /* BLOB_DETECTOR_STATS */
+    single_scale_blob_detector<IMAGE_WIDTH0, IMAGE_HEIGHT0, SCALE0>(skip_tiles,
+            images1[0], scale_blobs[0] SCALE_ORIGIN(0)
+            SCALE_THRESHOLD(0) SCALE_STATS(0));
+    single_scale_blob_detector<IMAGE_WIDTH1, IMAGE_HEIGHT1, SCALE1>(skip_tiles,
+            images1[1], scale_blobs[1] SCALE_ORIGIN(1)
+            SCALE_THRESHOLD(1) SCALE_STATS(1));
+    single_scale_blob_detector<IMAGE_WIDTH2, IMAGE_HEIGHT2, SCALE2>(skip_tiles,
+            images1[2], scale_blobs[2] SCALE_ORIGIN(2)
+            SCALE_THRESHOLD(2) SCALE_STATS(2));
+    single_scale_blob_detector<IMAGE_WIDTH3, IMAGE_HEIGHT3, SCALE3>(skip_tiles,
+            images1[3], scale_blobs[3] SCALE_ORIGIN(3)
+            SCALE_THRESHOLD(3) SCALE_STATS(3));
+    single_scale_blob_detector<IMAGE_WIDTH4, IMAGE_HEIGHT4, SCALE4>(skip_tiles,
+            images1[4], scale_blobs[4] SCALE_ORIGIN(4)
+            SCALE_THRESHOLD(4) SCALE_STATS(4));
+#undef SCALE_ORIGIN
+#undef SCALE_THRESHOLD
+#undef SCALE_STATS
 
     // Combine the 5 streams of blob bounding boxes into a single stream
+#ifdef BLOB_DETECTOR_STATS
+    bbox_stream_t combined_blobs;
+    stats_count_stream_t bbox_count;
+    combine_streams<NUM_SCALES, MAX_BBOXES>(scale_blobs, combined_blobs);
+    count_list<bbox_axis_t, MAX_BBOXES>(combined_blobs, blobs, bbox_count);
+    write_stats<NUM_SCALES>(frame_counts, mono_counts, detection_counts,
+            bbox_count, stats);
+#else
     combine_streams<NUM_SCALES, MAX_BBOXES>(scale_blobs, blobs);
+#endif /* BLOB_DETECTOR_STATS */
     return;
 }
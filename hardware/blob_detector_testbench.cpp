@@ -0,0 +1,176 @@
+/**
+ * @file blob_detector_testbench.cpp
+ * @date Saturday, October 31, 2026 at 02:58:41 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the testbench for the top-level blob detector pipeline.
+ *
+ * The testbench streams a series of frames through the whole pipeline, like a
+ * camera would, including frames that end early and frames that run long, and
+ * checks that each frame's list of boxes is unaffected by the malformed frames
+ * before it. The frames must be at least 64x64, so the smallest level is a few
+ * pixels across, e.g.:
+ *      g++ -DSIM_IMAGE_WIDTH=64 -DSIM_IMAGE_HEIGHT=64 -Isim -Iinclude \
+ *          -I../src blob_detector_testbench.cpp blob_detector.cpp \
+ *          preprocess/grayscale.cpp preprocess/monochrome.cpp \
+ *          preprocess/downscale.cpp preprocess/threshold.cpp \
+ *          blob_detection/blob_detection.cpp -o blob_detector_testbench
+ *
+ * @bug No known bugs.
+ **/
+
+#include <assert.h>                 // Assert macro
+#include <stdio.h>                  // Printf function
+
+#include <vector>                   // Vector container
+
+#include "image.h"                  // Definition of the image size
+#include "blob_detector.h"          // Blob detector interface
+
+// The number of beats in a frame, and in a row of it
+static const int ROW_BEATS = IMAGE_WIDTH / PIXELS_PER_BEAT;
+static const int FRAME_BEATS = ROW_BEATS * IMAGE_HEIGHT;
+
+// The bright squares drawn in the test frame, in the top half of it
+static const int BLOB_X = 20;
+static const int BLOB_Y = 20;
+static const int BLOB_SIZE = 3;
+static const int LARGE_BLOB_X = 40;
+static const int LARGE_BLOB_Y = 4;
+static const int LARGE_BLOB_SIZE = 8;
+
+// The number of records sent on the status stream for each frame
+static const int NUM_STATS = 2 + 3 * 5 + 2;
+
+static_assert(IMAGE_WIDTH >= 64 && IMAGE_HEIGHT >= 64,
+        "The testbench's frames must be at least 64x64.");
+
+// Returns true if the pixel is in the square
+static bool in_square(int x, int y, int x0, int y0, int size)
+{
+    return x >= x0 && x < x0 + size && y >= y0 && y < y0 + size;
+}
+
+/* Returns a beat of the test frame, a small and a large bright square on a
+ * black background, which are found at different scales. */
+static input_axis_t frame_beat(int beat)
+{
+    input_axis_t pkt;
+    for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+        int x = (beat % ROW_BEATS) * PIXELS_PER_BEAT + lane;
+        int y = beat / ROW_BEATS;
+        bool in_blob = in_square(x, y, BLOB_X, BLOB_Y, BLOB_SIZE) ||
+                in_square(x, y, LARGE_BLOB_X, LARGE_BLOB_Y, LARGE_BLOB_SIZE);
+        int value = in_blob ? 255 : 0;
+#if defined(LUMA_INPUT) || defined(BAYER_INPUT)
+        pkt.tdata[lane] = value;
+#else
+        pkt.tdata[lane] = pixel_t(value, value, value, 255);
+#endif /* defined(LUMA_INPUT) || defined(BAYER_INPUT) */
+    }
+    pkt.tkeep = -1;
+    pkt.tlast = 0;
+    return pkt;
+}
+
+/* Streams the first num_beats of the test frame through the pipeline, with
+ * tlast on the last one. Beats past the frame's end are a bright garbage. The
+ * frame's boxes are returned, with the terminator's checked and dropped. */
+static std::vector<bbox_t> run_frame(int num_beats, int frame_number)
+{
+    static const roi_skip_tiles_t skip_tiles = {0};
+
+    input_stream_t input;
+    bbox_stream_t blobs;
+    for (int i = 0; i < num_beats; i++) {
+        input_axis_t pkt = frame_beat(i % FRAME_BEATS);
+        pkt.tlast = (i == num_beats - 1);
+        input.write(pkt);
+    }
+
+#ifdef BLOB_DETECTOR_STATS
+    stats_stream_t stats;
+    blob_detector(input, blobs, skip_tiles, stats);
+#else
+    blob_detector(input, blobs, skip_tiles);
+    (void)frame_number;
+#endif /* BLOB_DETECTOR_STATS */
+    assert(input.empty());
+
+    // Only the terminator has tlast set, and nothing follows it
+    std::vector<bbox_t> bboxes;
+    bbox_axis_t pkt = blobs.read();
+    while (!pkt.tlast) {
+        bboxes.push_back(pkt.tdata);
+        pkt = blobs.read();
+    }
+    assert(pkt.tdata.x1() == -1 && pkt.tdata.y1() == -1);
+    assert(pkt.tdata.x2() == -1 && pkt.tdata.y2() == -1);
+    assert(blobs.empty());
+
+#ifdef BLOB_DETECTOR_STATS
+    // The frame's number and beats come first, and the boxes sent last but one
+    std::vector<int> records;
+    for (int i = 0; i < NUM_STATS; i++) {
+        stats_axis_t record = stats.read();
+        assert(record.tlast.to_int() == (i == NUM_STATS - 1));
+        records.push_back(record.tdata.to_int());
+    }
+    assert(stats.empty());
+    assert(records[0] == frame_number && records[1] == num_beats);
+    assert(records[2] == IMAGE_WIDTH * IMAGE_HEIGHT);
+    assert(records[NUM_STATS - 2] == (int)bboxes.size());
+    assert(records[NUM_STATS - 1] == 0);
+#endif /* BLOB_DETECTOR_STATS */
+    return bboxes;
+}
+
+// Checks that the two lists have the same boxes, in the same order
+static void check_bboxes(const std::vector<bbox_t>& bboxes,
+        const std::vector<bbox_t>& expected)
+{
+    assert(bboxes.size() == expected.size());
+    for (size_t i = 0; i < bboxes.size(); i++) {
+        assert(bboxes[i].x1() == expected[i].x1());
+        assert(bboxes[i].y1() == expected[i].y1());
+        assert(bboxes[i].x2() == expected[i].x2());
+        assert(bboxes[i].y2() == expected[i].y2());
+    }
+}
+
+int main()
+{
+    // The small square is found, with a box centered on it at the finest level
+    std::vector<bbox_t> expected = run_frame(FRAME_BEATS, 0);
+    bool found = false;
+    for (size_t i = 0; i < expected.size(); i++) {
+        const bbox_t& bbox = expected[i];
+        found |= (bbox.x1() + bbox.x2() == 2 * BLOB_X + BLOB_SIZE - 1 &&
+                bbox.y1() + bbox.y2() == 2 * BLOB_Y + BLOB_SIZE - 1);
+    }
+    assert(found);
+
+    /* The boxes are in the order of the scales, and the box sizes grow with
+     * the scale, unless the filter bank sizes them by its kernels. The large
+     * square is only found at a coarser scale, after the small one. */
+#ifndef BLOB_FILTER_BANK
+    assert(expected.size() >= 2);
+    for (size_t i = 1; i < expected.size(); i++) {
+        assert(expected[i].x2() - expected[i].x1() >=
+                expected[i-1].x2() - expected[i-1].x1());
+    }
+#endif /* BLOB_FILTER_BANK */
+
+    /* A frame cut off below the square is padded out with black, which it
+     * already was, and one that runs long has its extra beats dropped. */
+    check_bboxes(run_frame(FRAME_BEATS / 2, 1), expected);
+    check_bboxes(run_frame(FRAME_BEATS + 3 * ROW_BEATS + 1, 2), expected);
+
+    // The frames after the malformed ones are still aligned
+    check_bboxes(run_frame(FRAME_BEATS, 3), expected);
+    check_bboxes(run_frame(1, 4), std::vector<bbox_t>());
+    check_bboxes(run_frame(FRAME_BEATS, 5), expected);
+
+    printf("Blob detector testbench passed.\n");
+    return 0;
+}
@@ -37,4 +37,22 @@ struct axis {
     }
 };
 
+/* Template to define a beat of a wide stream, which carries N values of type T
+ * side by side in a single packet. The values are consecutive pixels of a row
+ * of the image, with the leftmost one in lane 0, which is also the lowest
+ * address in memory. A wide stream moves N pixels per clock cycle, so a stage
+ * that handles a beat per cycle has N times the throughput. */
+template <typename T, int N>
+struct beat {
+    T lanes[N];                             // The values in each lane
+
+    // Accessors for the value in a lane
+    T& operator[](int lane) {
+        return lanes[lane];
+    }
+    const T& operator[](int lane) const {
+        return lanes[lane];
+    }
+};
+
 #endif /* AXIS_H_ */
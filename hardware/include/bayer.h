@@ -0,0 +1,170 @@
+/**
+ * @file bayer.h
+ * @date Monday, October 26, 2026 at 10:18:44 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the Bayer demosaic module.
+ *
+ * This defines the Bayer module interface, as both a sequential and
+ * combinational interface. The module converts the raw mosaic from a sensor
+ * directly into luma, so the grayscale image is computed without ever
+ * producing the RGB image.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef BAYER_H_
+#define BAYER_H_
+
+#include "grayscale.h"              // Definition of the grayscale types
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The parity of the sum of the coordinates of the green samples in the mosaic.
+ * Only the position of the green samples matters for luma, so this is 1 for an
+ * RGGB or BGGR mosaic, which is the default, and 0 for a GRBG or GBRG mosaic,
+ * which is selected by defining BAYER_GREEN_FIRST on the command line.
+ **/
+#ifdef BAYER_GREEN_FIRST
+static const int BAYER_GREEN_PARITY = 0;
+#else
+static const int BAYER_GREEN_PARITY = 1;
+#endif /* BAYER_GREEN_FIRST */
+
+/**
+ * The size of the block of samples that each luma value is computed from, and
+ * a convenient alias for the block.
+ **/
+static const int BAYER_BLOCK_SIZE = 2;
+typedef grayscale_t bayer_block_t[BAYER_BLOCK_SIZE][BAYER_BLOCK_SIZE];
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Computes the luma of a 2x2 block of samples of the mosaic.
+ *
+ * Any 2x2 block holds a red, a blue, and two green samples, with the greens on
+ * one of its diagonals. The luma is the weighted sum of the three colors, with
+ * the mean of the greens, the same as the grayscale of an RGBA pixel. The
+ * block doesn't say which of the other two samples is red, so they are both
+ * weighted by the mean of the red and blue weights, which only differs from
+ * the RGBA grayscale with the BT.601 weights. This is the combinational
+ * interface to the module.
+ *
+ * @param[in] block The block of samples.
+ * @param greens_on_diagonal True if the green samples are on the diagonal
+ *        from the top-left to the bottom-right of the block.
+ * @return The 8-bit luma value of the block.
+ **/
+grayscale_t compute_bayer_luma(bayer_block_t block, bool greens_on_diagonal);
+
+/**
+ * Demosaics the Bayer image represented by the input stream into the luma
+ * image represented by the output stream.
+ *
+ * The luma of each pixel is computed from the block of samples to the right of
+ * it and below it. The last column and row use the block to their left or above
+ * them instead, which is the same block as the pixel before them, so they copy
+ * its value. This is the sequential interface to the module.
+ *
+ * The stream is read a beat per cycle. The two rows before the one streaming
+ * in are held in line buffers, and each beat of output comes from the older of
+ * the two, so that both rows of its blocks are complete, including the next
+ * beat's first samples. Each beat of input replaces the beat of the older row
+ * that was just used. The output lags the input by two rows, which are drained
+ * after the last row has come in.
+ *
+ * @tparam IMAGE_WIDTH The width of the image being demosaiced.
+ * @tparam IMAGE_HEIGHT The height of the image being demosaiced.
+ *
+ * @param[in] mosaic_stream The input stream of Bayer samples.
+ * @param[out] luma_stream The output stream of luma values.
+ **/
+template <int IMAGE_WIDTH, int IMAGE_HEIGHT>
+void bayer_luma(luma_stream_t& mosaic_stream,
+        grayscale_stream_t& luma_stream) {
+#pragma HLS INLINE
+
+    // The number of beats in a row
+    static const int ROW_BEATS = IMAGE_WIDTH / PIXELS_PER_BEAT;
+    static_assert(IMAGE_WIDTH % PIXELS_PER_BEAT == 0,
+            "The width must be a multiple of the pixels per beat.");
+    static_assert(IMAGE_WIDTH >= BAYER_BLOCK_SIZE &&
+            IMAGE_HEIGHT >= BAYER_BLOCK_SIZE,
+            "The image must be at least as large as a block of samples.");
+
+    // The last two rows of the mosaic, indexed by the parity of the row
+    grayscale_beat_t line_buffer[BAYER_BLOCK_SIZE][ROW_BEATS];
+    #pragma HLS ARRAY_PARTITION variable=line_buffer complete dim=1
+
+    // The luma value of the last pixel output, which the last column copies
+    grayscale_t last_luma = 0;
+
+    bayer_row_loop: for (int row = 0; row < IMAGE_HEIGHT + 2; row++) {
+        // The output row, and the top row of its blocks
+        int y = row - 2;
+        int top = (y < IMAGE_HEIGHT - 1) ? y : IMAGE_HEIGHT - 2;
+        bayer_col_loop: for (int col = 0; col < ROW_BEATS; col++) {
+        #pragma HLS PIPELINE II=1
+
+            if (y >= 0) {
+                // Collect the samples of the beat, and the first of the next
+                grayscale_t samples[BAYER_BLOCK_SIZE][PIXELS_PER_BEAT+1];
+                #pragma HLS ARRAY_PARTITION variable=samples complete dim=0
+                for (int j = 0; j < BAYER_BLOCK_SIZE; j++) {
+                    const grayscale_beat_t *buffer_row =
+                            line_buffer[(top + j) % BAYER_BLOCK_SIZE];
+                    for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+                        samples[j][i] = buffer_row[col][i];
+                    }
+                    samples[j][PIXELS_PER_BEAT] = (col < ROW_BEATS - 1) ?
+                            buffer_row[col+1][0] : grayscale_t(0);
+                }
+
+                // Compute the luma of each lane's block
+                grayscale_axis_t luma_stream_pkt;
+                bayer_lane_loop: for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+                #pragma HLS UNROLL
+                    int x = col * PIXELS_PER_BEAT + i;
+                    if (x == IMAGE_WIDTH - 1) {
+                        luma_stream_pkt.tdata[i] = last_luma;
+                        continue;
+                    }
+
+                    bayer_block_t block;
+                    for (int j = 0; j < BAYER_BLOCK_SIZE; j++) {
+                        for (int k = 0; k < BAYER_BLOCK_SIZE; k++) {
+                            block[j][k] = samples[j][i+k];
+                        }
+                    }
+                    bool greens_on_diagonal = (x + top) % 2 ==
+                            BAYER_GREEN_PARITY;
+                    last_luma = compute_bayer_luma(block, greens_on_diagonal);
+                    luma_stream_pkt.tdata[i] = last_luma;
+                }
+
+                /* Our transfers are always aligned, so set tkeep to -1, and
+                 * assert tlast when we reach the last packet. */
+                luma_stream_pkt.tkeep = -1;
+                luma_stream_pkt.tlast = (y == IMAGE_HEIGHT - 1) &&
+                        (col == ROW_BEATS - 1);
+                luma_stream.write(luma_stream_pkt);
+            }
+
+            // Replace the beat that was just used with the incoming row's
+            if (row < IMAGE_HEIGHT) {
+                line_buffer[row % BAYER_BLOCK_SIZE][col] =
+                        mosaic_stream.read().tdata;
+            }
+        }
+    }
+
+    return;
+}
+
+#endif /* BAYER_H_ */
@@ -43,13 +43,52 @@ typedef monochrome_t monochrome_window_t[BLOB_FILTER_HEIGHT][BLOB_FILTER_WIDTH];
 
 /**
  * The input stream type is a monochrome AXIS packet. The output stream type is
- * a 1-bit boolean value AXIS packet. This boolean indicates if the pixel
- * corresponds to the centerpoint of a blob detection.
+ * an AXIS packet of a beat of 1-bit boolean values. Each boolean indicates if
+ * the pixel corresponds to the centerpoint of a blob detection.
  **/
 typedef ap_uint<1> blob_detection_t;
-typedef axis<blob_detection_t, 1> blob_detection_axis_t;
+typedef beat<blob_detection_t, PIXELS_PER_BEAT> blob_detection_beat_t;
+typedef axis<blob_detection_beat_t, PIXELS_PER_BEAT> blob_detection_axis_t;
 typedef hls::stream<blob_detection_axis_t> blob_detection_stream_t;
 
+/**
+ * The filter bank evaluates several LoG kernels of increasing size on the same
+ * window, which is the size of the largest kernel. Kernel 0 is the blob filter
+ * above, and each kernel is tuned for blobs larger than the one before it.
+ **/
+static const int NUM_BLOB_KERNELS = 3;
+static const int BLOB_KERNEL_SIZES[NUM_BLOB_KERNELS] = {5, 7, 9};
+static const int BLOB_BANK_WIDTH = 9;
+static const int BLOB_BANK_HEIGHT = BLOB_BANK_WIDTH;
+
+/**
+ * A convenient alias for the window of monochrome values matching the size of
+ * the filter bank's largest kernel.
+ **/
+typedef monochrome_t
+        monochrome_bank_window_t[BLOB_BANK_HEIGHT][BLOB_BANK_WIDTH];
+
+/**
+ * The filter bank outputs either a mask or a kernel ID for each pixel. Bit k
+ * of the mask is set if kernel k detected a blob centered on the pixel. The ID
+ * is 0 if no kernel detected a blob, and k+1 if kernel k had the strongest
+ * response of the kernels that did, so a nonzero ID is also a detection.
+ **/
+typedef ap_uint<NUM_BLOB_KERNELS> blob_kernel_mask_t;
+typedef beat<blob_kernel_mask_t, PIXELS_PER_BEAT> blob_kernel_mask_beat_t;
+typedef axis<blob_kernel_mask_beat_t, NUM_BLOB_KERNELS * PIXELS_PER_BEAT>
+        blob_kernel_mask_axis_t;
+typedef hls::stream<blob_kernel_mask_axis_t> blob_kernel_mask_stream_t;
+
+static const int BLOB_KERNEL_ID_BITS = 2;
+static_assert(NUM_BLOB_KERNELS < (1 << BLOB_KERNEL_ID_BITS),
+        "The kernel ID must be wide enough for every kernel and for none.");
+typedef ap_uint<BLOB_KERNEL_ID_BITS> blob_kernel_id_t;
+typedef beat<blob_kernel_id_t, PIXELS_PER_BEAT> blob_kernel_id_beat_t;
+typedef axis<blob_kernel_id_beat_t, BLOB_KERNEL_ID_BITS * PIXELS_PER_BEAT>
+        blob_kernel_id_axis_t;
+typedef hls::stream<blob_kernel_id_axis_t> blob_kernel_id_stream_t;
+
 /*----------------------------------------------------------------------------
  * Interface
  *----------------------------------------------------------------------------*/
@@ -62,6 +101,10 @@ typedef hls::stream<blob_detection_axis_t> blob_detection_stream_t;
  * to a blob. This is the combinational interface to the module.
  *
  * @param[in] window A window of monochrome values from an image.
+ * @param start_row The row of the window's top-left corner in the buffer,
+ *                  whose rows wrap around (see windowfetch.h).
+ * @param start_col The column of the window's top-left corner in the buffer,
+ *                  whose columns wrap around.
  * @return 1 if the window corresponds to a blob, 0 otherwise.
  **/
 blob_detection_t compute_blob_detection(monochrome_window_t window,
@@ -86,14 +129,109 @@ void blob_detection(monochrome_stream_t& monochrome_stream,
         blob_detection_stream_t& blob_detection_stream) {
 #pragma HLS INLINE
 
-    // Declare a window object
+    // Declare a window object, with a window for each pixel of a beat
     window_pipeline<monochrome_t, blob_detection_t, 1, 1, IMAGE_HEIGHT,
             IMAGE_WIDTH, BLOB_FILTER_HEIGHT, BLOB_FILTER_WIDTH,
-            compute_blob_detection> w;
+            compute_blob_detection, PIXELS_PER_BEAT> w;
 
     // Apply the LoG operation
     w.window_op(monochrome_stream, blob_detection_stream);
     return;
 }
 
+/**
+ * Decides which of the filter bank's kernels detect a blob in the given
+ * window in the image.
+ *
+ * Each kernel is applied to the part of the window centered on the window's
+ * center, and its response thresholded the same way as the blob filter's. This
+ * is the combinational interface to the filter bank.
+ *
+ * @param[in] window A window of monochrome values from an image.
+ * @param start_row The row of the window's top-left corner in the buffer,
+ *                  whose rows wrap around (see windowfetch.h).
+ * @param start_col The column of the window's top-left corner in the buffer,
+ *                  whose columns wrap around.
+ * @return The mask of the kernels that detected a blob.
+ **/
+blob_kernel_mask_t compute_blob_kernel_mask(monochrome_bank_window_t window,
+        int start_row, int start_col);
+
+/**
+ * Decides which of the filter bank's kernels responds the most strongly to
+ * a blob in the given window in the image.
+ *
+ * This is the combinational interface to the filter bank.
+ *
+ * @param[in] window A window of monochrome values from an image.
+ * @param start_row The row of the window's top-left corner in the buffer,
+ *                  whose rows wrap around (see windowfetch.h).
+ * @param start_col The column of the window's top-left corner in the buffer,
+ *                  whose columns wrap around.
+ * @return The ID of the kernel with the strongest detection, or 0 if none of
+ *         them detected a blob.
+ **/
+blob_kernel_id_t compute_blob_kernel_id(monochrome_bank_window_t window,
+        int start_row, int start_col);
+
+/**
+ * Converts the monochrome input stream into a stream of the masks of the
+ * filter bank's kernels that detect a blob at each pixel.
+ *
+ * All the kernels are evaluated in one pass over the image, on the same
+ * window, so the bank needs the line buffers of its largest kernel, rather
+ * than those of every kernel. No kernel detects a blob within half of the
+ * largest kernel of the edge of the image, even if it is smaller. This is the
+ * sequential interface to the filter bank.
+ *
+ * @tparam IMAGE_WIDTH The width of the image being processed.
+ * @tparam IMAGE_HEIGHT The height of the image being processed.
+ *
+ * @param[in] monochrome_stream The input stream of monochrome values.
+ * @param[out] kernel_mask_stream The output stream of kernel masks.
+ **/
+template <int IMAGE_WIDTH, int IMAGE_HEIGHT>
+void blob_filter_bank(monochrome_stream_t& monochrome_stream,
+        blob_kernel_mask_stream_t& kernel_mask_stream) {
+#pragma HLS INLINE
+
+    // Declare a window object, with a window for each pixel of a beat
+    window_pipeline<monochrome_t, blob_kernel_mask_t, 1, NUM_BLOB_KERNELS,
+            IMAGE_HEIGHT, IMAGE_WIDTH, BLOB_BANK_HEIGHT, BLOB_BANK_WIDTH,
+            compute_blob_kernel_mask, PIXELS_PER_BEAT> w;
+
+    // Apply every kernel in the bank
+    w.window_op(monochrome_stream, kernel_mask_stream);
+    return;
+}
+
+/**
+ * Converts the monochrome input stream into a stream of the IDs of the filter
+ * bank's kernels with the strongest detection at each pixel.
+ *
+ * This is the same as the mask interface, except that it only keeps the best
+ * kernel, whose size gives the size of the blob. This is the sequential
+ * interface to the filter bank.
+ *
+ * @tparam IMAGE_WIDTH The width of the image being processed.
+ * @tparam IMAGE_HEIGHT The height of the image being processed.
+ *
+ * @param[in] monochrome_stream The input stream of monochrome values.
+ * @param[out] kernel_id_stream The output stream of kernel IDs.
+ **/
+template <int IMAGE_WIDTH, int IMAGE_HEIGHT>
+void blob_best_kernel(monochrome_stream_t& monochrome_stream,
+        blob_kernel_id_stream_t& kernel_id_stream) {
+#pragma HLS INLINE
+
+    // Declare a window object, with a window for each pixel of a beat
+    window_pipeline<monochrome_t, blob_kernel_id_t, 1, BLOB_KERNEL_ID_BITS,
+            IMAGE_HEIGHT, IMAGE_WIDTH, BLOB_BANK_HEIGHT, BLOB_BANK_WIDTH,
+            compute_blob_kernel_id, PIXELS_PER_BEAT> w;
+
+    // Apply every kernel in the bank, keeping the strongest
+    w.window_op(monochrome_stream, kernel_id_stream);
+    return;
+}
+
 #endif /* BLOB_DETECTION_H_ */
@@ -0,0 +1,123 @@
+/**
+ * @file blob_detector.h
+ * @date Saturday, October 31, 2026 at 10:26:13 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the top-level blob detector pipeline.
+ *
+ * This defines the bounding boxes the pipeline sends back to the processor,
+ * and the top-level function that HLS synthesizes, so that the whole pipeline
+ * can be driven by a testbench.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef BLOB_DETECTOR_H_
+#define BLOB_DETECTOR_H_
+
+#include <hls_stream.h>             // Definition of the hls::stream class
+#include <ap_int.h>                 // Arbitrary precision integer types
+
+#include "axis.h"                   // Definition of the AXIS protocol structure
+#include "grayscale.h"              // Definition of the input stream type
+#include "roi_mask.h"               // Definition of the region of interest
+#include "stage_stats.h"            // Definition of the status stream type
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+// The type used to represent a coordinate in the image
+typedef ap_int<16> coord_t;
+
+/* The data sent back to the processor, a list of bounding boxes, (x,y) points,
+ * in the image where the blobs have been detected. The list is terminated with
+ * the point (-1, -1, -1, -1). Each coordinate is a 16-bit field of the 64-bit
+ * word, with x1 in the lowest one. */
+typedef struct bounding_box {
+
+private:
+    ap_int<64> coords;             // (x1, y1), (x2, y2) coordainte
+
+public:
+    // Default constructor
+    bounding_box() {}
+
+    // Constructor from four points
+    bounding_box(const coord_t& x1, const coord_t& y1, const coord_t& x2,
+            const coord_t& y2) {
+    #pragma HLS INLINE
+
+        this->coords.range(15, 0) = x1;
+        this->coords.range(31, 16) = y1;
+        this->coords.range(47, 32) = x2;
+        this->coords.range(63, 48) = y2;
+    }
+
+    // Constructor from points a centerpoint and radius
+    bounding_box(const coord_t& cx, const coord_t& cy, const coord_t& radius) {
+    #pragma HLS INLINE
+
+        this->coords.range(15, 0) = cx - radius;
+        this->coords.range(31, 16) = cy - radius;
+        this->coords.range(47, 32) = cx + radius;
+        this->coords.range(63, 48) = cy + radius;
+    }
+
+    // Accessors for each of the coordinates
+    coord_t x1() const {
+        return this->coords.range(15, 0);
+    }
+    coord_t y1() const {
+        return this->coords.range(31, 16);
+    }
+    coord_t x2() const {
+        return this->coords.range(47, 32);
+    }
+    coord_t y2() const {
+        return this->coords.range(63, 48);
+    }
+} bbox_t;
+
+// Definition of the packet and stream types for bounding boxes
+typedef axis<bbox_t, 64> bbox_axis_t;
+typedef hls::stream<bbox_axis_t> bbox_stream_t;
+
+/**
+ * The maximum number of bounding boxes sent back for a frame, not counting the
+ * terminator. This matches the processor's buffer for the list, and any boxes
+ * past it are dropped.
+ **/
+static const int MAX_BBOXES     = 1023;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Runs the multi-scale blob detector on a continuous stream of frames.
+ *
+ * Each call handles one frame, and in hardware the pipeline runs frame after
+ * frame without being restarted. The input's tlast marks the end of each
+ * frame, and a frame cut short or running long is padded out or truncated to
+ * the frame size, so the frames after it stay aligned.
+ *
+ * @param[in] input_image The input stream of frames, with tlast on the last
+ *                        beat of each.
+ * @param[out] blobs The stream of each frame's bounding boxes, terminated by
+ *                   the (-1, -1, -1, -1) box with tlast set. The boxes are in
+ *                   the order of the scales, finest first, and in row-major
+ *                   order within each scale.
+ * @param[in] skip_tiles The tiles outside of the region of interest, set by
+ *                       the processor over the AXI-Lite bus at startup.
+ * @param[out] stats The status stream with each frame's statistics, when built
+ *                   with BLOB_DETECTOR_STATS defined.
+ **/
+void blob_detector(input_stream_t& input_image, bbox_stream_t& blobs,
+        const roi_skip_tiles_t skip_tiles
+#ifdef BLOB_DETECTOR_STATS
+        , stats_stream_t& stats
+#endif /* BLOB_DETECTOR_STATS */
+        );
+
+#endif /* BLOB_DETECTOR_H_ */
@@ -15,17 +15,12 @@
 #define DOWNSCALE_H_
 
 #include "grayscale.h"              // Definition of the grayscale types
+#include "preprocess_params.h"      // The downscale factor, shared with src
 
 /*----------------------------------------------------------------------------
  * Definitions
  *----------------------------------------------------------------------------*/
 
-/**
- * The amount that the image is scaled down by at each scale level, in each
- * dimension. For example, a WxH would become(W/FACTOR)x(H/FACTOR) image.
- **/
-static const int DOWNSCALE_FACTOR = 2;
-
 /**
  * A convenient alias for the window of grayscale values matching the size of
  * the image window being down-sized.
@@ -58,62 +53,88 @@ grayscale_t compute_downscale(grayscale_window_t window);
  * windows) to determine the resultant value in the output image. This is the
  * sequential interface to the module.
  *
- * @param image_width The width of image being downscaled.
- * @param image_height The height of image being downscaled.
+ * The stream is read a beat per cycle. The first row of each window is held in
+ * a line buffer of beats, and when the last row comes in, the columns of each
+ * beat are combined with the buffered ones above them. A beat of the output
+ * covers DOWNSCALE_FACTOR beats of the input, so the columns are collected
+ * until a whole beat of output is ready, which also handles windows that span
+ * two beats when there is a single pixel per beat.
+ *
+ * @tparam IMAGE_WIDTH The width of image being downscaled.
+ * @tparam IMAGE_HEIGHT The height of image being downscaled.
+ *
  * @param[in] grayscale_stream The input stream of grayscale values.
  * @param[in] downscale_stream The output stream of grayscale values
  * representing the downscaled image.
  **/
 template <int IMAGE_WIDTH, int IMAGE_HEIGHT>
-void downscale(grayscale_stream_t& grayscale_stream, grayscale_stream_t& downscale_stream) {
-
+void downscale(grayscale_stream_t& grayscale_stream,
+        grayscale_stream_t& downscale_stream) {
 #pragma HLS INLINE
 
-    // Add in fractional support
-    // Read in all pixels at once
-    grayscale_t grayscale_buffer[DOWNSCALE_FACTOR-1][IMAGE_WIDTH];
-    #pragma HLS ARRAY_PARTITION block dim=1 factor=DOWNSCALE_FACTOR-1 variable=grayscale_buffer
-
-    grayscale_axis_t downscale_stream_pkt;
-    int b = 0;
-    downscale_row_loop: for(int i = 0; i < IMAGE_HEIGHT; i++){
-        grayscale_t block[DOWNSCALE_FACTOR][DOWNSCALE_FACTOR];
-        #pragma HLS ARRAY_PARTITION variable=block complete dim=1
-        int c = 0;
-        downscale_col_loop: for(int j = 0; j < IMAGE_WIDTH; j++){
-            // buffer the value until the last row of a block height
-            // iterate through grayscale_buffer
+    // The number of beats in a row, and the input columns per output beat
+    static const int ROW_BEATS = IMAGE_WIDTH / PIXELS_PER_BEAT;
+    static const int WINDOW_COLS = DOWNSCALE_FACTOR * PIXELS_PER_BEAT;
+    static_assert(IMAGE_WIDTH % WINDOW_COLS == 0,
+            "The width must be a multiple of the columns in an output beat.");
+
+    // The rows of the current windows, except the last, which is streaming in
+    grayscale_beat_t line_buffer[DOWNSCALE_FACTOR-1][ROW_BEATS];
+    #pragma HLS ARRAY_PARTITION variable=line_buffer complete dim=1
+
+    // The columns of the windows for the next output beat
+    grayscale_t columns[DOWNSCALE_FACTOR][WINDOW_COLS];
+    #pragma HLS ARRAY_PARTITION variable=columns complete dim=0
+
+    downscale_row_loop: for (int row = 0; row < IMAGE_HEIGHT; row++) {
+        int window_row = row % DOWNSCALE_FACTOR;
+        downscale_col_loop: for (int col = 0; col < ROW_BEATS; col++) {
         #pragma HLS PIPELINE II=1
 
-            if( b < (DOWNSCALE_FACTOR-1)){
-                grayscale_buffer[b][j] = grayscale_stream.read().tdata;
+            // Buffer the beat, until the last row of the windows comes in
+            grayscale_beat_t pixels = grayscale_stream.read().tdata;
+            if (window_row < DOWNSCALE_FACTOR - 1) {
+                line_buffer[window_row][col] = pixels;
+                continue;
             }
-            else{
-                    block[b][c]= grayscale_stream.read().tdata;
-                    if ( c == DOWNSCALE_FACTOR-1){
-                        window_fill_row: for(int p = 0; p <  (DOWNSCALE_FACTOR - 1); p++) {
-                            window_fill_col: for(int q = 0; q < DOWNSCALE_FACTOR; q++){
-                                block[p][q] = grayscale_buffer[p][j];
-                            }
-                        }
-                        downscale_stream_pkt.tdata = compute_downscale(block);
-                        // Our transfers are always aligned, so set tkeep to -1, and assert
-                        // tlast when we reach the last packet
-                        downscale_stream_pkt.tkeep = -1;
-                        downscale_stream_pkt.tlast = (i == IMAGE_HEIGHT-1) &&( j == IMAGE_WIDTH-1);
-                        // Stream out the grayscale packet
-                        downscale_stream.write(downscale_stream_pkt);
+
+            // Add the beat's columns of the windows to the ones collected
+            int window_beat = col % DOWNSCALE_FACTOR;
+            downscale_lane_loop: for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+            #pragma HLS UNROLL
+                int column = window_beat * PIXELS_PER_BEAT + i;
+                for (int j = 0; j < DOWNSCALE_FACTOR - 1; j++) {
+                    columns[j][column] = line_buffer[j][col][i];
+                }
+                columns[DOWNSCALE_FACTOR-1][column] = pixels[i];
+            }
+            if (window_beat < DOWNSCALE_FACTOR - 1) {
+                continue;
+            }
+
+            // Average each window of the collected columns, for the next beat
+            grayscale_axis_t downscale_stream_pkt;
+            downscale_window_loop: for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+            #pragma HLS UNROLL
+                grayscale_window_t window;
+                for (int j = 0; j < DOWNSCALE_FACTOR; j++) {
+                    for (int k = 0; k < DOWNSCALE_FACTOR; k++) {
+                        window[j][k] = columns[j][i * DOWNSCALE_FACTOR + k];
                     }
                 }
+                downscale_stream_pkt.tdata[i] = compute_downscale(window);
+            }
 
-            c = (c==DOWNSCALE_FACTOR-1)? 0: (c+1);
-          }
-        b = (b==DOWNSCALE_FACTOR-1)? 0: (b+1);
+            /* Our transfers are always aligned, so set tkeep to -1, and assert
+             * tlast when we reach the last packet. */
+            downscale_stream_pkt.tkeep = -1;
+            downscale_stream_pkt.tlast = (row == IMAGE_HEIGHT - 1) &&
+                    (col == ROW_BEATS - 1);
+            downscale_stream.write(downscale_stream_pkt);
+        }
     }
 
     return;
 }
 
-
-
 #endif /* DOWNSCALE_H_ */
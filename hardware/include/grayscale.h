@@ -22,31 +22,60 @@
 
 #include "image.h"                  // Definition of the image format
 #include "axis.h"                   // Definition of the AXIS protocol structure
+#include "preprocess_params.h"      // The grayscale weights, shared with src
 
 /*----------------------------------------------------------------------------
  * Defintions
  *----------------------------------------------------------------------------*/
 
 /**
- * The input stream type, an RGBA pixel AXIS packet.
+ * The input stream type, an AXIS packet of a beat of RGBA pixels.
  **/
-typedef axis<pixel_t, PIXEL_BITS> pixel_axis_t;
+typedef beat<pixel_t, PIXELS_PER_BEAT> pixel_beat_t;
+typedef axis<pixel_beat_t, PIXEL_BITS * PIXELS_PER_BEAT> pixel_axis_t;
 typedef hls::stream<pixel_axis_t> pixel_stream_t;
 
 /**
- * The output stream type, a grayscale value AXIS packet.
+ * The output stream type, an AXIS packet of a beat of grayscale values.
  **/
 typedef ap_uint<COLOR_DEPTH> grayscale_t;
-typedef axis<grayscale_t, COLOR_DEPTH> grayscale_axis_t;
+typedef beat<grayscale_t, PIXELS_PER_BEAT> grayscale_beat_t;
+typedef axis<grayscale_beat_t, COLOR_DEPTH * PIXELS_PER_BEAT>
+        grayscale_axis_t;
 typedef hls::stream<grayscale_axis_t> grayscale_stream_t;
 
+/**
+ * The type of the weighted sum of a pixel's channels, which holds the sum for
+ * every 8-bit pixel without overflow. The weights are shared with the host
+ * detector (see src/preprocess_params.h).
+ **/
+typedef ap_uint<COLOR_DEPTH + GRAYSCALE_WEIGHT_BITS + 2> grayscale_sum_t;
+
+/**
+ * The input stream type for luma and Bayer images, an AXIS packet of a beat of
+ * 8-bit samples, which is laid out the same as a grayscale packet.
+ **/
+typedef grayscale_axis_t luma_axis_t;
+typedef hls::stream<luma_axis_t> luma_stream_t;
+
+/**
+ * The stream type of the image streamed in from the processor, in the input
+ * format that the hardware is built for (see image.h).
+ **/
+#if defined(LUMA_INPUT) || defined(BAYER_INPUT)
+typedef luma_axis_t input_axis_t;
+#else
+typedef pixel_axis_t input_axis_t;
+#endif /* defined(LUMA_INPUT) || defined(BAYER_INPUT) */
+typedef hls::stream<input_axis_t> input_stream_t;
+
 /*----------------------------------------------------------------------------
  * Interface
  *----------------------------------------------------------------------------*/
 
 /**
- * Converts the RGBA pixel into its grayscale, by taking the average of its RGB
- * channels.
+ * Converts the RGBA pixel into its grayscale, by taking the weighted sum of its
+ * RGB channels.
  *
  * This is the combinational interface to the module
  *
@@ -56,8 +85,8 @@ typedef hls::stream<grayscale_axis_t> grayscale_stream_t;
 grayscale_t compute_grayscale(const pixel_t& pixel);
 
 /**
- * Converts the RGBA input stream into its grayscale value, by taking the
- * average of the three RGB channels.
+ * Converts a beat of the RGBA input stream into its grayscale values, by taking
+ * the weighted sum of the three RGB channels of each pixel.
  *
  * This is the sequential interface for the module.
  *
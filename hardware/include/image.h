@@ -21,16 +21,87 @@
  *----------------------------------------------------------------------------*/
 
 /**
- * The dimensions of the image being processed, which is a 1080p image.
+ * The dimensions of the frames being processed, which are 1080p images. For
+ * C-simulation, the size can be overridden by defining SIM_IMAGE_WIDTH and
+ * SIM_IMAGE_HEIGHT on the command line.
  **/
 #ifdef __SYNTHESIS__
-static const int IMAGE_WIDTH                = 1920;
+static const int FRAME_WIDTH                = 1920;
 static const int IMAGE_HEIGHT               = 1080;
+#elif defined(SIM_IMAGE_WIDTH) && defined(SIM_IMAGE_HEIGHT)
+static const int FRAME_WIDTH                = SIM_IMAGE_WIDTH;
+static const int IMAGE_HEIGHT               = SIM_IMAGE_HEIGHT;
 #else
-static const int IMAGE_WIDTH                = 32;
+static const int FRAME_WIDTH                = 32;
 static const int IMAGE_HEIGHT               = 32;
 #endif /* __SYNTHESIS__ */
 
+/**
+ * The width of the image the pipeline processes, which sizes the line buffers
+ * of every stage. This is the whole frame, unless STRIPE_WIDTH is defined on
+ * the command line, in which case the processor sends each frame as vertical
+ * stripes of that many columns, plus a halo of STRIPE_HALO columns on either
+ * side, and stitches their boxes together. The line buffers are then bounded
+ * by the stripe, however wide the frame is. The alignment and halo are shared
+ * with the processor, so the src directory must be on the include path (see
+ * src/stripe_halo.h). The stripe width must be a multiple of the alignment,
+ * and the halo only covers the blob filter's window, so the wider filter bank
+ * can't be built with stripes. The adaptive threshold would measure each
+ * stripe as a frame, so it can't be built with stripes either.
+ *
+ * The processor sends the NUM_STRIPES stripes of each frame in order, from the
+ * left, so the pipeline counts them to know where each one is in the frame.
+ **/
+#ifdef STRIPE_WIDTH
+#ifdef BLOB_FILTER_BANK
+#error "The filter bank reaches past the halos, so can't use STRIPE_WIDTH."
+#endif /* BLOB_FILTER_BANK */
+#ifdef ADAPTIVE_THRESHOLD
+#error "The adaptive threshold measures frames, so can't use STRIPE_WIDTH."
+#endif /* ADAPTIVE_THRESHOLD */
+
+#include "stripe_halo.h"                    // The stripes' alignment and halo
+
+static const int IMAGE_WIDTH                = STRIPE_WIDTH + 2 * STRIPE_HALO;
+static const int NUM_STRIPES                = (FRAME_WIDTH + STRIPE_WIDTH - 1) /
+        STRIPE_WIDTH;
+static_assert(STRIPE_WIDTH % STRIPE_ALIGN == 0,
+        "The stripe width must be a multiple of the stripe alignment.");
+static_assert(IMAGE_WIDTH < FRAME_WIDTH,
+        "The stripes and their halos must be narrower than the frame.");
+#else
+static const int IMAGE_WIDTH                = FRAME_WIDTH;
+#endif /* STRIPE_WIDTH */
+
+/**
+ * The number of pixels carried by each beat (packet) of the streams through the
+ * pipeline, which every stage handles at once, so the frame rate scales with
+ * it. This can be overridden by defining BEAT_PIXELS on the command line, as 2,
+ * 4, or 8, with the AXI DMA's stream width widened to match. The width of the
+ * image at every scale level must be a multiple of twice the beat's pixels.
+ **/
+#ifdef BEAT_PIXELS
+static const int PIXELS_PER_BEAT            = BEAT_PIXELS;
+#else
+static const int PIXELS_PER_BEAT            = 1;
+#endif /* BEAT_PIXELS */
+
+static_assert(PIXELS_PER_BEAT == 1 || PIXELS_PER_BEAT == 2 ||
+        PIXELS_PER_BEAT == 4 || PIXELS_PER_BEAT == 8,
+        "The pixels per beat must be 1, 2, 4, or 8.");
+
+/**
+ * The format of the image streamed in from the processor, which is RGBA pixels
+ * by default. Defining LUMA_INPUT streams in a plane of 8-bit luma instead,
+ * such as the Y plane at the start of an NV12 or I420 frame, which already is
+ * the grayscale image. Defining BAYER_INPUT streams in the raw 8-bit Bayer
+ * mosaic from a sensor, which is demosaiced to luma as it streams in (see
+ * bayer.h). Either one is a quarter of the size of the RGBA image.
+ **/
+#if defined(LUMA_INPUT) && defined(BAYER_INPUT)
+#error "Only one of LUMA_INPUT and BAYER_INPUT may be defined."
+#endif /* defined(LUMA_INPUT) && defined(BAYER_INPUT) */
+
 /**
  * The number of bits needed to represent a color channel in the image.
  **/
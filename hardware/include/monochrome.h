@@ -26,13 +26,21 @@
  *----------------------------------------------------------------------------*/
 
 /**
- * The input stream type is a grayscale AXIS packet. The output stream type is a
- * 1-bit monochrome value AXIS packet.
+ * The input stream type is a grayscale AXIS packet. The output stream type is
+ * an AXIS packet of a beat of 1-bit monochrome values.
  ***/
 typedef ap_uint<1> monochrome_t;
-typedef axis<monochrome_t, 1> monochrome_axis_t;
+typedef beat<monochrome_t, PIXELS_PER_BEAT> monochrome_beat_t;
+typedef axis<monochrome_beat_t, PIXELS_PER_BEAT> monochrome_axis_t;
 typedef hls::stream<monochrome_axis_t> monochrome_stream_t;
 
+/**
+ * The default threshold value used to convert grayscale. If the grayscale
+ * value is greater than or equal to the threshold it becomes 1, otherwise, it
+ * becomes 0.
+ **/
+static const grayscale_t MONOCHROME_THRESHOLD = 0.85 * 255;
+
 /*----------------------------------------------------------------------------
  * Interface
  *----------------------------------------------------------------------------*/
@@ -49,9 +57,22 @@ typedef hls::stream<monochrome_axis_t> monochrome_stream_t;
 monochrome_t compute_monochrome(const grayscale_t& grayscale);
 
 /**
- * Converts the grayscale input stream into an output monochrome stream, by
- * thresholding the grayscale values to convert them to a binary monochrome
- * value.
+ * Converts the grayscale value into a binary monochrome value, thresholding
+ * on the grayscale value with the given threshold, rather than the default.
+ *
+ * This is the combinational interface to the module.
+ *
+ * @param[in] grayscale The grayscale value to convert to monochrome.
+ * @param[in] threshold The lowest grayscale value that becomes 1.
+ * @return The 1-bit monochrome value of the grayscale value.
+ **/
+monochrome_t compute_monochrome(const grayscale_t& grayscale,
+        const grayscale_t& threshold);
+
+/**
+ * Converts a beat of the grayscale input stream into the output monochrome
+ * stream, by thresholding the grayscale values to convert them to binary
+ * monochrome values.
  *
  * This is the sequential interface to the module.
  *
@@ -61,4 +82,17 @@ monochrome_t compute_monochrome(const grayscale_t& grayscale);
 void monochrome(grayscale_stream_t& grayscale_stream,
         monochrome_stream_t& monochrome_stream);
 
+/**
+ * Converts a beat of the grayscale input stream into the output monochrome
+ * stream, thresholding with the given threshold, rather than the default.
+ *
+ * This is the sequential interface to the module.
+ *
+ * @param[in] grayscale_stream The input stream of grayscale values.
+ * @param[out] monochrome_stream The output stream of monochrome values.
+ * @param[in] threshold The lowest grayscale value that becomes 1.
+ **/
+void monochrome(grayscale_stream_t& grayscale_stream,
+        monochrome_stream_t& monochrome_stream, const grayscale_t& threshold);
+
 #endif /* MONOCHROME_H_ */
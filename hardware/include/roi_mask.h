@@ -0,0 +1,103 @@
+/**
+ * @file roi_mask.h
+ * @date Monday, October 19, 2026 at 02:21:33 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the region-of-interest (ROI) mask module.
+ *
+ * The ROI mask module sits in front of the monochrome module at each scale
+ * level, and drops the pixels in tiles of the image that are outside of the
+ * region of interest, by forcing them to black. Pixels that are dropped can
+ * never produce a blob detection.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef ROI_MASK_H_
+#define ROI_MASK_H_
+
+#include <hls_stream.h>             // Definition of the hls::stream class
+#include <ap_int.h>                 // Arbitrary precision integer types
+
+#include "image.h"                  // Definition of the image format
+#include "grayscale.h"              // Definition of the grayscale types
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The size of an ROI tile, in full-resolution pixels, and the number of tiles
+ * along each dimension of the frame. The tile size must be a multiple of the
+ * largest scale factor, so a tile covers whole pixels at every scale level.
+ * The tiles cover the whole frame, even when the pipeline only processes a
+ * stripe of it at a time. The processor loads the mask from a file with tiles
+ * of this size, its ROI_DEFAULT_TILE_SIZE (see src/roi_mask.h).
+ **/
+static const int ROI_TILE_SIZE  = 64;
+static const int ROI_TILE_COLS  = (FRAME_WIDTH + ROI_TILE_SIZE - 1) /
+        ROI_TILE_SIZE;
+static const int ROI_TILE_ROWS  = (IMAGE_HEIGHT + ROI_TILE_SIZE - 1) /
+        ROI_TILE_SIZE;
+
+/**
+ * The bitmap of tiles that are skipped, one word per row of tiles. A set bit
+ * marks a tile outside of the region of interest, so a mask that has not been
+ * programmed (all zeros) processes the whole image.
+ **/
+typedef ap_uint<ROI_TILE_COLS> roi_row_t;
+typedef roi_row_t roi_skip_tiles_t[ROI_TILE_ROWS];
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Drops the pixels of the grayscale stream that are outside of the region of
+ * interest, replacing them with black (zero) values.
+ *
+ * This is the sequential interface to the module.
+ *
+ * @tparam IMAGE_WIDTH The width of the image at this scale level.
+ * @tparam IMAGE_HEIGHT The height of the image at this scale level.
+ * @tparam SCALE The scale factor of this level relative to the full image.
+ *
+ * @param[in] skip_tiles The bitmap of tiles outside the region of interest.
+ * @param x0 The column of the frame at the image's left edge, in
+ *           full-resolution pixels, which is 0 unless it is a stripe. This
+ *           must be a multiple of SCALE.
+ * @param[in] grayscale_stream The input stream of grayscale values.
+ * @param[out] masked_stream The output stream of masked grayscale values.
+ **/
+template <int IMAGE_WIDTH, int IMAGE_HEIGHT, int SCALE>
+void roi_mask(const roi_skip_tiles_t skip_tiles, int x0,
+        grayscale_stream_t& grayscale_stream,
+        grayscale_stream_t& masked_stream) {
+#pragma HLS INLINE
+
+    // The size of a tile, and the image's left edge in the frame, at this level
+    static const int TILE_SIZE = ROI_TILE_SIZE / SCALE;
+    int level_x0 = x0 / SCALE;
+
+    roi_row_loop: for (int row = 0; row < IMAGE_HEIGHT; row++) {
+        roi_row_t skip_row = skip_tiles[row / TILE_SIZE];
+        roi_col_loop: for (int col = 0; col < IMAGE_WIDTH;
+                col += PIXELS_PER_BEAT) {
+        #pragma HLS PIPELINE II=1
+
+            // At the smaller levels, a beat can span more than one tile
+            grayscale_axis_t grayscale_pkt = grayscale_stream.read();
+            roi_lane_loop: for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+            #pragma HLS UNROLL
+                if (skip_row[(level_x0 + col + i) / TILE_SIZE]) {
+                    grayscale_pkt.tdata[i] = 0;
+                }
+            }
+            masked_stream.write(grayscale_pkt);
+        }
+    }
+
+    return;
+}
+
+#endif /* ROI_MASK_H_ */
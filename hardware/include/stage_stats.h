@@ -0,0 +1,114 @@
+/**
+ * @file stage_stats.h
+ * @date Thursday, October 22, 2026 at 10:18:44 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the stage statistics modules.
+ *
+ * The statistics modules sit between two stages of the pipeline, and forward
+ * the stream between them unchanged, while counting its packets. They are only
+ * instantiated when the blob detector is built with BLOB_DETECTOR_STATS
+ * defined, in which case the counts are sent to the processor on an extra
+ * status stream after each frame.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef STAGE_STATS_H_
+#define STAGE_STATS_H_
+
+#include <hls_stream.h>             // Definition of the hls::stream class
+#include <ap_int.h>                 // Arbitrary precision integer types
+
+#include "axis.h"                   // Definition of the AXIS protocol structure
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The type of a counter, which is wide enough to count every pixel of a frame,
+ * and the stream of counters between the statistics modules.
+ **/
+typedef ap_uint<32> stats_count_t;
+typedef hls::stream<stats_count_t> stats_count_stream_t;
+
+/**
+ * The status stream type, a counter AXIS packet.
+ **/
+typedef axis<stats_count_t, 32> stats_axis_t;
+typedef hls::stream<stats_axis_t> stats_stream_t;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Forwards an image's worth of packets from the input to the output stream,
+ * counting the pixels whose data is nonzero (e.g. the set monochrome pixels,
+ * or the blob detections).
+ *
+ * @tparam T The type of the packets in the stream.
+ * @tparam IMAGE_WIDTH The width of the image in the stream.
+ * @tparam IMAGE_HEIGHT The height of the image in the stream.
+ * @tparam LANES The number of pixels in each packet (beat).
+ *
+ * @param[in] input The input stream of packets.
+ * @param[out] output The output stream, with the same packets as the input.
+ * @param[out] counts The stream the count is written to after the image.
+ **/
+template <typename T, int IMAGE_WIDTH, int IMAGE_HEIGHT, int LANES>
+void count_stream(hls::stream<T>& input, hls::stream<T>& output,
+        stats_count_stream_t& counts) {
+#pragma HLS INLINE
+
+    stats_count_t nonzero = 0;
+    count_row_loop: for (int row = 0; row < IMAGE_HEIGHT; row++) {
+        count_col_loop: for (int col = 0; col < IMAGE_WIDTH; col += LANES) {
+        #pragma HLS PIPELINE II=1
+
+            T pkt = input.read();
+            count_lane_loop: for (int i = 0; i < LANES; i++) {
+            #pragma HLS UNROLL
+                nonzero += (pkt.tdata[i] != 0);
+            }
+            output.write(pkt);
+        }
+    }
+
+    counts.write(nonzero);
+    return;
+}
+
+/**
+ * Forwards a list of packets terminated by tlast from the input to the output
+ * stream, counting the packets before the terminating one.
+ *
+ * @tparam T The type of the packets in the stream.
+ * @tparam MAX_ELEMS The maximum number of packets in the list.
+ *
+ * @param[in] input The input stream of packets.
+ * @param[out] output The output stream, with the same packets as the input.
+ * @param[out] counts The stream the count is written to after the list.
+ **/
+template <typename T, int MAX_ELEMS>
+void count_list(hls::stream<T>& input, hls::stream<T>& output,
+        stats_count_stream_t& counts) {
+#pragma HLS INLINE
+
+    stats_count_t count = 0;
+    bool last = false;
+    count_list_loop: for (int i = 0; i < MAX_ELEMS + 1 && !last; i++) {
+    #pragma HLS PIPELINE II=1
+
+        T pkt = input.read();
+        last = pkt.tlast;
+        count += !last;
+        output.write(pkt);
+    }
+
+    counts.write(count);
+    return;
+}
+
+#endif /* STAGE_STATS_H_ */
@@ -0,0 +1,166 @@
+/**
+ * @file threshold.h
+ * @date Tuesday, October 27, 2026 at 02:26:51 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the adaptive threshold module.
+ *
+ * The adaptive threshold module sits after the grayscale stage, and forwards
+ * the grayscale stream unchanged, while accumulating a histogram of its values.
+ * After each frame, the histogram is reduced to the monochrome threshold for
+ * the next frame, so the threshold follows the exposure of the camera without
+ * a second pass over the pixels. The module is only instantiated when the blob
+ * detector is built with ADAPTIVE_THRESHOLD defined.
+ *
+ * There is a single histogram and threshold, carried from whichever frame came
+ * before, so the frames must all come from one camera. When frames from several
+ * sources are interleaved, each would be thresholded by another's exposure, so
+ * the processor refuses to run more than one camera with it. Nor can it be
+ * built with stripes, since it would measure each stripe as a frame.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef THRESHOLD_H_
+#define THRESHOLD_H_
+
+#include <hls_stream.h>             // Definition of the hls::stream class
+#include <ap_int.h>                 // Arbitrary precision integer types
+
+#include "grayscale.h"              // Definition of the grayscale types
+#include "monochrome.h"             // Definition of the default threshold
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The number of bins in the histogram, one per grayscale value, and the type
+ * of a bin, which is wide enough to count every pixel of a frame.
+ **/
+static const int HISTOGRAM_BINS = 1 << COLOR_DEPTH;
+typedef ap_uint<32> histogram_count_t;
+
+/**
+ * The threshold is the lowest one that leaves at most 1 in 2^ADAPTIVE_SHIFT of
+ * the pixels set, so the monochrome image keeps the brightest pixels of the
+ * frame, whatever its exposure. It is never lower than ADAPTIVE_MIN_THRESHOLD,
+ * so a dark frame does not set its noise.
+ **/
+static const int ADAPTIVE_SHIFT = 8;
+static const grayscale_t ADAPTIVE_MIN_THRESHOLD = 128;
+
+/**
+ * The stream of thresholds sent to each monochrome stage, one per frame.
+ **/
+typedef hls::stream<grayscale_t> threshold_stream_t;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Computes the monochrome threshold from the histogram of a frame.
+ *
+ * This is the combinational interface to the module.
+ *
+ * @param[in] histogram The number of pixels with each grayscale value.
+ * @param pixels The number of pixels in the frame.
+ * @return The lowest threshold that sets at most 1 in 2^ADAPTIVE_SHIFT pixels,
+ *         clamped to at least ADAPTIVE_MIN_THRESHOLD.
+ **/
+grayscale_t compute_threshold(const histogram_count_t histogram[HISTOGRAM_BINS],
+        histogram_count_t pixels);
+
+/**
+ * Forwards a frame of grayscale packets from the input to the output stream,
+ * accumulating the histogram of its values, and computes the threshold for
+ * the next frame from it.
+ *
+ * The threshold for this frame, which was computed from the last frame, is
+ * sent to each of the threshold streams before the frame is read, so that the
+ * monochrome stages can start on it right away. The first frame uses the
+ * default threshold. This is the sequential interface to the module.
+ *
+ * Each lane of the beat has its own bank of the histogram, so every lane is
+ * counted each cycle, and holds the bin it last counted in a register, so that
+ * a run of the same value does not wait on the memory. After the frame, the
+ * banks are merged and cleared for the next frame, and the merged histogram is
+ * walked from the brightest bin down for the threshold.
+ *
+ * @tparam IMAGE_WIDTH The width of the image in the stream.
+ * @tparam IMAGE_HEIGHT The height of the image in the stream.
+ * @tparam N The number of monochrome stages that receive the threshold.
+ *
+ * @param[in] input The input stream of grayscale values.
+ * @param[out] output The output stream, with the same packets as the input.
+ * @param[out] thresholds The streams the frame's threshold is written to.
+ **/
+template <int IMAGE_WIDTH, int IMAGE_HEIGHT, int N>
+void adaptive_threshold(grayscale_stream_t& input, grayscale_stream_t& output,
+        threshold_stream_t (&thresholds)[N]) {
+#pragma HLS INLINE
+
+    // The histogram is cleared after every frame, so it persists as zeros
+    static histogram_count_t histogram[PIXELS_PER_BEAT][HISTOGRAM_BINS];
+    static grayscale_t threshold = MONOCHROME_THRESHOLD;
+    #pragma HLS ARRAY_PARTITION variable=histogram complete dim=1
+
+    threshold_send_loop: for (int i = 0; i < N; i++) {
+    #pragma HLS UNROLL
+        thresholds[i].write(threshold);
+    }
+
+    /* The bin each lane last counted, and its count, which is only written
+     * back once the lane counts another bin. */
+    grayscale_t last_bin[PIXELS_PER_BEAT];
+    histogram_count_t last_count[PIXELS_PER_BEAT];
+    #pragma HLS ARRAY_PARTITION variable=last_bin complete
+    #pragma HLS ARRAY_PARTITION variable=last_count complete
+    for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+        last_bin[lane] = 0;
+        last_count[lane] = 0;
+    }
+
+    histogram_row_loop: for (int row = 0; row < IMAGE_HEIGHT; row++) {
+        histogram_col_loop: for (int col = 0; col < IMAGE_WIDTH;
+                col += PIXELS_PER_BEAT) {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS DEPENDENCE variable=histogram intra RAW false
+
+            grayscale_axis_t pkt = input.read();
+            histogram_lane_loop: for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+            #pragma HLS UNROLL
+                grayscale_t value = pkt.tdata[i];
+                if (value == last_bin[i]) {
+                    last_count[i]++;
+                } else {
+                    histogram[i][last_bin[i]] = last_count[i];
+                    last_count[i] = histogram[i][value] + 1;
+                    last_bin[i] = value;
+                }
+            }
+            output.write(pkt);
+        }
+    }
+
+    // Write back each lane's last bin, then merge the lanes into one histogram
+    histogram_count_t merged[HISTOGRAM_BINS];
+    for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+        histogram[lane][last_bin[lane]] = last_count[lane];
+    }
+    histogram_merge_loop: for (int bin = 0; bin < HISTOGRAM_BINS; bin++) {
+    #pragma HLS PIPELINE II=1
+        histogram_count_t count = 0;
+        for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+            count += histogram[lane][bin];
+            histogram[lane][bin] = 0;
+        }
+        merged[bin] = count;
+    }
+
+    threshold = compute_threshold(merged, IMAGE_WIDTH * IMAGE_HEIGHT);
+    return;
+}
+
+#endif /* THRESHOLD_H_ */
@@ -18,136 +18,132 @@
 
 #include "axis.h"               // Definition of the AXIS protocol structure
 
-const int MAX_WINDOW_DIM = 14; //log2, so max 4,096 bit image
-const int MAX_KERNEL_DIM = 5; //log2, so max 31x32 kernel
-
+/* Template for the pipeline that applies a window function to every position
+ * of an image, where the window is the KERNEL_HEIGHT by KERNEL_WIDTH
+ * neighborhood centered on the position. Positions whose window would run off
+ * the edge of the image are output as zero. The window function is passed the
+ * window with its top-left corner at (start_row, start_col), wrapping around.
+ *
+ * The image is streamed in beats of LANES consecutive pixels of a row, and a
+ * beat of the output is computed per cycle, so the window function is
+ * instantiated once per lane. The last KERNEL_HEIGHT-1 rows are kept in line
+ * buffers of beats, and each incoming beat is stacked with the buffered beats
+ * above it into a column of beats, which is shifted into a window register
+ * wide enough for every lane's window. The output is a beat behind the input
+ * for each beat of columns the windows reach past the beat's right edge, and
+ * KERNEL_HEIGHT/2 rows behind it. The windows at the ends of a row reach into
+ * the rows before or after it, but only for positions on the edge, so the
+ * stray values are never used. */
 template <typename IN_T, typename OUT_T, size_t IN_T_BITS, size_t OUT_T_BITS,
           int IMAGE_HEIGHT, int IMAGE_WIDTH, int KERNEL_HEIGHT, int KERNEL_WIDTH,
-          OUT_T (*window_f)(IN_T window[KERNEL_HEIGHT][KERNEL_WIDTH], int start_row, int start_col)>
+          OUT_T (*window_f)(IN_T window[KERNEL_HEIGHT][KERNEL_WIDTH], int start_row, int start_col),
+          int LANES = 1>
 struct window_pipeline {
 
+    static_assert(IMAGE_WIDTH % LANES == 0,
+            "The image width must be a multiple of the beat's lanes.");
 
-    //typedef OUT_T (*window_f)(IN_T window[KERNEL_HEIGHT][KERNEL_WIDTH]);
-    //const window_f window_function;
-    //rowbuffer idx
-    ap_uint<MAX_WINDOW_DIM> head_row;
-    ap_uint<MAX_WINDOW_DIM> tail_row; //The row we store into
-    ap_uint<MAX_WINDOW_DIM> tail_col; //The col we store into -- equal to head_col
-    ap_uint<1> init_row; //Are we doing the first row for the first time
-
-    //window idx
-    ap_uint<MAX_KERNEL_DIM> head_win;
-    ap_uint<MAX_KERNEL_DIM> tail_win;
-
-    // Constructor
-    window_pipeline() {
-        //initialize head and tail row
-        head_row = 0;
-        tail_row = 0;
-        tail_col = 0; //Equal to head_col
-        init_row = 1;
+    // The number of beats in a row, and the distance from a window's center
+    static const int ROW_BEATS = IMAGE_WIDTH / LANES;
+    static const int HALF_HEIGHT = KERNEL_HEIGHT / 2;
+    static const int HALF_WIDTH = KERNEL_WIDTH / 2;
 
-        head_win = 0;
-        tail_win = 0;
-    }
+    /* The beats of columns the windows reach to each side of the output beat,
+     * the columns in the window register, and how far the output lags. */
+    static const int REACH_BEATS = (HALF_WIDTH + LANES - 1) / LANES;
+    static const int WINDOW_COLS = (2 * REACH_BEATS + 1) * LANES;
+    static const int LAG = HALF_HEIGHT * ROW_BEATS + REACH_BEATS;
 
-    typedef axis<IN_T, IN_T_BITS> in_pkt_t;
+    typedef beat<IN_T, LANES> in_beat_t;
+    typedef axis<in_beat_t, IN_T_BITS * LANES> in_pkt_t;
     typedef hls::stream<in_pkt_t> in_stream_t;
 
-    typedef axis<OUT_T, OUT_T_BITS> out_pkt_t;
+    typedef beat<OUT_T, LANES> out_beat_t;
+    typedef axis<out_beat_t, OUT_T_BITS * LANES> out_pkt_t;
     typedef hls::stream<out_pkt_t> out_stream_t;
 
     // window operation
     void window_op(in_stream_t& in_stream, out_stream_t& out_stream) {
-    #pragma HLS_INLINE
+    #pragma HLS INLINE
 
-        in_pkt_t in_pkt;
-        out_pkt_t out_pkt;
-
-        int offset = KERNEL_WIDTH/2 + (IMAGE_WIDTH*(KERNEL_HEIGHT/2));
-        int out_pointer = -offset; //Which pixel of the output image are we looking at?
-        int row_out_pointer = 0;
-
-        IN_T rowbuffer[KERNEL_HEIGHT][IMAGE_WIDTH];
-        IN_T window[KERNEL_HEIGHT][KERNEL_WIDTH];
+        in_beat_t rowbuffer[KERNEL_HEIGHT-1][ROW_BEATS];
+        IN_T window[KERNEL_HEIGHT][WINDOW_COLS];
+        #pragma HLS ARRAY_PARTITION variable=rowbuffer complete dim=1
         #pragma HLS DEPENDENCE variable=rowbuffer inter RAW false
-        #pragma HLS DEPENDENCE variable=window inter RAW false
-        #pragma HLS ARRAY_PARTITION variable=window complete
+        #pragma HLS ARRAY_PARTITION variable=window complete dim=0
+
+        // The position of the next beat in, and of the next beat out
+        int in_col = 0;
+        int out_row = 0;
+        int out_col = 0;
 
-        pixel_op: for (int in_pointer = 0; in_pointer < IMAGE_WIDTH * IMAGE_HEIGHT + offset; in_pointer++) {
+        beat_op: for (int in_pointer = 0;
+                in_pointer < IMAGE_HEIGHT * ROW_BEATS + LAG; in_pointer++) {
         #pragma HLS PIPELINE II=1
 
             //Input Processing
             //Stop loading packets when we've loaded them all
-            if (in_pointer < IMAGE_WIDTH*IMAGE_HEIGHT)
-                in_stream >> in_pkt;
-            rowbuffer[tail_row][tail_col] = in_pkt.tdata;
-
-            //Window Forming:
-            //If we have loaded in KERNEL_HEIGHT-1 full rows, we can load columns into the window
-            col_to_window: if (in_pointer >= (KERNEL_HEIGHT-1)*IMAGE_WIDTH) {
-                for (int i = 0; i < KERNEL_HEIGHT; i++) {
-                    window[i][tail_win] = rowbuffer[i][tail_col]; //When i == tail_col we should really be forwarding, not loading again
+            in_beat_t in_beat = in_beat_t();
+            if (in_pointer < IMAGE_HEIGHT * ROW_BEATS) {
+                in_beat = in_stream.read().tdata;
+            }
+
+            //Stack the beat under the buffered beats above it, shifting them up
+            in_beat_t column[KERNEL_HEIGHT];
+            for (int i = 0; i < KERNEL_HEIGHT - 1; i++) {
+                column[i] = rowbuffer[i][in_col];
+            }
+            column[KERNEL_HEIGHT-1] = in_beat;
+            for (int i = 0; i < KERNEL_HEIGHT - 1; i++) {
+                rowbuffer[i][in_col] = column[i+1];
+            }
+
+            //Window Forming: shift the column of beats into the window
+            for (int i = 0; i < KERNEL_HEIGHT; i++) {
+                for (int j = 0; j < WINDOW_COLS - LANES; j++) {
+                    window[i][j] = window[i][j+LANES];
+                }
+                for (int j = 0; j < LANES; j++) {
+                    window[i][WINDOW_COLS-LANES+j] = column[i][j];
                 }
             }
 
             //Output Processing
             //Only care if output is inside the out window
-            //In addition, if we're on an edge, top, bottom, left, or right, assign 0 packets
-            if (out_pointer >= 0) {
-                if (row_out_pointer < KERNEL_WIDTH/2 || //Left rows
-                    row_out_pointer >= IMAGE_WIDTH - KERNEL_WIDTH/2 || //Right rows
-                    out_pointer < IMAGE_WIDTH*(KERNEL_HEIGHT/2) || //Top rows
-                    out_pointer >= (IMAGE_HEIGHT - KERNEL_HEIGHT/2) * IMAGE_WIDTH) { //Bottom rows
-                    out_pkt.tdata = 0;
-                    out_pkt.tlast = (out_pointer == IMAGE_WIDTH*IMAGE_HEIGHT-1) ? 1 : 0;
-                    out_pkt.tkeep = -1;
-                }
-                else {
-                    out_pkt.tdata = window_f(window, head_row, head_win);
-                    out_pkt.tlast = 0;
-                    out_pkt.tkeep = -1;
+            //In addition, if we're on an edge, top, bottom, left, or right, assign 0 values
+            if (in_pointer >= LAG) {
+                out_pkt_t out_pkt;
+                for (int lane = 0; lane < LANES; lane++) {
+                #pragma HLS UNROLL
+                    int col = out_col * LANES + lane;
+                    IN_T lane_window[KERNEL_HEIGHT][KERNEL_WIDTH];
+                    for (int i = 0; i < KERNEL_HEIGHT; i++) {
+                        for (int j = 0; j < KERNEL_WIDTH; j++) {
+                            lane_window[i][j] = window[i][REACH_BEATS * LANES +
+                                    lane - HALF_WIDTH + j];
+                        }
+                    }
+
+                    bool edge = col < HALF_WIDTH || //Left columns
+                        col >= IMAGE_WIDTH - HALF_WIDTH || //Right columns
+                        out_row < HALF_HEIGHT || //Top rows
+                        out_row >= IMAGE_HEIGHT - HALF_HEIGHT; //Bottom rows
+                    out_pkt.tdata[lane] = edge ? OUT_T(0) :
+                            window_f(lane_window, 0, 0);
                 }
+                out_pkt.tlast = (out_row == IMAGE_HEIGHT - 1 &&
+                        out_col == ROW_BEATS - 1) ? 1 : 0;
+                out_pkt.tkeep = -1;
                 out_stream << out_pkt;
-            }
-
-
-
-            //update the rowbuffer head, tail position
-            update_tail();
-            update_head();
-
-            //update the window head and tail
-            tail_win = (tail_win + 1 == KERNEL_WIDTH) ? 0 : tail_win.to_int() + 1;
-            head_win = (tail_win == head_win) ? ((head_win + 1 == KERNEL_WIDTH) ? 0 : head_win.to_int() + 1) : head_win.to_int();
-
 
-            //update the in and out
-            if (out_pointer >= 0) {
-                row_out_pointer = (row_out_pointer + 1 == IMAGE_WIDTH) ? 0 : row_out_pointer + 1;
+                out_row = (out_col + 1 == ROW_BEATS) ? out_row + 1 : out_row;
+                out_col = (out_col + 1 == ROW_BEATS) ? 0 : out_col + 1;
             }
-            out_pointer = out_pointer + 1;
 
+            //update the in position
+            in_col = (in_col + 1 == ROW_BEATS) ? 0 : in_col + 1;
         }
      }
-
-
-
-     // helper functions
-     void update_tail(){
-        if ((tail_col + 1) == IMAGE_WIDTH){
-             //update row
-             tail_row = (tail_row + 1 == KERNEL_HEIGHT) ? 0 : tail_row.to_int() + 1;
-             init_row = 0;
-        }
-        tail_col = (tail_col + 1 == IMAGE_WIDTH) ? 0 : tail_col.to_int() + 1;
-     }
-     void update_head(){
-         //update head_row
-         if (tail_row == head_row && !init_row){
-            head_row = (head_row + 1 == KERNEL_HEIGHT) ? 0 : head_row.to_int() + 1;
-         }
-     }
 };
 
 #endif /* WINDOW_FETCH_H_ */
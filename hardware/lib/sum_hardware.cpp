@@ -2,7 +2,7 @@
 #include "windowfetch.h"        // Definition of the window pipeline class 
 #include "axis.h"               // Definition of the AXIS protocol structure
 
-typedef axis<int, 32> num_axis_t;
+typedef axis<beat<int, 1>, 32> num_axis_t;
 typedef hls::stream<num_axis_t> num_stream_t;
 const int KERNEL_HEIGHT = 3;
 const int KERNEL_WIDTH = 3;
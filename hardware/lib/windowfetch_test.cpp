@@ -14,7 +14,7 @@
 #include "windowfetch.h"        // Definition of the window pipeline class 
 #include "axis.h"               // Definition of the AXIS protocol structure
 
-typedef axis<int, 32> num_axis_t;
+typedef axis<beat<int, 1>, 32> num_axis_t;
 typedef hls::stream<num_axis_t> num_stream_t;
 const int KERNEL_HEIGHT = 3;
 const int KERNEL_WIDTH = 3;
@@ -33,7 +33,7 @@ int main() {
     num_stream_t stream2;
     for (int i = 0; i < IMAGE_WIDTH*IMAGE_HEIGHT; i++) {
         num_axis_t inpkt;
-        inpkt.tdata = 1;
+        inpkt.tdata[0] = 1;
         inpkt.tkeep = -1;
         inpkt.tlast = (i == IMAGE_WIDTH*IMAGE_HEIGHT-1) ? 1 : 0;
         //printf("Tlast: %d\n", inpkt.tlast.to_int());
@@ -51,7 +51,7 @@ int main() {
         	num_axis_t outpkt;
         	stream2 >> outpkt;
         	last = outpkt.tlast.to_int();
-        	image[0][count] = outpkt.tdata;
+        	image[0][count] = outpkt.tdata[0];
         	count += 1;
         	//printf("Sum = %d, last = %d\n", outpkt.tdata, last);
         }
@@ -0,0 +1,59 @@
+/**
+ * @file bayer.cpp
+ * @date Monday, October 26, 2026 at 10:52:07 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of the Bayer demosaic module.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <ap_int.h>                 // Arbitrary precision integer types
+
+#include "grayscale.h"              // Definition of the grayscale types
+#include "bayer.h"                  // Our interface and Bayer definitions
+
+/*----------------------------------------------------------------------------
+ * Bayer Module
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Computes the luma of a 2x2 block of samples of the mosaic, taking the
+ * weighted sum of its red, blue, and the mean of its two green samples.
+ *
+ * This is the combinational interface to the module.
+ **/
+grayscale_t compute_bayer_luma(bayer_block_t block, bool greens_on_diagonal) {
+#pragma HLS INLINE
+
+    // Sum the samples on each diagonal, with enough bits to prevent overflow
+    ap_uint<COLOR_DEPTH+3> diagonal = block[0][0] + block[1][1];
+    ap_uint<COLOR_DEPTH+3> anti_diagonal = block[0][1] + block[1][0];
+
+    /* Taking the mean of the greens, and of the red and blue weights, is the
+     * same as weighting each sum with the sum of its weights, and shifting out
+     * one more bit. */
+    grayscale_sum_t greens = greens_on_diagonal ? diagonal : anti_diagonal;
+    grayscale_sum_t red_blue = greens_on_diagonal ? anti_diagonal : diagonal;
+    grayscale_sum_t sum = (GRAYSCALE_RED_WEIGHT + GRAYSCALE_BLUE_WEIGHT) *
+            red_blue + GRAYSCALE_GREEN_WEIGHT * greens;
+    return sum >> (GRAYSCALE_WEIGHT_BITS + 1);
+}
+
+/*----------------------------------------------------------------------------
+ * Top Function for Synthesis
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The top function for the Bayer module when it is synthesized by itself.
+ *
+ * This is the function that HLS will look for if the Bayer module is
+ * synthesized into its own IP block.
+ **/
+void bayer_top(luma_stream_t& mosaic_stream, grayscale_stream_t& luma_stream) {
+#pragma HLS INTERFACE axis port=mosaic_stream
+#pragma HLS INTERFACE axis port=luma_stream
+
+    bayer_luma<IMAGE_WIDTH, IMAGE_HEIGHT>(mosaic_stream, luma_stream);
+    return;
+}
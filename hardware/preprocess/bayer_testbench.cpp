@@ -0,0 +1,102 @@
+/**
+ * @file bayer_testbench.cpp
+ * @date Monday, October 26, 2026 at 11:34:26 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the testbench for the Bayer demosaic module.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <assert.h>                 // Assert macro
+#include <stdio.h>                  // Printf function
+#include <stdlib.h>                 // Random number generator
+
+#include <algorithm>                // Min function
+
+#include "grayscale.h"              // Definition of the grayscale types
+#include "bayer.h"                  // Bayer interface and definitions
+
+// The size of the test mosaic, which is a few beats wide at any beat width
+static const int TEST_WIDTH = 32;
+static const int TEST_HEIGHT = 9;
+
+/* Computes the expected luma of a pixel, from the block to the right of it and
+ * below it, or to the left of it or above it on the last column and row. */
+static int expected_luma(const int mosaic[TEST_HEIGHT][TEST_WIDTH], int x,
+        int y)
+{
+    int left = std::min(x, TEST_WIDTH - 2);
+    int top = std::min(y, TEST_HEIGHT - 2);
+    int diagonal = mosaic[top][left] + mosaic[top+1][left+1];
+    int anti_diagonal = mosaic[top][left+1] + mosaic[top+1][left];
+    if ((left + top) % 2 == BAYER_GREEN_PARITY) {
+        return (2 * anti_diagonal + diagonal) / 6;
+    }
+    return (2 * diagonal + anti_diagonal) / 6;
+}
+
+/* Checks that the fixed-point luma of every block is exactly the average of
+ * red, blue, and the mean of the greens, rounded down, as a divider would
+ * compute it. The luma only depends on the sums of the two diagonals, so
+ * every pair of sums covers every block. */
+static void check_all_blocks()
+{
+    const int max_value = (1 << COLOR_DEPTH) - 1;
+    for (int greens = 0; greens <= 2 * max_value; greens++) {
+        for (int red_blue = 0; red_blue <= 2 * max_value; red_blue++) {
+            int green = std::min(greens, max_value);
+            int red = std::min(red_blue, max_value);
+            bayer_block_t block = {{green, red_blue - red},
+                    {red, greens - green}};
+            assert(compute_bayer_luma(block, true).to_int() ==
+                    (2 * red_blue + greens) / 6);
+        }
+    }
+}
+
+int main()
+{
+    // A block of the brightest samples doesn't overflow
+    bayer_block_t block = {{255, 255}, {255, 255}};
+    assert(compute_bayer_luma(block, true).to_int() == 255);
+    check_all_blocks();
+
+    // Stream in a random mosaic, a beat at a time
+    int mosaic[TEST_HEIGHT][TEST_WIDTH];
+    luma_stream_t mosaic_stream;
+    srand(0);
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x += PIXELS_PER_BEAT) {
+            luma_axis_t mosaic_pkt;
+            for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+                mosaic[y][x+i] = rand() % 256;
+                mosaic_pkt.tdata[i] = mosaic[y][x+i];
+            }
+            mosaic_pkt.tkeep = -1;
+            mosaic_pkt.tlast = (y == TEST_HEIGHT - 1) &&
+                    (x + PIXELS_PER_BEAT == TEST_WIDTH);
+            mosaic_stream << mosaic_pkt;
+        }
+    }
+
+    // Every pixel has the luma of its block, and the last beat asserts tlast
+    grayscale_stream_t luma_stream;
+    bayer_luma<TEST_WIDTH, TEST_HEIGHT>(mosaic_stream, luma_stream);
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x += PIXELS_PER_BEAT) {
+            grayscale_axis_t luma_pkt;
+            luma_stream >> luma_pkt;
+            for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+                assert(luma_pkt.tdata[i].to_int() ==
+                        expected_luma(mosaic, x + i, y));
+            }
+            assert(luma_pkt.tlast.to_int() == ((y == TEST_HEIGHT - 1) &&
+                    (x + PIXELS_PER_BEAT == TEST_WIDTH)));
+        }
+    }
+    assert(mosaic_stream.empty() && luma_stream.empty());
+
+    printf("Bayer testbench passed.\n");
+    return 0;
+}
@@ -31,16 +31,14 @@
 grayscale_t compute_downscale(grayscale_window_t window) {
 #pragma HLS INLINE
 
-    // TODO: Add in fractional input support?
-    ap_int<16> sum = 0;
-    ap_int<8> average = 0;
+    // The sum is unsigned, so the average is a shift rather than a division
+    ap_uint<COLOR_DEPTH + DOWNSCALE_SHIFT> sum = 0;
     downscale_row: for (int i = 0; i < DOWNSCALE_FACTOR; i++){
         downscale_col: for (int j = 0; j < DOWNSCALE_FACTOR; j++){
             sum += window[i][j];
         }
     }
-    average = sum / (DOWNSCALE_FACTOR * DOWNSCALE_FACTOR);
-    return average;
+    return sum >> DOWNSCALE_SHIFT;
 }
 
 
@@ -59,6 +57,6 @@ void downscale_top(grayscale_stream_t& grayscale_stream,
 #pragma HLS INTERFACE axis port=grayscale_stream
 #pragma HLS INTERFACE axis port=downscale_stream
 
-    downscale<IMAGE_HEIGHT, IMAGE_WIDTH>(grayscale_stream, downscale_stream);
+    downscale<IMAGE_WIDTH, IMAGE_HEIGHT>(grayscale_stream, downscale_stream);
     return;
 }
@@ -6,8 +6,8 @@
 #include <stdlib.h>
 
 
-const int TEST_HEIGHT = 15;
-const int TEST_WIDTH = 15;
+const int TEST_HEIGHT = 16;
+const int TEST_WIDTH = 16;
 
 /*
 static const grayscale_t image[TEST_HEIGHT][TEST_WIDTH] ={
@@ -34,15 +34,18 @@ int main(){
 	for(int i = 0; i < TEST_HEIGHT; i++){
 		for(int j = 0; j < TEST_WIDTH; j++){
 			image[i][j] = 0xFF;
-            image_pixel_pkt.tdata = image[i][j];
+            image_pixel_pkt.tdata[j % PIXELS_PER_BEAT] = image[i][j];
             image_pixel_pkt.tkeep = -1;
+			printf("image[%d][%d] = %d\n", i, j, image[i][j].to_int());
+            if (j % PIXELS_PER_BEAT != PIXELS_PER_BEAT - 1){
+                continue;
+            }
             if (i == TEST_HEIGHT-1 && j == TEST_WIDTH -1){
             	image_pixel_pkt.tlast = 1;
             }else{
             	image_pixel_pkt.tlast = 0;
             }
             grayscale_stream <<image_pixel_pkt;
-			printf("image[%d][%d] = %d\n", i, j, image[i][j].to_int());
 		}
 	}
 	
@@ -54,7 +57,9 @@ int main(){
 	while (last == 0){
 		downscale_stream >> downscale_pkt;
 		last = downscale_pkt.tlast;
-		printf("downscale_pkt = %d\n",downscale_pkt.tdata.to_int());
+		for (int i = 0; i < PIXELS_PER_BEAT; i++){
+			printf("downscale_pkt = %d\n",downscale_pkt.tdata[i].to_int());
+		}
 	}
 
 	return 0;
@@ -24,20 +24,22 @@
  *----------------------------------------------------------------------------*/
 
 /**
- * Converts the image pixel to grayscale, simply taking the average of its 3
- * grayscale channels.
+ * Converts the image pixel to grayscale, taking the weighted sum of its 3
+ * color channels, and dropping the fractional bits of the weights.
  *
  * This is the combinational interface to the module.
  **/
 grayscale_t compute_grayscale(const pixel_t& pixel) {
 #pragma HLS INLINE
 
-    // Convert the RGB channels to 10-bit values to prevent overflow
-    ap_int<COLOR_DEPTH+2> red = pixel.red;
-    ap_int<COLOR_DEPTH+2> blue = pixel.blue;
-    ap_int<COLOR_DEPTH+2> green = pixel.green;
+    // Widen the RGB channels to the sum's width to prevent overflow
+    grayscale_sum_t red = pixel.red;
+    grayscale_sum_t blue = pixel.blue;
+    grayscale_sum_t green = pixel.green;
 
-    return (red + blue + green) / 3;
+    grayscale_sum_t sum = GRAYSCALE_RED_WEIGHT * red +
+            GRAYSCALE_GREEN_WEIGHT * green + GRAYSCALE_BLUE_WEIGHT * blue;
+    return sum >> GRAYSCALE_WEIGHT_BITS;
 }
 
 /**
@@ -53,9 +55,13 @@ void grayscale(pixel_stream_t& pixel_stream,
     pixel_axis_t pixel_axis_pkt;
     pixel_stream >> pixel_axis_pkt;
 
-    // Compute the grayscale value, and send the value downstream
+    // Compute the grayscale value of each pixel, and send them downstream
     grayscale_axis_t grayscale_axis_pkt;
-    grayscale_axis_pkt.tdata = compute_grayscale(pixel_axis_pkt.tdata);
+    grayscale_lane_loop: for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+    #pragma HLS UNROLL
+        grayscale_axis_pkt.tdata[i] = compute_grayscale(
+                pixel_axis_pkt.tdata[i]);
+    }
 
     /* Our transfers are always aligned, so set tkeep to -1, and assert
      * tlast when we reach the last packet. */
@@ -7,19 +7,46 @@
  **/
 
 #include <assert.h>         // Assert macro
+#include <stdio.h>          // Printf function
 
 #include "grayscale.h"      // Grayscale interface and definitions
 
-// TODO: Make more robust
+/* Checks the fixed-point grayscale of every 8-bit pixel. With the default
+ * weights, it must be exactly the average of the channels, rounded down, as a
+ * divider would compute it. With the BT.601 weights, it must be the luma with
+ * the exact coefficients, rounded down, give or take one. */
+static void check_all_pixels()
+{
+    const int max_value = (1 << COLOR_DEPTH) - 1;
+    for (int red = 0; red <= max_value; red++) {
+        for (int green = 0; green <= max_value; green++) {
+            for (int blue = 0; blue <= max_value; blue++) {
+                pixel_t pixel(red, green, blue, 0);
+                int gray = compute_grayscale(pixel).to_int();
+#ifdef BT601_GRAYSCALE
+                int luma = (299 * red + 587 * green + 114 * blue) / 1000;
+                assert(gray >= luma - 1 && gray <= luma + 1);
+#else
+                assert(gray == (red + green + blue) / 3);
+#endif /* BT601_GRAYSCALE */
+            }
+        }
+    }
+}
+
 int main()
 {
+    check_all_pixels();
+
     // Input and output streams for grayscale
     pixel_stream_t pixel_stream;
     grayscale_stream_t grayscale_stream;
 
     // Setup the pixel AXIS packet
     pixel_axis_t pixel_axis_pkt;
-    pixel_axis_pkt.tdata = 0x00010203;
+    for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+        pixel_axis_pkt.tdata[i] = pixel_t(3 + i, 2 + i, 1 + i, 0);
+    }
     pixel_axis_pkt.tkeep = -1;
     pixel_axis_pkt.tlast = 1;
 
@@ -30,9 +57,13 @@ int main()
     grayscale_stream >> grayscale_axis_pkt;
 
     // Verify that the output is correct
-    assert(grayscale_axis_pkt.tdata.to_int() == 2);
-    assert(grayscale_axis_pkt.tkeep.to_int() == -1);
+    for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+        assert(grayscale_axis_pkt.tdata[i].to_int() == 2 + i);
+    }
+    // One byte per pixel, valid
+    assert(grayscale_axis_pkt.tkeep.to_int() == (1 << PIXELS_PER_BEAT) - 1);
     assert(grayscale_axis_pkt.tlast.to_int() == 1);
 
+    printf("Grayscale testbench passed.\n");
     return 0;
 }
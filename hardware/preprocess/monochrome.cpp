@@ -6,7 +6,8 @@
  * This file contains the implementation of the monochrome module.
  *
  * The monochrome module simply takes an 8-bit grayscale input stream, and uses
- * the defined threshold to convert it to a 1-bit monochrome value.
+ * the defined threshold, or one that is passed in, to convert it to a 1-bit
+ * monochrome value.
  *
  * @bug No known bugs.
  **/
@@ -14,16 +15,6 @@
 #include "grayscale.h"      // Definition of grayscale types
 #include "monochrome.h"     // Our interface and grayscale types
 
-/*----------------------------------------------------------------------------
- * Internal Definitions
- *----------------------------------------------------------------------------*/
-
-/**
- * The threshold value used to convert grayscale. If the grayscale value is
- * greater than or equal to the threshold it becomes 1, otherwise, it becomes 0.
- **/
-const grayscale_t MONOCHROME_THRESHOLD = 0.85 * 255;
-
 /*----------------------------------------------------------------------------
  * Monochrome Module
  *----------------------------------------------------------------------------*/
@@ -35,7 +26,19 @@ const grayscale_t MONOCHROME_THRESHOLD = 0.85 * 255;
  **/
 monochrome_t compute_monochrome(const grayscale_t& grayscale)
 {
-    return grayscale >= MONOCHROME_THRESHOLD;
+    return compute_monochrome(grayscale, MONOCHROME_THRESHOLD);
+}
+
+/**
+ * Converts the grayscale into a binary monochrome value, with the given
+ * threshold.
+ *
+ * This is the combinational interface to the module.
+ **/
+monochrome_t compute_monochrome(const grayscale_t& grayscale,
+        const grayscale_t& threshold)
+{
+    return grayscale >= threshold;
 }
 
 /**
@@ -47,13 +50,31 @@ void monochrome(grayscale_stream_t& grayscale_stream,
         monochrome_stream_t& monochrome_stream) {
 #pragma HLS INLINE
 
+    monochrome(grayscale_stream, monochrome_stream, MONOCHROME_THRESHOLD);
+    return;
+}
+
+/**
+ * Converts the stream of grayscale values into a monochrome stream, with the
+ * given threshold.
+ *
+ * This is the sequential interface to the module.
+ **/
+void monochrome(grayscale_stream_t& grayscale_stream,
+        monochrome_stream_t& monochrome_stream, const grayscale_t& threshold) {
+#pragma HLS INLINE
+
     // Read in the next grayscale value packet
     grayscale_axis_t grayscale_axis_pkt;
     grayscale_stream >> grayscale_axis_pkt;
 
-    // Compute the monochrome value, and send the value downstream
+    // Compute the monochrome value of each pixel, and send them downstream
     monochrome_axis_t monochrome_axis_pkt;
-    monochrome_axis_pkt.tdata = compute_monochrome(grayscale_axis_pkt.tdata);
+    monochrome_lane_loop: for (int i = 0; i < PIXELS_PER_BEAT; i++) {
+    #pragma HLS UNROLL
+        monochrome_axis_pkt.tdata[i] = compute_monochrome(
+                grayscale_axis_pkt.tdata[i], threshold);
+    }
 
     /* Our transfers are always aligned, so set tkeep to -1, and assert
      * tlast when we reach the last packet. */
@@ -0,0 +1,38 @@
+/**
+ * @file roi_mask.cpp
+ * @date Monday, October 19, 2026 at 02:40:11 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the top function of the region-of-interest mask module.
+ *
+ * The module itself is templated on the size of the scale level, so it is
+ * entirely defined in its header.
+ *
+ * @bug No known bugs.
+ **/
+
+#include "image.h"                  // Definition of the image format
+#include "grayscale.h"              // Definition of the grayscale types
+#include "roi_mask.h"               // Our interface and ROI definitions
+
+/*----------------------------------------------------------------------------
+ * Top Function for Synthesis
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The top function for the ROI mask module when it is synthesized by itself.
+ *
+ * This is the function that HLS will look for if the ROI mask module is
+ * synthesized into its own IP block.
+ **/
+void roi_mask_top(const roi_skip_tiles_t skip_tiles,
+        grayscale_stream_t& grayscale_stream,
+        grayscale_stream_t& masked_stream) {
+#pragma HLS INTERFACE s_axilite port=skip_tiles
+#pragma HLS INTERFACE axis port=grayscale_stream
+#pragma HLS INTERFACE axis port=masked_stream
+
+    roi_mask<IMAGE_WIDTH, IMAGE_HEIGHT, 1>(skip_tiles, 0, grayscale_stream,
+            masked_stream);
+    return;
+}
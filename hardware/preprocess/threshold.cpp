@@ -0,0 +1,74 @@
+/**
+ * @file threshold.cpp
+ * @date Tuesday, October 27, 2026 at 03:08:14 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of the adaptive threshold module.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <ap_int.h>                 // Arbitrary precision integer types
+
+#include "grayscale.h"              // Definition of the grayscale types
+#include "threshold.h"              // Our interface and histogram definitions
+#include "image.h"                  // Definition of image info
+
+/*----------------------------------------------------------------------------
+ * Adaptive Threshold Module
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Computes the monochrome threshold from the histogram of a frame, by walking
+ * the bins from the brightest down, until the pixels at or above the bin would
+ * be more than 1 in 2^ADAPTIVE_SHIFT of the frame.
+ *
+ * This is the combinational interface to the module.
+ **/
+grayscale_t compute_threshold(const histogram_count_t histogram[HISTOGRAM_BINS],
+        histogram_count_t pixels) {
+#pragma HLS INLINE
+
+    histogram_count_t limit = pixels >> ADAPTIVE_SHIFT;
+    histogram_count_t brighter = 0;
+    ap_uint<COLOR_DEPTH+1> threshold = 0;
+    threshold_bin_loop: for (int bin = HISTOGRAM_BINS - 1; bin >= 0; bin--) {
+    #pragma HLS PIPELINE II=1
+        if (threshold == 0 && brighter + histogram[bin] > limit) {
+            threshold = bin + 1;
+        }
+        brighter += histogram[bin];
+    }
+
+    // The brightest bin alone may be too many pixels, so it stays set
+    if (threshold > HISTOGRAM_BINS - 1) {
+        threshold = HISTOGRAM_BINS - 1;
+    } else if (threshold < ADAPTIVE_MIN_THRESHOLD) {
+        threshold = ADAPTIVE_MIN_THRESHOLD;
+    }
+    return threshold;
+}
+
+/*----------------------------------------------------------------------------
+ * Top Function for Synthesis
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The top function for the adaptive threshold module when it is synthesized by
+ * itself, with a single threshold stream.
+ *
+ * This is the function that HLS will look for if the adaptive threshold module
+ * is synthesized into its own IP block.
+ **/
+void adaptive_threshold_top(grayscale_stream_t& input,
+        grayscale_stream_t& output, threshold_stream_t& threshold) {
+#pragma HLS INTERFACE axis port=input
+#pragma HLS INTERFACE axis port=output
+#pragma HLS INTERFACE axis port=threshold
+
+    threshold_stream_t thresholds[1];
+    adaptive_threshold<IMAGE_WIDTH, IMAGE_HEIGHT, 1>(input, output,
+            thresholds);
+    threshold.write(thresholds[0].read());
+    return;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file threshold_testbench.cpp
+ * @date Tuesday, October 27, 2026 at 03:47:32 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the testbench for the adaptive threshold module.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <assert.h>                 // Assert macro
+#include <stdio.h>                  // Printf function
+#include <stdlib.h>                 // Random number generator
+
+#include <algorithm>                // Max function
+
+#include "grayscale.h"              // Definition of the grayscale types
+#include "threshold.h"              // Adaptive threshold interface
+
+// The size of the test frames, which are a few beats wide at any beat width
+static const int TEST_WIDTH = 32;
+static const int TEST_HEIGHT = 16;
+static const int TEST_PIXELS = TEST_WIDTH * TEST_HEIGHT;
+
+// The number of monochrome stages the threshold is sent to
+static const int TEST_STAGES = 2;
+
+/* Streams a frame through the module, checking that it is forwarded as is,
+ * and returns the threshold that was sent for it. */
+static int run_frame(const int frame[TEST_PIXELS])
+{
+    grayscale_stream_t input, output;
+    threshold_stream_t thresholds[TEST_STAGES];
+    for (int i = 0; i < TEST_PIXELS; i += PIXELS_PER_BEAT) {
+        grayscale_axis_t pkt;
+        for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+            pkt.tdata[lane] = frame[i + lane];
+        }
+        pkt.tkeep = -1;
+        pkt.tlast = (i + PIXELS_PER_BEAT == TEST_PIXELS);
+        input << pkt;
+    }
+
+    adaptive_threshold<TEST_WIDTH, TEST_HEIGHT, TEST_STAGES>(input, output,
+            thresholds);
+    for (int i = 0; i < TEST_PIXELS; i += PIXELS_PER_BEAT) {
+        grayscale_axis_t pkt;
+        output >> pkt;
+        for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+            assert(pkt.tdata[lane].to_int() == frame[i + lane]);
+        }
+        assert(pkt.tlast.to_int() == (i + PIXELS_PER_BEAT == TEST_PIXELS));
+    }
+    assert(input.empty() && output.empty());
+
+    // Every stage gets the same threshold
+    int threshold = thresholds[0].read().to_int();
+    for (int i = 1; i < TEST_STAGES; i++) {
+        assert(thresholds[i].read().to_int() == threshold);
+    }
+    return threshold;
+}
+
+int main()
+{
+    // The threshold keeps the brightest pixels, within the bounds
+    static histogram_count_t histogram[HISTOGRAM_BINS];
+    histogram[0] = 1 << 16;
+    assert(compute_threshold(histogram, 1 << 16) == ADAPTIVE_MIN_THRESHOLD);
+    histogram[0] = 0;
+    histogram[200] = (1 << 16) - 256;
+    histogram[255] = 256;
+    assert(compute_threshold(histogram, 1 << 16).to_int() == 201);
+    histogram[255] = 257;
+    assert(compute_threshold(histogram, 1 << 16).to_int() == 255);
+
+    /* A frame of random values, with a few bright pixels, then a frame of a
+     * single value, which is counted as one long run in every lane. */
+    int frame[TEST_PIXELS];
+    int counts[HISTOGRAM_BINS] = {0};
+    srand(0);
+    for (int i = 0; i < TEST_PIXELS; i++) {
+        frame[i] = (i % 97 == 0) ? 250 : rand() % 200;
+        counts[frame[i]]++;
+    }
+    int limit = TEST_PIXELS >> ADAPTIVE_SHIFT;
+    int expected = 0;
+    for (int bin = HISTOGRAM_BINS - 1, brighter = 0; expected == 0; bin--) {
+        brighter += counts[bin];
+        expected = (brighter > limit) ? bin + 1 : 0;
+    }
+    expected = std::max(expected, ADAPTIVE_MIN_THRESHOLD.to_int());
+
+    // Each frame's threshold comes from the frame before it
+    assert(run_frame(frame) == MONOCHROME_THRESHOLD);
+    int uniform[TEST_PIXELS];
+    for (int i = 0; i < TEST_PIXELS; i++) {
+        uniform[i] = 240;
+    }
+    assert(run_frame(uniform) == expected);
+    assert(run_frame(frame) == 241);
+    assert(run_frame(frame) == expected);
+
+    printf("Adaptive threshold testbench passed.\n");
+    return 0;
+}
@@ -0,0 +1,302 @@
+/**
+ * @file ap_fixed.h
+ * @date Tuesday, October 20, 2026 at 03:58:31 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains a replacement for Vivado HLS's arbitrary precision fixed
+ * point types, ap_fixed and ap_ufixed, for building the hardware sources with a
+ * plain C++ compiler.
+ *
+ * Only the subset of the types that the hardware sources use is provided, for
+ * widths up to 64 bits, and with at least as many total bits as integer bits.
+ * A value is stored as a native integer holding the value scaled by 2^(W-I).
+ * Conversions quantize using the type's quantization mode (truncation towards
+ * negative infinity or rounding half up are supported), and handle overflow
+ * with its overflow mode (wrapping or saturation are supported).
+ *
+ * Unlike Vivado, arithmetic between two fixed point values has the type of the
+ * values, rather than a wider type that holds the exact result, so operands of
+ * an expression must have the same type. This gives the same results as Vivado
+ * for the common case of accumulating into a variable of that type.
+ *
+ * This file must never be used for synthesis.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef AP_FIXED_SIM_H_
+#define AP_FIXED_SIM_H_
+
+#ifdef __SYNTHESIS__
+#error "The simulation ap_fixed.h cannot be used for synthesis."
+#endif /* __SYNTHESIS__ */
+
+#include <math.h>               // Floor and scaling functions
+#include <stdint.h>             // Fixed-size integer types
+
+#include "ap_int.h"             // Arbitrary precision integer types
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The quantization modes of a fixed point type, which determine how values are
+ * rounded to the fractional precision of the type. Only AP_TRN and AP_RND are
+ * supported.
+ **/
+enum ap_q_mode {
+    AP_RND,                     // Round to plus infinity
+    AP_RND_ZERO,                // Round to zero
+    AP_RND_MIN_INF,             // Round to minus infinity
+    AP_RND_INF,                 // Round to infinity
+    AP_RND_CONV,                // Convergent rounding
+    AP_TRN,                     // Truncate towards minus infinity
+    AP_TRN_ZERO,                // Truncate towards zero
+};
+
+/**
+ * The overflow modes of a fixed point type, which determine how values outside
+ * of the type's range are handled. Only AP_WRAP and AP_SAT are supported.
+ **/
+enum ap_o_mode {
+    AP_SAT,                     // Saturate to the minimum or maximum value
+    AP_SAT_ZERO,                // Set to zero on overflow
+    AP_SAT_SYM,                 // Saturate symmetrically
+    AP_WRAP,                    // Wrap around
+    AP_WRAP_SM,                 // Sign-magnitude wrap around
+};
+
+/*----------------------------------------------------------------------------
+ * Arbitrary Precision Fixed Point Base Class
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The common implementation of a W-bit arbitrary precision fixed point value,
+ * either signed or unsigned.
+ *
+ * @tparam W The total width of the value, in bits.
+ * @tparam I The number of integer bits of the value, including the sign bit.
+ * @tparam S True if the value is signed, false if it is unsigned.
+ * @tparam Q The quantization mode of the value.
+ * @tparam O The overflow mode of the value.
+ **/
+template <int W, int I, bool S, ap_q_mode Q, ap_o_mode O>
+class ap_fixed_base {
+public:
+    static_assert(W >= 1 && W <= AP_INT_MAX_WIDTH && I <= W,
+            "Simulation ap_fixed supports widths up to 64 bits, with I <= W.");
+    static_assert(Q == AP_TRN || Q == AP_RND,
+            "Simulation ap_fixed only supports AP_TRN and AP_RND.");
+    static_assert(O == AP_WRAP || O == AP_SAT,
+            "Simulation ap_fixed only supports AP_WRAP and AP_SAT.");
+
+    // The number of fractional bits of the value
+    static const int F = W - I;
+
+    // Default constructor, zero-initialized so C-simulation is deterministic
+    ap_fixed_base() : raw(0) {}
+
+    // Constructors from the native floating point types, quantizing the value
+    ap_fixed_base(double value) {
+        double scaled = ldexp(value, F);
+        scaled = (Q == AP_RND) ? floor(scaled + 0.5) : floor(scaled);
+        assign_wide((fabs(scaled) < ldexp(1.0, 126)) ? (__int128)scaled :
+                (scaled < 0) ? -((__int128)1 << 126) : ((__int128)1 << 126));
+    }
+
+    ap_fixed_base(float value) {
+        *this = ap_fixed_base((double)value);
+    }
+
+    // Constructors from the native integer types, which need no quantization
+#define AP_FIXED_INTEGER_CONSTRUCTOR(type)                                    \
+    ap_fixed_base(type value) {                                               \
+        assign_wide((__int128)value << F);                                    \
+    }
+
+    AP_FIXED_INTEGER_CONSTRUCTOR(bool)
+    AP_FIXED_INTEGER_CONSTRUCTOR(char)
+    AP_FIXED_INTEGER_CONSTRUCTOR(signed char)
+    AP_FIXED_INTEGER_CONSTRUCTOR(unsigned char)
+    AP_FIXED_INTEGER_CONSTRUCTOR(short)
+    AP_FIXED_INTEGER_CONSTRUCTOR(unsigned short)
+    AP_FIXED_INTEGER_CONSTRUCTOR(int)
+    AP_FIXED_INTEGER_CONSTRUCTOR(unsigned int)
+    AP_FIXED_INTEGER_CONSTRUCTOR(long)
+    AP_FIXED_INTEGER_CONSTRUCTOR(unsigned long)
+    AP_FIXED_INTEGER_CONSTRUCTOR(long long)
+    AP_FIXED_INTEGER_CONSTRUCTOR(unsigned long long)
+
+#undef AP_FIXED_INTEGER_CONSTRUCTOR
+
+    // Constructor from an arbitrary precision integer
+    template <int W2, bool S2>
+    ap_fixed_base(const ap_int_base<W2, S2>& value) {
+        *this = ap_fixed_base(value.to_int64());
+    }
+
+    // Constructs a value from its raw bits, the value scaled by 2^F
+    static ap_fixed_base from_raw(int64_t bits) {
+        ap_fixed_base result;
+        result.assign(bits);
+        return result;
+    }
+
+    /*------------------------------------------------------------------------
+     * Conversions
+     *------------------------------------------------------------------------*/
+
+    // Returns the raw bits of the value, the value scaled by 2^F
+    int64_t to_raw() const {
+        return raw;
+    }
+
+    double to_double() const {
+        return ldexp((double)raw, -F);
+    }
+
+    float to_float() const {
+        return (float)to_double();
+    }
+
+    // Returns the integer part of the value, truncated towards zero
+    int to_int() const {
+        return (int)to_int64();
+    }
+
+    int64_t to_int64() const {
+        return (raw < 0) ? -(-raw >> F) : (raw >> F);
+    }
+
+    /*------------------------------------------------------------------------
+     * Operators
+     *------------------------------------------------------------------------*/
+
+    ap_fixed_base& operator+=(const ap_fixed_base& other) {
+        assign(raw + other.raw);
+        return *this;
+    }
+
+    ap_fixed_base& operator-=(const ap_fixed_base& other) {
+        assign(raw - other.raw);
+        return *this;
+    }
+
+    // Multiplication quantizes the exact product back to F fractional bits
+    ap_fixed_base& operator*=(const ap_fixed_base& other) {
+        __int128 product = (__int128)raw * other.raw;
+        if (Q == AP_RND && F > 0) {
+            product += (__int128)1 << (F > 0 ? F - 1 : 0);
+        }
+        assign_wide(product >> F);
+        return *this;
+    }
+
+    ap_fixed_base operator-() const {
+        return from_raw(-raw);
+    }
+
+    friend ap_fixed_base operator+(ap_fixed_base a, const ap_fixed_base& b) {
+        return a += b;
+    }
+
+    friend ap_fixed_base operator-(ap_fixed_base a, const ap_fixed_base& b) {
+        return a -= b;
+    }
+
+    friend ap_fixed_base operator*(ap_fixed_base a, const ap_fixed_base& b) {
+        return a *= b;
+    }
+
+    friend bool operator==(const ap_fixed_base& a, const ap_fixed_base& b) {
+        return a.raw == b.raw;
+    }
+
+    friend bool operator!=(const ap_fixed_base& a, const ap_fixed_base& b) {
+        return a.raw != b.raw;
+    }
+
+    friend bool operator<(const ap_fixed_base& a, const ap_fixed_base& b) {
+        return a.raw < b.raw;
+    }
+
+    friend bool operator<=(const ap_fixed_base& a, const ap_fixed_base& b) {
+        return a.raw <= b.raw;
+    }
+
+    friend bool operator>(const ap_fixed_base& a, const ap_fixed_base& b) {
+        return a.raw > b.raw;
+    }
+
+    friend bool operator>=(const ap_fixed_base& a, const ap_fixed_base& b) {
+        return a.raw >= b.raw;
+    }
+
+private:
+    int64_t raw;                        // The value scaled by 2^F
+
+    // The range of raw values that the type can represent
+    static int64_t min_raw() {
+        return S ? -(int64_t)(((uint64_t)1 << (W - 1))) : 0;
+    }
+
+    static int64_t max_raw() {
+        return (int64_t)((~(uint64_t)0) >> (64 - W + (S ? 1 : 0)));
+    }
+
+    // Stores the raw value, handling overflow with the overflow mode
+    void assign(int64_t value) {
+        static const int UNUSED_BITS = 64 - W;
+        if (O == AP_SAT) {
+            raw = (value < min_raw()) ? min_raw() :
+                    (value > max_raw()) ? max_raw() : value;
+        } else if (S) {
+            raw = (int64_t)((uint64_t)value << UNUSED_BITS) >> UNUSED_BITS;
+        } else {
+            raw = (int64_t)(((uint64_t)value << UNUSED_BITS) >> UNUSED_BITS);
+        }
+    }
+
+    /* Stores a raw value that may not fit in 64 bits, which is the case for
+     * conversions and products, saturating it first if needed. */
+    void assign_wide(__int128 value) {
+        if (O == AP_SAT && value < min_raw()) {
+            raw = min_raw();
+        } else if (O == AP_SAT && value > max_raw()) {
+            raw = max_raw();
+        } else {
+            assign((int64_t)(uint64_t)value);
+        }
+    }
+};
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * A W-bit signed fixed point value, with I integer bits.
+ **/
+template <int W, int I, ap_q_mode Q=AP_TRN, ap_o_mode O=AP_WRAP, int N=0>
+class ap_fixed : public ap_fixed_base<W, I, true, Q, O> {
+public:
+    ap_fixed() {}
+
+    template <typename T>
+    ap_fixed(const T& value) : ap_fixed_base<W, I, true, Q, O>(value) {}
+};
+
+/**
+ * A W-bit unsigned fixed point value, with I integer bits.
+ **/
+template <int W, int I, ap_q_mode Q=AP_TRN, ap_o_mode O=AP_WRAP, int N=0>
+class ap_ufixed : public ap_fixed_base<W, I, false, Q, O> {
+public:
+    ap_ufixed() {}
+
+    template <typename T>
+    ap_ufixed(const T& value) : ap_fixed_base<W, I, false, Q, O>(value) {}
+};
+
+#endif /* AP_FIXED_SIM_H_ */
@@ -0,0 +1,370 @@
+/**
+ * @file ap_int.h
+ * @date Tuesday, October 20, 2026 at 03:12:08 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains a replacement for Vivado HLS's arbitrary precision integer
+ * types, ap_int and ap_uint, for building the hardware sources with a plain C++
+ * compiler.
+ *
+ * Only the subset of the types that the hardware sources use is provided, for
+ * widths up to 64 bits. Each value is stored in the smallest native integer
+ * type that holds it, and is wrapped (truncated or sign-extended) to its width
+ * on every assignment, so arrays of these types are as compact as the native
+ * ones, and loops over them can be vectorized by the compiler.
+ *
+ * Values convert implicitly to a native integer type wide enough to hold any
+ * value of the type, so arithmetic and comparisons use the native operators,
+ * and have the same results as Vivado's full-precision operators. Like Vivado,
+ * shifts and bitwise inversion return the type of their operand, so bits
+ * shifted past the width are lost.
+ *
+ * To use it, put the hardware/sim directory on the include path ahead of the
+ * Vivado headers, e.g.:
+ *      g++ -O3 -Ihardware/sim -Ihardware/include hardware/preprocess/...
+ * This file must never be used for synthesis.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef AP_INT_SIM_H_
+#define AP_INT_SIM_H_
+
+#ifdef __SYNTHESIS__
+#error "The simulation ap_int.h cannot be used for synthesis."
+#endif /* __SYNTHESIS__ */
+
+#include <stddef.h>             // Definition of size_t
+#include <stdint.h>             // Fixed-size integer types
+#include <stdio.h>              // Standard I/O library, for the testbenches
+
+#include <type_traits>          // Conditional type selection
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The widest arbitrary precision integer that is supported
+static const int AP_INT_MAX_WIDTH = 64;
+
+/**
+ * Selects the smallest native integer type that can store a W-bit integer with
+ * the given signedness, and the native type that values of the integer are
+ * converted to for arithmetic. The arithmetic type is signed whenever it is
+ * wide enough, so that mixing unsigned values with negative ones works.
+ **/
+template <int W, bool S>
+struct ap_native_type {
+    typedef typename std::conditional<W <= 8,
+                typename std::conditional<S, int8_t, uint8_t>::type,
+            typename std::conditional<W <= 16,
+                typename std::conditional<S, int16_t, uint16_t>::type,
+            typename std::conditional<W <= 32,
+                typename std::conditional<S, int32_t, uint32_t>::type,
+                typename std::conditional<S, int64_t, uint64_t>::type
+            >::type>::type>::type storage_t;
+
+    // An unsigned 64-bit value has no wider signed type, so it stays unsigned
+    typedef typename std::conditional<(S ? W <= 32 : W < 32), int,
+            typename std::conditional<(!S && W == 64), uint64_t, int64_t
+            >::type>::type value_t;
+};
+
+/*----------------------------------------------------------------------------
+ * Arbitrary Precision Integer Base Class
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The common implementation of a W-bit arbitrary precision integer, either
+ * signed or unsigned.
+ *
+ * @tparam W The width of the integer, in bits.
+ * @tparam S True if the integer is signed, false if it is unsigned.
+ **/
+template <int W, bool S>
+class ap_int_base {
+public:
+    static_assert(W >= 1 && W <= AP_INT_MAX_WIDTH,
+            "Simulation ap_int only supports widths from 1 to 64 bits.");
+
+    typedef typename ap_native_type<W, S>::storage_t storage_t;
+    typedef typename ap_native_type<W, S>::value_t value_t;
+
+    // Reference to a single bit of the integer, which can be assigned
+    class bit_ref {
+    public:
+        bit_ref(ap_int_base& ref, int index) : ref(ref), index(index) {}
+
+        operator bool() const {
+            return ref.test(index);
+        }
+
+        bit_ref& operator=(bool bit) {
+            uint64_t mask = (uint64_t)1 << index;
+            ref.assign(bit ? (ref.bits() | mask) : (ref.bits() & ~mask));
+            return *this;
+        }
+
+        bit_ref& operator=(const bit_ref& other) {
+            return *this = (bool)other;
+        }
+
+    private:
+        ap_int_base& ref;               // The integer the bit belongs to
+        int index;                      // The index of the bit
+    };
+
+    // Reference to a range of bits [high, low] of the integer
+    class range_ref {
+    public:
+        range_ref(ap_int_base& ref, int high, int low) : ref(ref), high(high),
+                low(low) {}
+
+        operator uint64_t() const {
+            return (ref.bits() >> low) & mask();
+        }
+
+        range_ref& operator=(uint64_t value) {
+            uint64_t field = mask() << low;
+            ref.assign((ref.bits() & ~field) | ((value << low) & field));
+            return *this;
+        }
+
+        range_ref& operator=(const range_ref& other) {
+            return *this = (uint64_t)other;
+        }
+
+    private:
+        ap_int_base& ref;               // The integer the range belongs to
+        int high;                       // The index of the range's top bit
+        int low;                        // The index of the range's bottom bit
+
+        uint64_t mask() const {
+            int width = high - low + 1;
+            return (width >= 64) ? ~(uint64_t)0 : ((uint64_t)1 << width) - 1;
+        }
+    };
+
+    /* Default constructor, zero-initialized so C-simulation is deterministic.
+     * The constructors are constexpr, so that large constant tables of these
+     * types, such as test vectors, are initialized at compile time. */
+    constexpr ap_int_base() : val(0) {}
+
+    // Constructors from the native types, truncating the value to W bits
+#define AP_INT_NATIVE_CONSTRUCTOR(type)                                       \
+    constexpr ap_int_base(type value) : val(wrap((uint64_t)(int64_t)value)) {}
+
+    AP_INT_NATIVE_CONSTRUCTOR(bool)
+    AP_INT_NATIVE_CONSTRUCTOR(char)
+    AP_INT_NATIVE_CONSTRUCTOR(signed char)
+    AP_INT_NATIVE_CONSTRUCTOR(unsigned char)
+    AP_INT_NATIVE_CONSTRUCTOR(short)
+    AP_INT_NATIVE_CONSTRUCTOR(unsigned short)
+    AP_INT_NATIVE_CONSTRUCTOR(int)
+    AP_INT_NATIVE_CONSTRUCTOR(unsigned int)
+    AP_INT_NATIVE_CONSTRUCTOR(long)
+    AP_INT_NATIVE_CONSTRUCTOR(unsigned long)
+    AP_INT_NATIVE_CONSTRUCTOR(long long)
+    AP_INT_NATIVE_CONSTRUCTOR(unsigned long long)
+    AP_INT_NATIVE_CONSTRUCTOR(float)
+    AP_INT_NATIVE_CONSTRUCTOR(double)
+
+#undef AP_INT_NATIVE_CONSTRUCTOR
+
+    // Constructor from another arbitrary precision integer
+    template <int W2, bool S2>
+    constexpr ap_int_base(const ap_int_base<W2, S2>& other) :
+            val(wrap(other.bits())) {}
+
+    /*------------------------------------------------------------------------
+     * Conversions
+     *------------------------------------------------------------------------*/
+
+    // Implicit conversion to a native integer that holds every value
+    constexpr operator value_t() const {
+        return (value_t)val;
+    }
+
+    int to_int() const {
+        return (int)val;
+    }
+
+    unsigned to_uint() const {
+        return (unsigned)val;
+    }
+
+    int64_t to_int64() const {
+        return (int64_t)val;
+    }
+
+    uint64_t to_uint64() const {
+        return (uint64_t)val;
+    }
+
+    bool to_bool() const {
+        return val != 0;
+    }
+
+    // Returns the width of the integer
+    int length() const {
+        return W;
+    }
+
+    /* Returns the value as 64 bits, sign-extended if the integer is signed,
+     * and zero-extended otherwise. */
+    constexpr uint64_t bits() const {
+        return (uint64_t)(int64_t)val;
+    }
+
+    /*------------------------------------------------------------------------
+     * Bit Access
+     *------------------------------------------------------------------------*/
+
+    bool test(int index) const {
+        return (bits() >> index) & 1;
+    }
+
+    bool operator[](int index) const {
+        return test(index);
+    }
+
+    bit_ref operator[](int index) {
+        return bit_ref(*this, index);
+    }
+
+    uint64_t range(int high, int low) const {
+        return (uint64_t)range_ref(const_cast<ap_int_base&>(*this), high, low);
+    }
+
+    range_ref range(int high, int low) {
+        return range_ref(*this, high, low);
+    }
+
+    uint64_t operator()(int high, int low) const {
+        return range(high, low);
+    }
+
+    range_ref operator()(int high, int low) {
+        return range(high, low);
+    }
+
+    /*------------------------------------------------------------------------
+     * Operators
+     *------------------------------------------------------------------------*/
+
+    /* Shifts keep the width of the integer, so bits shifted past the top are
+     * lost, as they are with Vivado's types. */
+    ap_int_base operator<<(int shift) const {
+        ap_int_base result;
+        result.assign((shift >= W) ? 0 : (bits() << shift));
+        return result;
+    }
+
+    ap_int_base operator>>(int shift) const {
+        ap_int_base result;
+        if (S) {
+            result.assign((uint64_t)((int64_t)bits() >> (shift >= 64 ? 63 :
+                    shift)));
+        } else {
+            result.assign((shift >= 64) ? 0 : (bits() >> shift));
+        }
+        return result;
+    }
+
+    ap_int_base operator~() const {
+        ap_int_base result;
+        result.assign(~bits());
+        return result;
+    }
+
+    // Compound assignments, which wrap the result to W bits
+#define AP_INT_COMPOUND_ASSIGNMENT(op)                                        \
+    template <typename T>                                                     \
+    ap_int_base& operator op##=(const T& other) {                             \
+        assign((uint64_t)(int64_t)((value_t)val op other));                   \
+        return *this;                                                         \
+    }
+
+    AP_INT_COMPOUND_ASSIGNMENT(+)
+    AP_INT_COMPOUND_ASSIGNMENT(-)
+    AP_INT_COMPOUND_ASSIGNMENT(*)
+    AP_INT_COMPOUND_ASSIGNMENT(/)
+    AP_INT_COMPOUND_ASSIGNMENT(%)
+    AP_INT_COMPOUND_ASSIGNMENT(&)
+    AP_INT_COMPOUND_ASSIGNMENT(|)
+    AP_INT_COMPOUND_ASSIGNMENT(^)
+
+#undef AP_INT_COMPOUND_ASSIGNMENT
+
+    ap_int_base& operator<<=(int shift) {
+        return *this = *this << shift;
+    }
+
+    ap_int_base& operator>>=(int shift) {
+        return *this = *this >> shift;
+    }
+
+    ap_int_base& operator++() {
+        return *this += 1;
+    }
+
+    ap_int_base& operator--() {
+        return *this -= 1;
+    }
+
+    ap_int_base operator++(int) {
+        ap_int_base old = *this;
+        *this += 1;
+        return old;
+    }
+
+    ap_int_base operator--(int) {
+        ap_int_base old = *this;
+        *this -= 1;
+        return old;
+    }
+
+private:
+    storage_t val;                      // The value, wrapped to W bits
+
+    // Returns the low W bits of the value, sign-extended if it is signed
+    static constexpr storage_t wrap(uint64_t value) {
+        return S ? (storage_t)((int64_t)(value << (64 - W)) >> (64 - W)) :
+                (storage_t)((value << (64 - W)) >> (64 - W));
+    }
+
+    // Stores the low W bits of the value
+    void assign(uint64_t value) {
+        val = wrap(value);
+    }
+};
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * A W-bit signed arbitrary precision integer.
+ **/
+template <int W>
+class ap_int : public ap_int_base<W, true> {
+public:
+    constexpr ap_int() {}
+
+    template <typename T>
+    constexpr ap_int(const T& value) : ap_int_base<W, true>(value) {}
+};
+
+/**
+ * A W-bit unsigned arbitrary precision integer.
+ **/
+template <int W>
+class ap_uint : public ap_int_base<W, false> {
+public:
+    constexpr ap_uint() {}
+
+    template <typename T>
+    constexpr ap_uint(const T& value) : ap_int_base<W, false>(value) {}
+};
+
+#endif /* AP_INT_SIM_H_ */
@@ -0,0 +1,109 @@
+/**
+ * @file ap_int_test.cpp
+ * @date Tuesday, October 20, 2026 at 04:41:26 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for the simulation arbitrary precision integer
+ * and fixed point types.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+
+#include "ap_int.h"                 // Simulation integer types
+#include "ap_fixed.h"               // Simulation fixed point types
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+// Checks the wrapping, signedness, and bit access of the integer types
+static void test_ap_int()
+{
+    // Values are wrapped to the width of the type on assignment
+    ap_uint<8> u8 = 300;
+    assert(u8 == 44 && sizeof(u8) == 1);
+    ap_int<8> s8 = 200;
+    assert(s8 == -56);
+    ap_uint<1> bit = -1;
+    assert(bit == 1);
+    ap_uint<8> threshold = 0.85 * 255;
+    assert(threshold == 216);
+
+    // Arithmetic is done at full precision, like Vivado's types
+    ap_uint<8> a = 255, b = 255;
+    assert(a + b == 510);
+    ap_uint<4> zero = 0;
+    assert(zero - 1 == -1 && zero < 1 && -1 < zero);
+    ap_int<10> sum = a;
+    sum += b;
+    assert(sum == 510);
+    sum += 2;
+    assert(sum == -512);
+
+    // Conversion between types sign-extends signed values only
+    ap_int<16> coord = -1;
+    assert(ap_uint<16>(coord) == 0xFFFF && ap_int<32>(coord) == -1);
+    ap_uint<64> all_ones = coord;
+    assert(all_ones.to_uint64() == ~(uint64_t)0);
+
+    // Shifts keep the width of the type, and lose bits past the top
+    ap_int<16> y = 5;
+    assert((y << 48) == 0 && (y << 2) == 20);
+    assert((ap_int<64>(y) << 48) == (int64_t)5 << 48);
+    assert((coord >> 4) == -1 && (ap_uint<16>(coord) >> 4) == 0xFFF);
+    assert(~ap_uint<8>(0) == 255);
+
+    // Increments wrap around
+    ap_uint<3> counter = 7;
+    counter++;
+    assert(counter == 0);
+
+    // Bits and ranges can be read and assigned
+    ap_uint<32> word = 0;
+    word[3] = 1;
+    word.range(15, 8) = 0xAB;
+    assert(word == 0xAB08 && word[3] && !word[2]);
+    assert(word.range(15, 12) == 0xA);
+}
+
+// Checks the quantization and overflow of the fixed point types
+static void test_ap_fixed()
+{
+    typedef ap_fixed<16, 2> log_response_t;
+    typedef ap_fixed<16, 2, AP_RND> rounded_t;
+    typedef ap_fixed<8, 8> whole_t;
+    typedef ap_fixed<8, 4> half_t;
+
+    // Conversions truncate towards minus infinity by default
+    log_response_t weight = -0.0239;
+    assert(weight.to_raw() == -392);
+    log_response_t threshold = 0.490;
+    assert(threshold.to_raw() == 8028);
+    assert(log_response_t(-0.25 / 16384).to_raw() == -1);
+    assert(rounded_t(0.75 / 16384).to_raw() == 1);
+
+    // Sums wrap around on overflow by default, or saturate
+    log_response_t response = 1.5;
+    response += log_response_t(1.0);
+    assert(response.to_double() == -1.5);
+    ap_fixed<16, 2, AP_TRN, AP_SAT> saturated = 1.5;
+    saturated += 1.0;
+    assert(saturated.to_raw() == 0x7FFF);
+
+    // Comparisons and products work on the fixed point values
+    assert(threshold >= weight && !(weight >= threshold));
+    assert((threshold * log_response_t(0.5)).to_raw() == 8028 / 2);
+    assert(whole_t(-3.5).to_int() == -4 && half_t(-3.5).to_int() == -3);
+}
+
+int main()
+{
+    test_ap_int();
+    test_ap_fixed();
+
+    printf("AP types test passed.\n");
+    return 0;
+}
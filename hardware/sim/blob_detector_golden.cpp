@@ -0,0 +1,347 @@
+/**
+ * @file blob_detector_golden.cpp
+ * @date Wednesday, October 21, 2026 at 02:46:10 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the C-simulation harness that records the golden outputs
+ * of the hardware blob detector.
+ *
+ * The harness streams a raw image, in the pipeline's input format (RGBA, luma,
+ * or a Bayer mosaic, see image.h), through the hardware modules of each scale
+ * level (grayscale, ROI mask, monochrome, blob detection, and downscale), and
+ * writes the monochrome and detection masks of each level, along with the
+ * bounding boxes derived from the detections, to a golden file. The golden file
+ * can be compared against the host detector's and the MATLAB reference's with
+ * the golden_regression application. When built with ADAPTIVE_THRESHOLD
+ * defined, the levels are thresholded with the threshold computed from the
+ * image's own histogram.
+ *
+ * The modules are simulated level by level, rather than through the top-level
+ * blob_detector, so the outputs of each stage can be recorded. The image is
+ * then run through the top-level blob_detector as well, and its list of boxes
+ * must be the levels' boxes, in its order, or the harness fails. This checks
+ * what the levels leave out, the frame synchronization, the conversion from
+ * the input format, the adaptive threshold, and the combining of the levels'
+ * boxes. With the adaptive threshold, the image is run through it twice, since
+ * each frame's threshold comes from the frame before it.
+ *
+ * The image size is fixed at compile time, and the width and height must be
+ * multiples of the smallest scale level's factor. The harness does not model
+ * the filter bank. The pixels per beat can be set with BEAT_PIXELS, and the
+ * golden outputs should not change with it, e.g.:
+ *      g++ -O3 -DSIM_IMAGE_WIDTH=640 -DSIM_IMAGE_HEIGHT=480 -Isim -Iinclude \
+ *          -I../src sim/blob_detector_golden.cpp sim/blob_detector_top.cpp \
+ *          blob_detector.cpp preprocess/grayscale.cpp preprocess/bayer.cpp \
+ *          preprocess/monochrome.cpp preprocess/threshold.cpp \
+ *          preprocess/downscale.cpp blob_detection/blob_detection.cpp \
+ *          ../src/golden.cpp -o blob_detector_golden
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstdlib>                  // C standard library
+#include <cstdio>                   // C standard I/O library
+
+#include <vector>                   // Vector container
+#include <algorithm>                // Algorithms
+
+#include "image.h"                  // Definition of the image format
+#include "grayscale.h"              // Grayscale module
+#include "bayer.h"                  // Bayer demosaic module
+#include "threshold.h"              // Adaptive threshold module
+#include "roi_mask.h"               // Region of interest mask module
+#include "monochrome.h"             // Monochrome module
+#include "blob_detection.h"         // Blob detection module
+#include "downscale.h"              // Downscale module
+#include "golden.h"                 // Golden output files
+#include "blob_detector_top.h"      // Top-level blob detector
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The number of scale levels in the pyramid, matching the blob detector's
+static const int NUM_SCALES     = 5;
+
+// The scale factor of the smallest scale level
+static const int MAX_SCALE      = 1 << (NUM_SCALES - 1);
+
+static_assert(IMAGE_WIDTH % MAX_SCALE == 0 && IMAGE_HEIGHT % MAX_SCALE == 0,
+        "The image size must be a multiple of the smallest level's factor.");
+static_assert(IMAGE_WIDTH / MAX_SCALE % PIXELS_PER_BEAT == 0,
+        "The smallest level's width must be a multiple of the beat's pixels.");
+
+#ifdef BLOB_FILTER_BANK
+#error "The golden harness only models the single blob filter."
+#endif /* BLOB_FILTER_BANK */
+
+// The number of beats in the image, and the bytes of each pixel in the file
+static const int IMAGE_BEATS    = IMAGE_WIDTH * IMAGE_HEIGHT / PIXELS_PER_BEAT;
+#if defined(LUMA_INPUT) || defined(BAYER_INPUT)
+static const int PIXEL_BYTES    = 1;
+#else
+static const int PIXEL_BYTES    = NUM_COLOR_CHANNELS;
+#endif /* defined(LUMA_INPUT) || defined(BAYER_INPUT) */
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+static int read_image(const char *path, std::vector<uint8_t>& image)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        fprintf(stderr, "%s: Unable to open input image file.\n", path);
+        return -1;
+    }
+
+    size_t bytes_read = fread(image.data(), 1, image.size(), file);
+    fclose(file);
+    if (bytes_read != image.size()) {
+        fprintf(stderr, "%s: File size does not match input image's. "
+                "Expected %zu bytes, but read %zu.\n", path, image.size(),
+                bytes_read);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Streams the image in, in the pipeline's input format, like the processor
+static void stream_image(const std::vector<uint8_t>& image,
+        input_stream_t& input)
+{
+    for (int i = 0; i < IMAGE_BEATS; i++) {
+        input_axis_t pkt;
+        for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+            const uint8_t *pixel = &image[(i * PIXELS_PER_BEAT + lane) *
+                    PIXEL_BYTES];
+#if defined(LUMA_INPUT) || defined(BAYER_INPUT)
+            pkt.tdata[lane] = pixel[0];
+#else
+            pkt.tdata[lane] = pixel_t(pixel[0], pixel[1], pixel[2], pixel[3]);
+#endif /* defined(LUMA_INPUT) || defined(BAYER_INPUT) */
+        }
+        pkt.tlast = (i == IMAGE_BEATS - 1);
+        pkt.tkeep = -1;
+        input.write(pkt);
+    }
+}
+
+// Converts the image to grayscale, with the module for the input format
+static void image_to_grayscale(input_stream_t& input,
+        grayscale_stream_t& gray_image)
+{
+#if defined(BAYER_INPUT)
+    bayer_luma<IMAGE_WIDTH, IMAGE_HEIGHT>(input, gray_image);
+#else
+    for (int i = 0; i < IMAGE_BEATS; i++) {
+#if defined(LUMA_INPUT)
+        gray_image.write(input.read());
+#else
+        grayscale(input, gray_image);
+#endif /* defined(LUMA_INPUT) */
+    }
+#endif /* defined(BAYER_INPUT) */
+}
+
+/* Returns the monochrome threshold for the image. This is the default, unless
+ * the threshold is adaptive, in which case it is computed from the histogram
+ * of the image, passing the image through. */
+static grayscale_t image_threshold(grayscale_stream_t& gray_image,
+        grayscale_stream_t& output)
+{
+#ifdef ADAPTIVE_THRESHOLD
+    static histogram_count_t histogram[HISTOGRAM_BINS];
+    for (int i = 0; i < IMAGE_BEATS; i++) {
+        grayscale_axis_t pkt = gray_image.read();
+        for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+            histogram[pkt.tdata[lane]]++;
+        }
+        output.write(pkt);
+    }
+    return compute_threshold(histogram, IMAGE_WIDTH * IMAGE_HEIGHT);
+#else
+    for (int i = 0; i < IMAGE_BEATS; i++) {
+        output.write(gray_image.read());
+    }
+    return MONOCHROME_THRESHOLD;
+#endif /* ADAPTIVE_THRESHOLD */
+}
+
+/* Runs the image through the top-level blob detector, and checks that its
+ * boxes are the levels', in order from the finest level, up to the most it
+ * sends. */
+static int check_blob_detector(const std::vector<uint8_t>& image,
+        const golden_frame_t& frame)
+{
+    std::vector<int16_t> coords;
+#ifdef ADAPTIVE_THRESHOLD
+    // Run the image once first, so its threshold is measured from itself
+    input_stream_t first_input;
+    stream_image(image, first_input);
+    run_blob_detector(first_input, coords);
+#endif /* ADAPTIVE_THRESHOLD */
+    input_stream_t input;
+    stream_image(image, input);
+    run_blob_detector(input, coords);
+
+    std::vector<int16_t> expected;
+    for (size_t i = 0; i < frame.scales.size(); i++) {
+        const std::vector<bbox_t>& bboxes = frame.scales[i].bboxes;
+        for (size_t j = 0; j < bboxes.size(); j++) {
+            if (expected.size() < 4 * TOP_MAX_BBOXES) {
+                expected.push_back(bboxes[j].x1);
+                expected.push_back(bboxes[j].y1);
+                expected.push_back(bboxes[j].x2);
+                expected.push_back(bboxes[j].y2);
+            }
+        }
+    }
+
+    if (coords != expected) {
+        size_t length = std::min(coords.size(), expected.size());
+        size_t coord = std::mismatch(coords.begin(), coords.begin() + length,
+                expected.begin()).first - coords.begin();
+        fprintf(stderr, "The blob detector sent %zu boxes, where the levels "
+                "found %zu, and they differ from box %zu on.\n",
+                coords.size() / 4, expected.size() / 4, coord / 4);
+        return -1;
+    }
+
+    printf("The blob detector's %zu boxes match the levels'.\n",
+            coords.size() / 4);
+    return 0;
+}
+
+/* Runs the hardware modules for the given scale level on its grayscale image,
+ * recording their outputs in the golden frame, then has the next level
+ * downscale the image and carry on. */
+template <int LEVEL>
+struct scale_level {
+    static const int SCALE = 1 << LEVEL;
+    static const int WIDTH = IMAGE_WIDTH / SCALE;
+    static const int HEIGHT = IMAGE_HEIGHT / SCALE;
+    static const int BEATS = WIDTH * HEIGHT / PIXELS_PER_BEAT;
+
+    static void detect(grayscale_stream_t& image, grayscale_t threshold,
+            golden_frame_t& frame)
+    {
+        golden_scale_t& level = frame.scales[LEVEL];
+        roi_skip_tiles_t skip_tiles = {0};
+
+        // Duplicate the image, keeping a copy to downscale for the next level
+        grayscale_stream_t level_image, next_image;
+        for (int i = 0; i < BEATS; i++) {
+            grayscale_axis_t pkt = image.read();
+            level_image.write(pkt);
+            next_image.write(pkt);
+        }
+
+        // Convert the level to monochrome, and record the monochrome mask
+        grayscale_stream_t roi_image;
+        monochrome_stream_t mono_image, detection_input;
+        roi_mask<WIDTH, HEIGHT, SCALE>(skip_tiles, 0, level_image, roi_image);
+        for (int i = 0; i < BEATS; i++) {
+            monochrome(roi_image, mono_image, threshold);
+            monochrome_axis_t pkt = mono_image.read();
+            for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+                int pixel = i * PIXELS_PER_BEAT + lane;
+                if (pkt.tdata[lane]) {
+                    golden_set_pixel(level, level.mono, pixel % WIDTH,
+                            pixel / WIDTH);
+                }
+            }
+            detection_input.write(pkt);
+        }
+
+        /* Run blob detection on the level, and record the detections, along
+         * with their boxes in the original image, like blob_bounding_boxes. */
+        blob_detection_stream_t detections;
+        blob_detection<WIDTH, HEIGHT>(detection_input, detections);
+        int radius = SCALE * (BLOB_FILTER_WIDTH + 1) / 2;
+        for (int i = 0; i < BEATS; i++) {
+            blob_detection_beat_t beat = detections.read().tdata;
+            for (int lane = 0; lane < PIXELS_PER_BEAT; lane++) {
+                int cx = (i * PIXELS_PER_BEAT + lane) % WIDTH;
+                int cy = (i * PIXELS_PER_BEAT + lane) / WIDTH;
+                if (beat[lane]) {
+                    golden_set_pixel(level, level.detections, cx, cy);
+                    level.bboxes.push_back(bbox_t(SCALE * cx - radius,
+                            SCALE * cy - radius, SCALE * cx + radius,
+                            SCALE * cy + radius));
+                }
+            }
+        }
+
+        scale_level<LEVEL + 1>::template downscale_from<WIDTH, HEIGHT>(
+                next_image, threshold, frame);
+    }
+
+    // Downscales the previous level's image into this one, and runs it
+    template <int PREV_WIDTH, int PREV_HEIGHT>
+    static void downscale_from(grayscale_stream_t& image,
+            grayscale_t threshold, golden_frame_t& frame)
+    {
+        grayscale_stream_t downscaled;
+        downscale<PREV_WIDTH, PREV_HEIGHT>(image, downscaled);
+        detect(downscaled, threshold, frame);
+    }
+};
+
+/* The last scale level has already been handled, so drain the extra image,
+ * rather than downscaling it like the hardware never does. */
+template <>
+struct scale_level<NUM_SCALES> {
+    template <int PREV_WIDTH, int PREV_HEIGHT>
+    static void downscale_from(grayscale_stream_t& image,
+            grayscale_t threshold, golden_frame_t& frame)
+    {
+        (void)threshold;
+        (void)frame;
+        while (!image.empty()) {
+            image.read();
+        }
+    }
+};
+
+/*----------------------------------------------------------------------------
+ * Main Application
+ *----------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    if (argc != 3) {
+        printf("Usage: %s <image> <output.golden>\n", argv[0]);
+        printf("The image must be %dx%d raw pixels, in the input format.\n",
+                IMAGE_WIDTH, IMAGE_HEIGHT);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint8_t> image(IMAGE_WIDTH * IMAGE_HEIGHT * PIXEL_BYTES);
+    if (read_image(argv[1], image) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    // Stream the image through the grayscale module, and find its threshold
+    input_stream_t input;
+    grayscale_stream_t converted_image, gray_image;
+    stream_image(image, input);
+    image_to_grayscale(input, converted_image);
+    grayscale_t threshold = image_threshold(converted_image, gray_image);
+
+    golden_frame_t frame;
+    golden_init(frame, IMAGE_WIDTH, IMAGE_HEIGHT, NUM_SCALES, DOWNSCALE_FACTOR,
+            GOLDEN_MONO_PLANE | GOLDEN_DETECTION_PLANE);
+    scale_level<0>::detect(gray_image, threshold, frame);
+
+    // Check the top-level pipeline against the levels
+    if (check_blob_detector(image, frame) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    if (golden_write(frame, argv[2]) != 0) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,44 @@
+/**
+ * @file blob_detector_top.cpp
+ * @date Tuesday, November 03, 2026 at 10:31:05 AM EST
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the C-simulation of the top-level blob detector, for the
+ * golden harness.
+ *
+ * @bug No known bugs.
+ **/
+
+#include "blob_detector_top.h"      // Our interface
+#include "blob_detector.h"          // Blob detector interface
+
+static_assert(TOP_MAX_BBOXES == MAX_BBOXES,
+        "The harness must expect as many boxes as the blob detector sends.");
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+void run_blob_detector(input_stream_t& frame, std::vector<int16_t>& coords)
+{
+    roi_skip_tiles_t skip_tiles = {0};
+    bbox_stream_t blobs;
+#ifdef BLOB_DETECTOR_STATS
+    stats_stream_t stats;
+    blob_detector(frame, blobs, skip_tiles, stats);
+    while (!stats.empty()) {
+        stats.read();
+    }
+#else
+    blob_detector(frame, blobs, skip_tiles);
+#endif /* BLOB_DETECTOR_STATS */
+
+    coords.clear();
+    for (bbox_axis_t pkt = blobs.read(); !pkt.tlast; pkt = blobs.read()) {
+        coords.push_back(pkt.tdata.x1());
+        coords.push_back(pkt.tdata.y1());
+        coords.push_back(pkt.tdata.x2());
+        coords.push_back(pkt.tdata.y2());
+    }
+    return;
+}
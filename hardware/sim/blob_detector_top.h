@@ -0,0 +1,50 @@
+/**
+ * @file blob_detector_top.h
+ * @date Tuesday, November 03, 2026 at 10:12:48 AM EST
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the C-simulation of the top-level blob
+ * detector, for the golden harness.
+ *
+ * The harness records its golden outputs with the src directory's bounding
+ * box type, which clashes with the hardware's, so the top-level pipeline is
+ * run from its own translation unit, and its boxes are returned as plain
+ * coordinates.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef BLOB_DETECTOR_TOP_H_
+#define BLOB_DETECTOR_TOP_H_
+
+#include <stdint.h>                 // Fixed-size integer types
+
+#include <vector>                   // Vector container
+
+#include "grayscale.h"              // Definition of the input stream
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The most boxes the blob detector sends back for a frame, not counting the
+ * terminator, which is its MAX_BBOXES.
+ **/
+static const int TOP_MAX_BBOXES = 1023;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Runs a frame through the top-level blob detector, with every tile in the
+ * region of interest, and returns the boxes it sends back.
+ *
+ * @param[in] frame The stream of the frame's beats, with tlast on its last.
+ * @param[out] coords The boxes before the terminator, in the order they were
+ *                    sent, as the x1, y1, x2, and y2 coordinates of each.
+ **/
+void run_blob_detector(input_stream_t& frame, std::vector<int16_t>& coords);
+
+#endif /* BLOB_DETECTOR_TOP_H_ */
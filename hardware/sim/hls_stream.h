@@ -0,0 +1,217 @@
+/**
+ * @file hls_stream.h
+ * @date Tuesday, October 20, 2026 at 01:37:44 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains a drop-in replacement for Vivado HLS's hls::stream class,
+ * for fast C-simulation on the CPU.
+ *
+ * Vivado's implementation pushes every packet through a std::deque, which makes
+ * simulating a full-resolution frame take minutes. This implementation instead
+ * keeps the packets in a ring buffer that is allocated up front, and only grows
+ * (doubling in size) when a testbench queues up more than it holds. It also
+ * adds bulk read and write functions, which copy runs of packets at a time.
+ *
+ * To use it, put the hardware/sim directory on the include path ahead of the
+ * Vivado headers when compiling the hardware sources for the CPU. This file
+ * must never be used for synthesis.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef HLS_STREAM_SIM_H_
+#define HLS_STREAM_SIM_H_
+
+#ifdef __SYNTHESIS__
+#error "The simulation hls_stream.h cannot be used for synthesis."
+#endif /* __SYNTHESIS__ */
+
+#include <stddef.h>             // Definition of size_t
+#include <stdio.h>              // Standard I/O library
+
+#include <algorithm>            // Copy and min functions
+#include <string>               // String class
+#include <vector>               // Vector container
+
+namespace hls {
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The number of packets a stream can hold before it needs to grow. This is a
+ * power of two, and so is the stream's capacity after every time it grows.
+ **/
+static const size_t STREAM_DEFAULT_CAPACITY = 1024;
+
+/**
+ * A FIFO stream of packets, with the same interface as Vivado's hls::stream.
+ *
+ * @tparam T The type of the packets in the stream.
+ **/
+template <typename T>
+class stream {
+public:
+    // Default constructor
+    stream() {
+        init("hls::stream");
+    }
+
+    // Constructor with a name for the stream, used in warning messages
+    explicit stream(const char *name) {
+        init(name);
+    }
+
+    /*------------------------------------------------------------------------
+     * Vivado HLS Interface
+     *------------------------------------------------------------------------*/
+
+    // Returns true if the stream has no packets in it
+    bool empty() const {
+        return count == 0;
+    }
+
+    // Returns true if the stream is full, which never happens, as it grows
+    bool full() const {
+        return false;
+    }
+
+    // Returns the number of packets in the stream
+    size_t size() const {
+        return count;
+    }
+
+    /* Reads the next packet from the stream. Like Vivado's sequential
+     * C-simulation, reading an empty stream warns, and returns a default. */
+    T read() {
+        if (empty()) {
+            fprintf(stderr, "WARNING: Hls::stream '%s' is read while empty, "
+                    "which may result in RTL simulation hanging.\n",
+                    name.c_str());
+            return T();
+        }
+
+        T packet = buffer[head];
+        head = (head + 1) & (buffer.size() - 1);
+        count -= 1;
+        return packet;
+    }
+
+    // Reads the next packet from the stream into the given packet
+    void read(T& packet) {
+        packet = read();
+    }
+
+    // Reads the next packet if the stream is not empty, returning success
+    bool read_nb(T& packet) {
+        if (empty()) {
+            return false;
+        }
+
+        packet = read();
+        return true;
+    }
+
+    // Writes the packet to the end of the stream
+    void write(const T& packet) {
+        if (count == buffer.size()) {
+            grow(count + 1);
+        }
+
+        buffer[(head + count) & (buffer.size() - 1)] = packet;
+        count += 1;
+    }
+
+    // Writes the packet to the stream, which always succeeds
+    bool write_nb(const T& packet) {
+        write(packet);
+        return true;
+    }
+
+    // Operator aliases for reading and writing
+    void operator>>(T& packet) {
+        read(packet);
+    }
+
+    void operator<<(const T& packet) {
+        write(packet);
+    }
+
+    /*------------------------------------------------------------------------
+     * Bulk Interface (Simulation Only)
+     *------------------------------------------------------------------------*/
+
+    // Grows the stream so it can hold at least the given number of packets
+    void reserve(size_t capacity) {
+        if (capacity > buffer.size()) {
+            grow(capacity);
+        }
+    }
+
+    // Writes count packets from the array to the end of the stream
+    void write(const T *packets, size_t count) {
+        reserve(this->count + count);
+
+        // Copy the packets in at most two runs, around the end of the buffer
+        size_t tail = (head + this->count) & (buffer.size() - 1);
+        size_t first_run = std::min(count, buffer.size() - tail);
+        std::copy(packets, packets + first_run, &buffer[tail]);
+        std::copy(packets + first_run, packets + count, &buffer[0]);
+        this->count += count;
+    }
+
+    /* Reads up to count packets from the stream into the array, returning the
+     * number of packets read. */
+    size_t read(T *packets, size_t count) {
+        count = std::min(count, this->count);
+
+        // Copy the packets out in at most two runs, around the buffer's end
+        size_t first_run = std::min(count, buffer.size() - head);
+        std::copy(&buffer[head], &buffer[head] + first_run, packets);
+        std::copy(&buffer[0], &buffer[0] + (count - first_run),
+                packets + first_run);
+        head = (head + count) & (buffer.size() - 1);
+        this->count -= count;
+        return count;
+    }
+
+private:
+    std::vector<T> buffer;          // Ring buffer holding the packets
+    size_t head;                    // Index of the next packet to read
+    size_t count;                   // Number of packets in the stream
+    std::string name;               // Name of the stream
+
+    // Streams are connections between modules, so they cannot be copied
+    stream(const stream&);
+    stream& operator=(const stream&);
+
+    // Initializes the stream with the default capacity
+    void init(const char *name) {
+        this->name = name;
+        buffer.resize(STREAM_DEFAULT_CAPACITY);
+        head = 0;
+        count = 0;
+    }
+
+    // Grows the buffer to a power of two that holds the given number of packets
+    void grow(size_t capacity) {
+        size_t new_size = buffer.size();
+        while (new_size < capacity) {
+            new_size *= 2;
+        }
+
+        // Unwrap the packets into the start of the new buffer
+        std::vector<T> new_buffer(new_size);
+        size_t first_run = std::min(count, buffer.size() - head);
+        std::copy(&buffer[head], &buffer[head] + first_run, &new_buffer[0]);
+        std::copy(&buffer[0], &buffer[0] + (count - first_run),
+                &new_buffer[first_run]);
+        buffer.swap(new_buffer);
+        head = 0;
+    }
+};
+
+} /* namespace hls */
+
+#endif /* HLS_STREAM_SIM_H_ */
@@ -0,0 +1,71 @@
+/**
+ * @file hls_stream_test.cpp
+ * @date Tuesday, October 20, 2026 at 02:06:19 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for the simulation hls::stream replacement.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+
+#include <vector>                   // Vector container
+
+#include "hls_stream.h"             // Simulation stream definition
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The number of packets sent through the stream, enough to make it grow
+static const int NUM_PACKETS    = 10 * hls::STREAM_DEFAULT_CAPACITY + 7;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+int main()
+{
+    hls::stream<int> stream("test_stream");
+    assert(stream.empty() && stream.size() == 0);
+
+    // Offset the head, so that the writes below wrap around the buffer
+    for (int i = 0; i < 3; i++) {
+        stream << i;
+    }
+    int packet;
+    for (int i = 0; i < 3; i++) {
+        stream >> packet;
+        assert(packet == i);
+    }
+    assert(stream.empty() && !stream.read_nb(packet));
+
+    // Single packets come out in order, even after the stream grows
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        stream.write(i);
+    }
+    assert(stream.size() == (size_t)NUM_PACKETS);
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        assert(stream.read() == i);
+    }
+
+    // Bulk writes and reads interleave with single packets
+    std::vector<int> data(NUM_PACKETS);
+    std::vector<int> output(NUM_PACKETS);
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        data[i] = i;
+    }
+    stream.write(data.data(), 5);
+    stream.write(data[5]);
+    stream.write(data.data() + 6, data.size() - 6);
+    assert(stream.read() == 0);
+    assert(stream.read(output.data() + 1, 100) == 100);
+    assert(stream.read(output.data() + 101, data.size()) == data.size() - 101);
+    output[0] = 0;
+    assert(output == data && stream.empty());
+
+    printf("HLS stream test passed.\n");
+    return 0;
+}
@@ -0,0 +1,116 @@
+% export_golden.m
+%
+% Wednesday, October 21, 2026 at 04:12:37 PM EDT
+% Brandon Perez (bmperez)
+%
+% This script exports the outputs of the MATLAB blob detector to a golden file.
+%
+% This runs the same steps as the blob detector on a raw RGBA image, with the
+% headlight detection parameters, and writes the detections and bounding boxes
+% at each scale level to a golden file (see src/golden.h for the format). The
+% golden file can then be compared against the ones from the host detector and
+% the hardware C-simulation with the golden_regression application.
+%
+% The reference detects blobs on the grayscale image at the original scale, so
+% that level has no monochrome plane. The boxes are converted from MATLAB's
+% 1-based coordinates to the 0-based coordinates used by the other detectors.
+% The reference uses bicubic downscaling, floating point filtering, and zero
+% padding at the borders, so it is only expected to match within a tolerance.
+
+function [] = export_golden(rgba_file, width, height, golden_file)
+    % Get the static configuration parameters, matching the headlight test
+    [scale_factor, num_scales, monochrome_threshold, response_threshold, ...
+            blob_filter] = get_config();
+
+    % Load the raw RGBA image, which is stored row-major with red in the LSB
+    fid = fopen(rgba_file, 'r');
+    pixels = fread(fid, [4, width * height], 'uint8=>uint8');
+    fclose(fid);
+    image = permute(reshape(pixels(1:3, :), [3, width, height]), [3, 2, 1]);
+    gray_image = rgb2gray(im2double(image));
+
+    % Open the golden file, and write the header
+    fid = fopen(golden_file, 'w', 'ieee-le');
+    fwrite(fid, 'BDGF', 'char');
+    fwrite(fid, [1, num_scales], 'uint16');
+    fwrite(fid, [width, height], 'uint32');
+
+    % Perform blob detection at each scale, writing out the level's outputs
+    for scale_level = 0:num_scales-1
+        scale = scale_factor .^ scale_level;
+        if scale_level == 0
+            level_image = gray_image;
+            planes = 2;
+        else
+            % Scale the image down, and convert it to a monochrome image
+            resized_image = imresize(gray_image, 1 / scale, 'method', ...
+                    'bicubic');
+            monochrome_image = im2bw(resized_image, monochrome_threshold);
+            level_image = im2double(monochrome_image);
+            planes = 3;
+        end
+
+        % Apply the blob filter, and threshold the response
+        blob_responses = imfilter(level_image, blob_filter);
+        detections = blob_responses >= response_threshold;
+
+        % Write the level's header, and the planes it has
+        [level_height, level_width] = size(level_image);
+        fwrite(fid, [scale, planes], 'uint16');
+        fwrite(fid, [level_width, level_height], 'uint32');
+        if bitand(planes, 1)
+            write_plane(fid, level_image > 0);
+        end
+        write_plane(fid, detections);
+
+        % Compute the boxes in row-major order, in the original image with
+        % 0-based coordinates
+        [center_xs, center_ys] = find(detections');
+        box_radius = ceil(size(blob_filter, 2) / 2);
+        center_points = scale * ([center_xs'; center_ys'] - 1);
+        bounding_boxes = [center_points - scale * box_radius; ...
+                center_points + scale * box_radius];
+
+        fwrite(fid, size(bounding_boxes, 2), 'uint32');
+        fwrite(fid, bounding_boxes, 'int16');
+    end
+
+    fclose(fid);
+end
+
+function [] = write_plane(fid, mask)
+    % Pack the mask into 64-bit words, with the leftmost pixel in the LSB
+    word_bits = 64;
+    [height, width] = size(mask);
+    mask_words = ceil(width / word_bits);
+    words = zeros(mask_words * height, 1, 'uint64');
+    [ys, xs] = find(mask);
+    for i = 1:numel(xs)
+        index = (ys(i) - 1) * mask_words + floor((xs(i) - 1) / word_bits) + 1;
+        bit = bitshift(uint64(1), mod(xs(i) - 1, word_bits));
+        words(index) = bitor(words(index), bit);
+    end
+
+    % Only the nonzero words are stored, along with their index
+    indices = find(words);
+    fwrite(fid, numel(indices), 'uint32');
+    for i = 1:numel(indices)
+        fwrite(fid, indices(i) - 1, 'uint32');
+        fwrite(fid, words(indices(i)), 'uint64');
+    end
+end
+
+function [scale_factor, num_scales, monochrome_threshold, ...
+        response_threshold, blob_filter] = get_config()
+    % The same parameters as the headlight detection test
+    scale_factor = 2;
+    num_scales = 5;
+    max_grayscale = 255;
+    monochrome_threshold = 217 / max_grayscale;
+    response_threshold = 125 / max_grayscale;
+
+    % A 5x5 inverted Laplacian of Gaussian filter (LoG) with a sigma of 1
+    log_size = [5 5];
+    log_sigma = 1;
+    blob_filter = -fspecial('log', log_size, log_sigma);
+end
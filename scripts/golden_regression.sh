@@ -0,0 +1,77 @@
+# golden_regression.sh
+#
+# Date: Wednesday, October 21, 2026 at 05:03:48 PM EDT
+# Author: Brandon Perez (bmperez)
+#
+# Runs the golden regression tests over a corpus of raw RGBA images. The host
+# detector is checked against the golden files in the golden directory, which
+# are recorded with `golden_regression -u`. If the hardware C-simulation
+# harness (blob_detector_golden, built for the corpus's image size) and MATLAB
+# are available, their outputs are compared against the same golden files. The
+# host and the C-simulation must match bit-exactly, while the MATLAB reference
+# only has to match within a tolerance.
+#
+# The paths to the tools can be overridden with the GOLDEN_REGRESSION,
+# BLOB_DETECTOR_GOLDEN, and MATLAB environment variables.
+
+# Check that number of command line arguments matches
+num_args=$#
+if [ ${num_args} -lt 4 ]; then
+    printf "Error: Improper number of command line arguments.\n"
+    printf "Usage: golden_regression.sh <width> <height> <golden_dir> "
+    printf "<image> [image ...]\n"
+    exit 1
+fi
+
+# Parse the command line arguments
+width=$1
+height=$2
+golden_dir=$3
+shift 3
+
+# The tools used to run each implementation, and the MATLAB source directory
+golden_regression=${GOLDEN_REGRESSION:-./golden_regression}
+blob_detector_golden=${BLOB_DETECTOR_GOLDEN:-./blob_detector_golden}
+matlab=${MATLAB:-matlab}
+matlab_dir=$(cd "$(dirname "$0")/../matlab" && pwd)
+
+# The tolerance for the MATLAB reference: 5% of the mask pixels, boxes within
+# 32 pixels (two pixels at the smallest scale level), and 25% of the boxes
+# unmatched
+matlab_tolerance="-m 0.05 -b 32 -x 0.25"
+
+# Check the host detector against the golden files
+failures=0
+${golden_regression} ${width} ${height} ${golden_dir} "$@" || \
+        failures=$((failures + 1))
+
+# Check the other implementations, if they are available
+output_dir=$(mktemp -d)
+for image in "$@"; do
+    name=$(basename ${image})
+    golden=${golden_dir}/${name}.golden
+
+    if [ -x ${blob_detector_golden} ]; then
+        ${blob_detector_golden} ${image} ${output_dir}/${name}.hls.golden && \
+                ${golden_regression} -c ${golden} \
+                        ${output_dir}/${name}.hls.golden || \
+                failures=$((failures + 1))
+    fi
+
+    if command -v ${matlab} > /dev/null; then
+        ${matlab} -nodisplay -nosplash -r "addpath('${matlab_dir}'); \
+                export_golden('${image}', ${width}, ${height}, \
+                '${output_dir}/${name}.matlab.golden'); exit" > /dev/null && \
+                ${golden_regression} ${matlab_tolerance} -c ${golden} \
+                        ${output_dir}/${name}.matlab.golden || \
+                failures=$((failures + 1))
+    fi
+done
+rm -rf ${output_dir}
+
+# Report the number of failed comparisons
+if [ ${failures} -ne 0 ]; then
+    printf "\n%d comparisons failed.\n" ${failures}
+    exit 1
+fi
+printf "\nAll comparisons passed.\n"
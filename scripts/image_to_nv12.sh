@@ -0,0 +1,25 @@
+# image_to_nv12.sh
+#
+# Date: Monday, October 26, 2026 at 01:07:12 PM EDT
+# Author: Brandon Perez (bmperez)
+#
+# Converts a given image (e.g. PNG, JPG, etc.) to its raw NV12 format, creating
+# a new file. Raw NV12 is the format our cameras output, an 8-bit luma plane,
+# followed by a plane of interleaved 8-bit chroma samples at half the size in
+# each dimension. The detectors only read the luma plane.
+
+# Check that number of command line arguments matches
+num_args=$#
+if [ ${num_args} -ne 2 ]; then
+    printf "Error: Improper number of command line arguments.\n"
+    printf "Usage: image_to_nv12.sh <input_image> <output_image>\n"
+    exit 1
+fi
+
+# Parse the command line arguments
+input_image=$1
+output_image=$2
+
+# Convert the input image to a raw NV12 image
+ffmpeg -loglevel error -y -i ${input_image} -f rawvideo -pix_fmt nv12 \
+    ${output_image}
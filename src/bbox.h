@@ -0,0 +1,56 @@
+/**
+ * @file bbox.h
+ * @date Monday, October 19, 2026 at 10:20:05 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the definition of a bounding box.
+ *
+ * The layout of the bounding box matches the 64-bit packets that the hardware
+ * blob detector streams back to the processor: four 16-bit signed coordinates,
+ * (x1, y1, x2, y2), with x1 in the least significant bits. A list of bounding
+ * boxes is terminated with the box (-1, -1, -1, -1).
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef BBOX_H_
+#define BBOX_H_
+
+#include <stdint.h>             // Fixed-size integer types
+
+// The value of each coordinate in the terminator of a bounding box list
+static const int16_t BBOX_TERMINATOR_COORD = -1;
+
+typedef struct bounding_box {
+    int16_t x1;                 // Left edge of the box
+    int16_t y1;                 // Top edge of the box
+    int16_t x2;                 // Right edge of the box
+    int16_t y2;                 // Bottom edge of the box
+
+    // Default constructor for the bounding box
+    bounding_box() {}
+
+    // Constructor for the bounding box from its four corner coordinates
+    bounding_box(int x1, int y1, int x2, int y2) {
+        this->x1 = x1;
+        this->y1 = y1;
+        this->x2 = x2;
+        this->y2 = y2;
+    }
+
+    // Returns the box used to terminate a list of bounding boxes
+    static bounding_box terminator()
+    {
+        return bounding_box(BBOX_TERMINATOR_COORD, BBOX_TERMINATOR_COORD,
+                BBOX_TERMINATOR_COORD, BBOX_TERMINATOR_COORD);
+    }
+
+    // Returns true if this box is the terminator of a bounding box list
+    bool is_terminator() const
+    {
+        return x1 == BBOX_TERMINATOR_COORD && y1 == BBOX_TERMINATOR_COORD &&
+                x2 == BBOX_TERMINATOR_COORD && y2 == BBOX_TERMINATOR_COORD;
+    }
+} bbox_t;
+
+#endif /* BBOX_H_ */
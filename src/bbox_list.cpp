@@ -0,0 +1,212 @@
+/**
+ * @file bbox_list.cpp
+ * @date Saturday, October 24, 2026 at 10:41:20 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation for parsing and writing out the lists
+ * of bounding boxes returned by the hardware blob detector.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstdio>                   // C standard I/O library
+#include <cstring>                  // String and memory functions
+
+#include "bbox_list.h"              // Our interface
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The magic number and version at the start of a binary list
+static const char BBOX_LIST_MAGIC[4]    = {'B', 'D', 'B', 'L'};
+static const uint16_t BBOX_LIST_VERSION = 1;
+
+// The size of the header of a binary list
+static const size_t BINARY_HEADER_SIZE  = 12;
+
+// The header line of a CSV list
+static const char BBOX_CSV_HEADER[]     = "x1,y1,x2,y2\n";
+
+// The number of boxes written out in a single piece of a list
+static const int WRITE_BATCH_BBOXES     = 32;
+
+// The longest line of a CSV list, "-32768,-32768,-32768,-32768\n"
+static const int CSV_MAX_LINE           = 4 * 7;
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Stores an integer in little-endian order
+static void store_le(unsigned char *bytes, unsigned value, int size)
+{
+    for (int i = 0; i < size; i++) {
+        bytes[i] = (value >> (8 * i)) & 0xFF;
+    }
+}
+
+// Loads an integer stored in little-endian order
+static unsigned load_le(const unsigned char *bytes, int size)
+{
+    unsigned value = 0;
+    for (int i = 0; i < size; i++) {
+        value |= (unsigned)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+// Writes out the boxes as CSV, a batch of lines at a time
+static int write_csv(const bbox_t *bboxes, int num_bboxes, bbox_write_t write,
+        void *arg)
+{
+    if (write(BBOX_CSV_HEADER, sizeof(BBOX_CSV_HEADER) - 1, arg) != 0) {
+        return -1;
+    }
+
+    char text[WRITE_BATCH_BBOXES * CSV_MAX_LINE + 1];
+    for (int i = 0; i < num_bboxes; i += WRITE_BATCH_BBOXES) {
+        size_t len = 0;
+        for (int j = i; j < num_bboxes && j < i + WRITE_BATCH_BBOXES; j++) {
+            len += snprintf(&text[len], sizeof(text) - len, "%d,%d,%d,%d\n",
+                    bboxes[j].x1, bboxes[j].y1, bboxes[j].x2, bboxes[j].y2);
+        }
+        if (write(text, len, arg) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Writes out the boxes in the binary format
+static int write_binary(const bbox_t *bboxes, int num_bboxes,
+        bbox_write_t write, void *arg)
+{
+    unsigned char header[BINARY_HEADER_SIZE];
+    for (size_t i = 0; i < sizeof(BBOX_LIST_MAGIC); i++) {
+        header[i] = BBOX_LIST_MAGIC[i];
+    }
+    store_le(&header[4], BBOX_LIST_VERSION, 2);
+    store_le(&header[6], 0, 2);
+    store_le(&header[8], num_bboxes, 4);
+    if (write(header, sizeof(header), arg) != 0) {
+        return -1;
+    }
+
+    // Write the boxes a batch at a time, so this doesn't depend on endianness
+    unsigned char bytes[WRITE_BATCH_BBOXES * sizeof(bbox_t)];
+    for (int i = 0; i < num_bboxes; i += WRITE_BATCH_BBOXES) {
+        size_t len = 0;
+        for (int j = i; j < num_bboxes && j < i + WRITE_BATCH_BBOXES; j++) {
+            store_le(&bytes[len], (uint16_t)bboxes[j].x1, 2);
+            store_le(&bytes[len+2], (uint16_t)bboxes[j].y1, 2);
+            store_le(&bytes[len+4], (uint16_t)bboxes[j].x2, 2);
+            store_le(&bytes[len+6], (uint16_t)bboxes[j].y2, 2);
+            len += sizeof(bbox_t);
+        }
+        if (write(bytes, len, arg) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+// Reads back the boxes from the binary format
+static int read_binary(const unsigned char *bytes, size_t size,
+        bbox_t *bboxes, int max_bboxes)
+{
+    if (size < BINARY_HEADER_SIZE ||
+            load_le(&bytes[4], 2) != BBOX_LIST_VERSION) {
+        return -1;
+    }
+    int num_bboxes = load_le(&bytes[8], 4);
+    if (num_bboxes > max_bboxes || size != BINARY_HEADER_SIZE +
+            num_bboxes * sizeof(bbox_t)) {
+        return -1;
+    }
+
+    const unsigned char *bbox_bytes = &bytes[BINARY_HEADER_SIZE];
+    for (int i = 0; i < num_bboxes; i++, bbox_bytes += sizeof(bbox_t)) {
+        bboxes[i] = bbox_t((int16_t)load_le(&bbox_bytes[0], 2),
+                (int16_t)load_le(&bbox_bytes[2], 2),
+                (int16_t)load_le(&bbox_bytes[4], 2),
+                (int16_t)load_le(&bbox_bytes[6], 2));
+    }
+    return num_bboxes;
+}
+
+// Reads back the boxes from CSV, after the header line
+static int read_csv(const char *text, size_t size, bbox_t *bboxes,
+        int max_bboxes)
+{
+    size_t header_len = sizeof(BBOX_CSV_HEADER) - 1;
+    if (size < header_len || memcmp(text, BBOX_CSV_HEADER, header_len) != 0) {
+        return -1;
+    }
+
+    // Each line must be exactly four integers and a newline
+    int num_bboxes = 0;
+    for (size_t pos = header_len; pos < size; num_bboxes++) {
+        char line[CSV_MAX_LINE + 1];
+        const char *end = (const char *)memchr(&text[pos], '\n', size - pos);
+        size_t len = (end == NULL) ? size - pos : end - &text[pos];
+        if (len >= sizeof(line) || num_bboxes == max_bboxes) {
+            return -1;
+        }
+        memcpy(line, &text[pos], len);
+        line[len] = '\0';
+        pos += len + 1;
+
+        int x1, y1, x2, y2, consumed;
+        if (sscanf(line, "%d,%d,%d,%d%n", &x1, &y1, &x2, &y2,
+                    &consumed) != 4 || (size_t)consumed != len) {
+            return -1;
+        }
+        bboxes[num_bboxes] = bbox_t(x1, y1, x2, y2);
+    }
+
+    return num_bboxes;
+}
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+int bbox_list_parse(const bbox_t *list, size_t size)
+{
+    int max_bboxes = size / sizeof(bbox_t);
+    for (int i = 0; i < max_bboxes; i++) {
+        if (list[i].is_terminator()) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+const char *bbox_format_extension(bbox_format format)
+{
+    return (format == BBOX_FORMAT_CSV) ? "csv" : "bbl";
+}
+
+int bbox_list_write(bbox_format format, const bbox_t *bboxes, int num_bboxes,
+        bbox_write_t write, void *arg)
+{
+    if (format == BBOX_FORMAT_CSV) {
+        return write_csv(bboxes, num_bboxes, write, arg);
+    }
+    return write_binary(bboxes, num_bboxes, write, arg);
+}
+
+int bbox_list_read(const void *data, size_t size, bbox_t *bboxes,
+        int max_bboxes)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+    if (size >= sizeof(BBOX_LIST_MAGIC) && memcmp(bytes, BBOX_LIST_MAGIC,
+                sizeof(BBOX_LIST_MAGIC)) == 0) {
+        return read_binary(bytes, size, bboxes, max_bboxes);
+    }
+    return read_csv((const char *)data, size, bboxes, max_bboxes);
+}
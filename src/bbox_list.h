@@ -0,0 +1,97 @@
+/**
+ * @file bbox_list.h
+ * @date Saturday, October 24, 2026 at 10:05:37 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface for parsing and writing out the lists of
+ * bounding boxes returned by the hardware blob detector.
+ *
+ * The hardware streams back a short list of 64-bit bounding boxes, ended by
+ * the terminator box, rather than an image. The list is received into a small
+ * buffer, and parsed up to the terminator. The boxes of each frame are then
+ * written out in one of two compact formats:
+ *      CSV:    a header line, then one "x1,y1,x2,y2" line per box
+ *      binary: "BDBL", u16 version, u16 reserved, u32 num_bboxes, then
+ *              num_bboxes * (i16 x1, y1, x2, y2), all little-endian
+ *
+ * The output is written through a callback, so the same code writes it with
+ * FatFs on the Zynq, and with stdio on the host. Saved lists can be read back
+ * in either format on the host, e.g. to draw the boxes over the frames.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef BBOX_LIST_H_
+#define BBOX_LIST_H_
+
+#include <stddef.h>             // Definition of size_t
+
+#include "bbox.h"               // Definition of a bounding box
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The formats the bounding boxes of a frame can be written out in.
+ **/
+enum bbox_format {
+    BBOX_FORMAT_CSV,                    // Comma-separated text
+    BBOX_FORMAT_BINARY,                 // Packed little-endian boxes
+};
+
+/**
+ * The function used to write out a list, which is called with successive
+ * pieces of it. It returns 0 on success, and -1 on failure.
+ **/
+typedef int (*bbox_write_t)(const void *data, size_t size, void *arg);
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Parses a list of bounding boxes received from the hardware, finding the
+ * number of boxes before the terminator.
+ *
+ * @param list The received list of bounding boxes.
+ * @param size The number of bytes received.
+ * @return The number of boxes before the terminator, or -1 if there is no
+ *         terminator in the bytes received (i.e. the list was truncated).
+ **/
+int bbox_list_parse(const bbox_t *list, size_t size);
+
+/**
+ * Returns the file extension used for a format, without the dot. These are at
+ * most 3 characters, to fit FAT's 8.3 file names.
+ **/
+const char *bbox_format_extension(bbox_format format);
+
+/**
+ * Writes out the bounding boxes of a frame in the given format.
+ *
+ * @param format The format to write the boxes in.
+ * @param bboxes The boxes found in the frame.
+ * @param num_bboxes The number of boxes found in the frame.
+ * @param write The function used to write out the boxes.
+ * @param arg The argument passed through to the write function.
+ * @return 0 on success, -1 if the write function fails.
+ **/
+int bbox_list_write(bbox_format format, const bbox_t *bboxes, int num_bboxes,
+        bbox_write_t write, void *arg);
+
+/**
+ * Reads back a list of bounding boxes saved by bbox_list_write(), detecting
+ * its format from the contents.
+ *
+ * @param data The contents of the saved list.
+ * @param size The size of the saved list, in bytes.
+ * @param bboxes The array the boxes are read into.
+ * @param max_bboxes The maximum number of boxes to read.
+ * @return The number of boxes read, or -1 if the list is malformed or has more
+ *         than max_bboxes boxes.
+ **/
+int bbox_list_read(const void *data, size_t size, bbox_t *bboxes,
+        int max_bboxes);
+
+#endif /* BBOX_LIST_H_ */
@@ -0,0 +1,102 @@
+/**
+ * @file bbox_list_test.cpp
+ * @date Saturday, October 24, 2026 at 11:32:08 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for parsing and writing out bounding box lists.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+#include <cstring>                  // Memory comparison function
+
+#include <string>                   // String class
+#include <vector>                   // Vector container
+
+#include "bbox_list.h"              // Bounding box lists
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The number of boxes in the long list, which spans several write batches
+static const int LONG_LIST_BBOXES   = 100;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+// Appends the written bytes to a string
+static int write_string(const void *data, size_t size, void *arg)
+{
+    std::string *text = (std::string *)arg;
+    text->append((const char *)data, size);
+    return 0;
+}
+
+// Fails the write, to check that errors are passed through
+static int write_fail(const void *data, size_t size, void *arg)
+{
+    (void)data;
+    (void)size;
+    (void)arg;
+    return -1;
+}
+
+int main()
+{
+    // The list is parsed up to the terminator, ignoring anything after it
+    bbox_t list[] = {bbox_t(1, 2, 7, 8), bbox_t(-3, 10, 3, 16),
+            bbox_t::terminator(), bbox_t(5, 5, 5, 5)};
+    assert(bbox_list_parse(list, sizeof(list)) == 2);
+    assert(bbox_list_parse(list, 2 * sizeof(bbox_t)) == -1);
+    assert(bbox_list_parse(&list[2], sizeof(bbox_t)) == 0);
+
+    std::string text;
+    int rc = bbox_list_write(BBOX_FORMAT_CSV, list, 2, write_string, &text);
+    assert(rc == 0 && text == "x1,y1,x2,y2\n1,2,7,8\n-3,10,3,16\n");
+
+    // The binary format is little-endian, with a header
+    std::string bytes;
+    rc = bbox_list_write(BBOX_FORMAT_BINARY, list, 2, write_string, &bytes);
+    const unsigned char expected[] = {'B', 'D', 'B', 'L', 1, 0, 0, 0, 2, 0, 0,
+            0, 1, 0, 2, 0, 7, 0, 8, 0, 0xFD, 0xFF, 10, 0, 3, 0, 16, 0};
+    assert(rc == 0 && bytes.size() == sizeof(expected));
+    assert(memcmp(bytes.data(), expected, sizeof(expected)) == 0);
+
+    // Both formats read back to the same boxes
+    bbox_t read[4];
+    rc = bbox_list_read(text.data(), text.size(), read, 4);
+    assert(rc == 2 && read[1].x1 == -3 && read[1].y2 == 16);
+    rc = bbox_list_read(bytes.data(), bytes.size(), read, 4);
+    assert(rc == 2 && read[0].x2 == 7 && read[1].x1 == -3);
+    assert(bbox_list_read(bytes.data(), bytes.size() - 1, read, 4) == -1);
+    assert(bbox_list_read(text.data(), text.size(), read, 1) == -1);
+    assert(bbox_list_read("x1,y1,x2,y2\n1,2,3\n", 18, read, 4) == -1);
+    assert(bbox_list_read("x1,y1,x2,y2\n", 12, read, 4) == 0);
+
+    // Long lists are written out in several pieces
+    std::vector<bbox_t> bboxes(LONG_LIST_BBOXES, bbox_t(-32768, -32768,
+            32767, 32767));
+    text.clear();
+    rc = bbox_list_write(BBOX_FORMAT_CSV, bboxes.data(), bboxes.size(),
+            write_string, &text);
+    std::string line = "-32768,-32768,32767,32767\n";
+    assert(rc == 0 && text.size() == 12 + LONG_LIST_BBOXES * line.size());
+    assert(text.substr(text.size() - line.size()) == line);
+    bytes.clear();
+    rc = bbox_list_write(BBOX_FORMAT_BINARY, bboxes.data(), bboxes.size(),
+            write_string, &bytes);
+    assert(rc == 0 && bytes.size() == 12 + LONG_LIST_BBOXES * sizeof(bbox_t));
+
+    rc = bbox_list_write(BBOX_FORMAT_CSV, list, 2, write_fail, NULL);
+    assert(rc == -1);
+    rc = bbox_list_write(BBOX_FORMAT_BINARY, list, 2, write_fail, NULL);
+    assert(rc == -1);
+    assert(strcmp(bbox_format_extension(BBOX_FORMAT_BINARY), "bbl") == 0);
+
+    printf("Bounding box list test passed.\n");
+    return 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file bbox_overlay.cpp
+ * @date Saturday, October 24, 2026 at 04:09:31 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the application that draws detected bounding boxes over
+ * a video, for reviewing the detector's results.
+ *
+ * The application reads a raw RGBA video (frames of the given size, back to
+ * back, with no header), draws the boxes of each frame into it in place, and
+ * writes out the result as a raw RGBA video. Either may be '-', for stdin or
+ * stdout, so the video can be piped to and from ffmpeg, e.g.:
+ *      ffmpeg -i in.mp4 -f rawvideo -pix_fmt rgba - | bbox_overlay -d 1920 \
+ *          1080 - - | ffplay -f rawvideo -pixel_format rgba \
+ *          -video_size 1920x1080 -
+ *
+ * The boxes of each frame come either from the lists saved by the Zynq
+ * application (one CSV or binary file per frame, in order), or with -d, from
+ * running the host detector on each frame as it is read, so that long videos
+ * can be reviewed without saving any lists. Errors are logged on stderr, so
+ * they never end up in a video written to stdout.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstdlib>                  // C standard library
+#include <cstdio>                   // C standard I/O library
+#include <cstring>                  // String comparison
+
+#include <unistd.h>                 // Command line option parsing
+
+#include <chrono>                   // Clocks for timing the run
+#include <vector>                   // Vector container
+
+#include "host_detector.h"          // Host detector interface
+#include "bbox_list.h"              // Bounding box list reading
+#include "overlay.h"                // Bounding box overlay
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The maximum number of bounding boxes drawn on a single frame
+static const int MAX_BBOXES         = 1024;
+
+// The size of the stdio buffers for the videos, a few rows of a large frame
+static const size_t VIDEO_BUFFER_SIZE = 1 << 20;
+
+// The largest saved list of bounding boxes that is read
+static const size_t MAX_LIST_SIZE   = 64 * 1024;
+
+// The default color and thickness of the outlines
+static const pixel_t DEFAULT_COLOR(255, 0, 0, 255);
+static const int DEFAULT_THICKNESS  = 2;
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+static void print_usage(const char *program)
+{
+    printf("Usage: %s [-d] [-t] [-w thickness] [-c rrggbb] <width> <height> "
+            "<input> <output> [bbox_list ...]\n", program);
+    printf("\tThe input and output are raw RGBA videos, or '-' for stdin and "
+            "stdout.\n");
+    printf("\t-d\tDetect the boxes with the host detector, instead of reading "
+            "the lists.\n");
+    printf("\t-t\tRun the stages of the detector on multiple threads.\n");
+    printf("\t-w\tThe thickness of the outlines, in pixels (default %d).\n",
+            DEFAULT_THICKNESS);
+    printf("\t-c\tThe color of the outlines, in hex (default ff0000).\n");
+}
+
+// Opens a video file, or stdin or stdout for '-', with a large buffer
+static FILE *open_video(const char *path, bool output)
+{
+    FILE *file;
+    if (strcmp(path, "-") == 0) {
+        file = output ? stdout : stdin;
+    } else {
+        file = fopen(path, output ? "wb" : "rb");
+    }
+    if (file == NULL) {
+        log_err("%s: Unable to open video file.\n", path);
+        return NULL;
+    }
+
+    setvbuf(file, NULL, _IOFBF, VIDEO_BUFFER_SIZE);
+    return file;
+}
+
+// Reads a saved list of bounding boxes, returning the number of boxes
+static int read_bbox_list(const char *path, std::vector<bbox_t>& bboxes)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        log_err("%s: Unable to open bounding box list.\n", path);
+        return -1;
+    }
+
+    std::vector<char> data(MAX_LIST_SIZE);
+    size_t size = fread(data.data(), 1, data.size(), file);
+    fclose(file);
+    int num_bboxes = bbox_list_read(data.data(), size, bboxes.data(),
+            bboxes.size());
+    if (size == data.size() || num_bboxes < 0) {
+        log_err("%s: Malformed or too large bounding box list.\n", path);
+        return -1;
+    }
+
+    return num_bboxes;
+}
+
+// Parses a color given as a hex string, e.g. "ff0000" for red
+static int parse_color(const char *text, pixel_t& color)
+{
+    char *end;
+    unsigned long value = strtoul(text, &end, 16);
+    if (strlen(text) != 6 || *end != '\0') {
+        log_err("%s: Color must be six hex digits.\n", text);
+        return -1;
+    }
+
+    color = pixel_t((value >> 16) & 0xFF, (value >> 8) & 0xFF, value & 0xFF,
+            255);
+    return 0;
+}
+
+/*----------------------------------------------------------------------------
+ * Main Application
+ *----------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    // Parse the command line options
+    bool detect = false;
+    bool threaded = false;
+    int thickness = DEFAULT_THICKNESS;
+    pixel_t color = DEFAULT_COLOR;
+    int opt;
+    while ((opt = getopt(argc, argv, "dtw:c:")) != -1) {
+        if (opt == 'd') {
+            detect = true;
+        } else if (opt == 't') {
+            threaded = true;
+        } else if (opt == 'w') {
+            thickness = atoi(optarg);
+        } else if (opt == 'c') {
+            if (parse_color(optarg, color) != 0) {
+                return EXIT_FAILURE;
+            }
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind < 4 || thickness < 1 ||
+            (!detect && argc - optind == 4)) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    int width = atoi(argv[optind]);
+    int height = atoi(argv[optind+1]);
+    const char *input_path = argv[optind+2];
+    const char *output_path = argv[optind+3];
+    char **bbox_lists = &argv[optind+4];
+    int num_bbox_lists = argc - optind - 4;
+
+    // Initialize the detector, if the boxes are detected on the fly
+    host_detector_t detector;
+    if (detect && host_detector_init(detector, width, height) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    // Open the input and output videos
+    FILE *input = open_video(input_path, false);
+    FILE *output = open_video(output_path, true);
+    if (input == NULL || output == NULL) {
+        host_detector_destroy(detector);
+        return EXIT_FAILURE;
+    }
+
+    // Draw the boxes on each frame, until the end of the input video
+    auto start = std::chrono::steady_clock::now();
+    std::vector<pixel_t> frame(width * height);
+    std::vector<bbox_t> bboxes(MAX_BBOXES);
+    int num_frames = 0;
+    for (; fread(frame.data(), sizeof(pixel_t), frame.size(), input) ==
+            frame.size(); num_frames++) {
+        int num_bboxes;
+        if (detect) {
+            num_bboxes = threaded ?
+                    host_detect_blobs_threaded(detector, frame.data(),
+                            bboxes.data(), bboxes.size()) :
+                    host_detect_blobs(detector, frame.data(), bboxes.data(),
+                            bboxes.size());
+        } else if (num_frames < num_bbox_lists) {
+            num_bboxes = read_bbox_list(bbox_lists[num_frames], bboxes);
+        } else {
+            log_err("Frame %d: No bounding box list left for the frame.\n",
+                    num_frames);
+            host_detector_destroy(detector);
+            return EXIT_FAILURE;
+        }
+        if (num_bboxes < 0) {
+            host_detector_destroy(detector);
+            return EXIT_FAILURE;
+        }
+
+        overlay_draw_bboxes(frame.data(), width, height, bboxes.data(),
+                num_bboxes, thickness, color);
+        if (fwrite(frame.data(), sizeof(pixel_t), frame.size(), output) !=
+                frame.size()) {
+            log_err("%s: Unable to write frame %d.\n", output_path,
+                    num_frames);
+            host_detector_destroy(detector);
+            return EXIT_FAILURE;
+        }
+    }
+    host_detector_destroy(detector);
+
+    if (fflush(output) != 0) {
+        log_err("%s: Unable to write output video.\n", output_path);
+        return EXIT_FAILURE;
+    }
+
+    // Report the throughput on stderr, as stdout may hold the video
+    double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%d frames in %.2f s (%.1f frames/s)\n", num_frames,
+            seconds, num_frames / seconds);
+    return EXIT_SUCCESS;
+}
@@ -14,52 +14,85 @@
 
 #include <xil_cache.h>              // Cache control functions
 #include <xparameters.h>            // Auto-generated params for FPGA IP
-#include <xaxidma.h>                // Functions and definitions for AXI CDMA
-#include <xtime_l.h>                // Cycle counter timer
 #include <ff.h>                     // Xilinx FAT filesystem interface
 #include <ffconf.h>                 // Xilinx FAT filesystem configuration
+#include <xblob_detector.h>         // Driver for the blob detector's registers
+
+// Controls whether or not verbose print statements are enabled
+#define VERBOSE
 
 #include "image.h"                  // Image definitions and the image type
+#include "log.h"                    // Error and verbose logging macros
+#include "dma.h"                    // Asynchronous DMA (built with DMA_XAXIDMA)
+#include "bbox_list.h"              // Bounding box list parsing and output
+#include "roi_mask.h"               // Region of interest mask
+#include "stream_mux.h"             // Multiplexing the cameras' frames
+#include "stripe.h"                 // Splitting frames into stripes
+#include "trace.h"                  // Latency tracer (built with TRACE_XTIME)
 
 /*----------------------------------------------------------------------------
  * Internal Definitions
  *----------------------------------------------------------------------------*/
 
-// Controls whether or not verbose print statements are enabled
-#define VERBOSE
-
-// A macro to print an error message
-#define log_err(msg, ...) printf("%s: %s: %d: Error: " msg, __FILE__, \
-        __func__, __LINE__, ##__VA_ARGS__)
-
-// A macro to enable print messages when DEBUG is defined
-#ifdef VERBOSE
-#define log_verbose(...) printf(__VA_ARGS__)
-#else
-#define log_verbose(...)
-#endif
+// Maximum size any given path is allowed to be
+static const size_t MAX_PATH_LEN    = 100;
 
 // Alias for an image containing 32-bit RGBA pixels
 typedef matrix<pixel, IMAGE_WIDTH, IMAGE_HEIGHT> input_image_t;
 
-// A structure representing an AXI DMA device, holds information about the IP
-typedef struct axidma {
-    int id;                         // ID used to identify the device
-    XAxiDma_Config *config;         // Config parameters for the AXI DMA
-    XAxiDma dev;                    // AXI DMA device structure
-} axidma_t;
+/* When the hardware is built with STRIPE_WIDTH defined, its line buffers only
+ * hold a stripe of the frame and its halos, so each frame is sent to it as
+ * vertical stripes, and the stripes' lists of boxes are stitched together. */
+#ifdef STRIPE_WIDTH
+static const int STRIPE_IMAGE_WIDTH = STRIPE_WIDTH + 2 * STRIPE_HALO;
+static const int NUM_STRIPES        = (IMAGE_WIDTH + STRIPE_WIDTH - 1) /
+        STRIPE_WIDTH;
+typedef matrix<input_pixel_t, STRIPE_IMAGE_WIDTH, IMAGE_HEIGHT> stripe_image_t;
+static_assert(STRIPE_IMAGE_WIDTH < IMAGE_WIDTH,
+        "The stripes and their halos must be narrower than the frame");
+#else
+static const int NUM_STRIPES        = 1;
+#endif /* STRIPE_WIDTH */
 
 // A structure representing the context on the device
 typedef struct device_context {
     FATFS sd_card_fs;               // Handle the the SD card filesystem (FAT)
-    axidma_t axidma;                // The AXI DMA device
+    dma_t dma;                      // The AXI DMA device
+    XBlob_detector blob_detector;   // The blob detector's control registers
 } devices_context_t;
 
-// Maximum size any given path is allowed to be
-static const size_t MAX_PATH_LEN    = 100;
+// A camera, with its own directories of input images and of output boxes
+typedef struct camera {
+    const TCHAR *name;              // The name of the camera's directories
+    TCHAR image_path[MAX_PATH_LEN+1]; // The directory of the camera's images
+    TCHAR output_path[MAX_PATH_LEN+1]; // The directory of the camera's boxes
+    DIR image_dir;                  // The open image directory
+    bool done;                      // Whether all of its images were read
+} camera_t;
+
+// A frame being processed, with its own input image and bounding box buffers
+typedef struct frame {
+    int index;                      // The index of the frame, for tracing
+    stream_tag_t tag;               // The camera and frame number in it
+    TCHAR name[sizeof(FILINFO::fname)]; // The name of the image file
+    image_t *image;                 // The input image sent to the FPGA
+    bbox_t *bboxes;                 // The list of boxes received from the FPGA
+    int num_bboxes;                 // The number of boxes in the list
+#ifdef STRIPE_WIDTH
+    const stripe_t *stripes;        // The stripes the image is split into
+    stripe_image_t *stripe_images;  // The stripes of the image that are sent
+    bbox_t *stripe_bboxes;          // The list of boxes received for each one
+#endif /* STRIPE_WIDTH */
+    dma_transfer_t sends[NUM_STRIPES]; // The transfers of the input image
+    dma_transfer_t receives[NUM_STRIPES]; // The transfers of the boxes
+    uint64_t begin_ns;              // When the transfers were started
+    uint64_t send_end_ns;           // When the send completed
+    uint64_t receive_end_ns;        // When the receive completed
+} frame_t;
 
 // Shorten the clunky name for id defines for the AXI DMA devices
 static const int AXIDMA_ID          = XPAR_INPUT_OUTPUT_DMA_DEVICE_ID;
+static const int BLOB_DETECTOR_ID   = XPAR_BLOB_DETECTOR_0_DEVICE_ID;
 
 // The path to the SD card for the f_mount function
 static const TCHAR *SD_CARD_PATH    = "0:/";
@@ -70,38 +103,142 @@ static const TCHAR *SD_CARD_PATH    = "0:/";
  * exceed 3 characters. */
 static const TCHAR *IMAGE_DIR_PATH  = "images";
 static const TCHAR *OUTPUT_DIR_PATH = "output";
-
-// Allocate global buffers for the input and output images
-static image_t IMAGE;
-static image_t OUTPUT_IMAGE;
+static const TCHAR *TRACE_FILE_NAME = "trace.jsn";
+
+/* The region of interest's mask file, at the root of the SD card, and the
+ * largest it can be. When there is no such file, the whole frame is processed.
+ * The hardware's tiles are always the default size (see roi_mask.h). */
+static const TCHAR *ROI_FILE_NAME   = "roi.txt";
+static const size_t MAX_ROI_FILE_SIZE = 4096;
+
+/* The cameras sharing the FPGA. Each camera's images are in its own directory
+ * under the image directory, and its boxes are saved to the directory of the
+ * same name under the output directory. */
+static const TCHAR *CAMERA_NAMES[]  = {"cam0", "cam1"};
+static const int NUM_CAMERAS        = sizeof(CAMERA_NAMES) /
+        sizeof(CAMERA_NAMES[0]);
+
+/* The hardware's adaptive threshold is computed from the previous frame it
+ * saw, whichever camera it came from, so it only follows one camera's exposure
+ * (see threshold.h). */
+#ifdef ADAPTIVE_THRESHOLD
+static_assert(NUM_CAMERAS == 1,
+        "The adaptive threshold can only follow a single camera's exposure.");
+#endif /* ADAPTIVE_THRESHOLD */
+
+// The maximum number of events recorded in the latency trace
+static const size_t TRACE_EVENTS    = 4096;
+
+/* The most boxes the hardware can return for a frame or a stripe, including
+ * the terminator, and the format the boxes of each frame are saved in. */
+static const int MAX_BBOX_LIST      = 1024;
+static const bbox_format OUTPUT_FORMAT = BBOX_FORMAT_CSV;
+
+/* Allocate global buffers for the input images and the lists of boxes. Several
+ * frames are queued on the DMA rings at once, so the FPGA runs them back to
+ * back, while the next image is read, and the oldest one is saved. The lists
+ * are invalidated from the cache when they're received, so they're aligned to
+ * cache lines, to not share a line with anything else. Each stripe of a frame
+ * takes its own place on the rings, so fewer frames are queued with stripes,
+ * and every camera's frame must still fit on them. */
+static const int NUM_FRAME_BUFFERS  = (4 * NUM_STRIPES <= DMA_RING_SIZE) ? 4 :
+        DMA_RING_SIZE / NUM_STRIPES;
+static image_t IMAGES[NUM_FRAME_BUFFERS];
+
+/* The size of an image file. Luma images are NV12 or I420 frames, straight from
+ * the camera, which have their chroma planes after the luma plane. Only the
+ * luma plane is read and sent to the FPGA. */
+#ifdef LUMA_INPUT
+static const size_t IMAGE_FILE_SIZE = sizeof(image_t) * 3 / 2;
+#else
+static const size_t IMAGE_FILE_SIZE = sizeof(image_t);
+#endif /* LUMA_INPUT */
+alignas(64) static bbox_t BBOX_LISTS[NUM_FRAME_BUFFERS][MAX_BBOX_LIST];
+static_assert(NUM_FRAME_BUFFERS * NUM_STRIPES <= DMA_RING_SIZE,
+        "Every frame in flight must fit on the DMA rings");
+#ifdef STRIPE_WIDTH
+static stripe_image_t STRIPE_IMAGES[NUM_FRAME_BUFFERS][NUM_STRIPES];
+alignas(64) static bbox_t STRIPE_BBOX_LISTS[NUM_FRAME_BUFFERS][NUM_STRIPES]
+        [MAX_BBOX_LIST];
+#endif /* STRIPE_WIDTH */
+
+/* The frames each camera can hold at once, whether waiting for the FPGA or in
+ * flight. The frame buffers are split evenly between the cameras, so a camera
+ * that runs ahead waits on its own buffers, not on the other cameras'. */
+static const int CAMERA_CREDITS     = NUM_FRAME_BUFFERS / NUM_CAMERAS;
+static_assert(CAMERA_CREDITS >= 1 && CAMERA_CREDITS <= STREAM_MUX_MAX_CREDITS,
+        "Every camera must have a frame buffer of its own");
 
 /*----------------------------------------------------------------------------
  * Initialization
  *----------------------------------------------------------------------------*/
 
-static int init_axidma(axidma_t& axidma, int device_id)
+/* Loads the region of interest from the SD card, and programs the blob
+ * detector's bitmap of the tiles to skip with it. Each row of tiles is padded
+ * out to whole 32-bit words, with its leftmost tile in bit 0 of its first. */
+static int init_roi(XBlob_detector& blob_detector)
 {
-    // Lookup the configuration for the AXI DMA device
-    axidma.id = device_id;
-    axidma.config = XAxiDma_LookupConfig(axidma.id);
-    if (axidma.config == NULL) {
-        log_err("Unable to find AXI DMA device with id %d\n", device_id);
-        return XST_DEVICE_NOT_FOUND;
+    roi_mask_t roi;
+    int rc = roi_mask_init(roi, IMAGE_WIDTH, IMAGE_HEIGHT,
+            ROI_DEFAULT_TILE_SIZE);
+    if (rc != 0) {
+        return XST_FAILURE;
     }
 
-    int rc = XAxiDma_CfgInitialize(&axidma.dev, axidma.config);
-    if (rc != XST_SUCCESS) {
-        log_err("Unable to initialize the AXI DMA device with id %d\n",
-                device_id);
-        return rc;
+    // Read the mask file, if there is one, and parse it
+    FIL file;
+    FRESULT f_rc = f_open(&file, ROI_FILE_NAME, FA_READ);
+    if (f_rc == FR_OK) {
+        static char text[MAX_ROI_FILE_SIZE+1];
+        size_t bytes_read = 0;
+        if (file_size(&file) <= MAX_ROI_FILE_SIZE) {
+            f_rc = f_read(&file, text, MAX_ROI_FILE_SIZE, &bytes_read);
+        }
+        f_close(&file);
+        if (file_size(&file) > MAX_ROI_FILE_SIZE || f_rc != FR_OK) {
+            log_err("%s: Unable to read ROI mask file of at most %zu bytes.\n",
+                    ROI_FILE_NAME, MAX_ROI_FILE_SIZE);
+            return XST_FAILURE;
+        }
+        text[bytes_read] = '\0';
+
+        rc = roi_mask_parse(roi, ROI_FILE_NAME, text, IMAGE_WIDTH,
+                IMAGE_HEIGHT);
+        if (rc != 0) {
+            return XST_FAILURE;
+        } else if (roi.tile_size != ROI_DEFAULT_TILE_SIZE) {
+            log_err("%s: The hardware's ROI tiles are %d pixels, not %d.\n",
+                    ROI_FILE_NAME, ROI_DEFAULT_TILE_SIZE, roi.tile_size);
+            return XST_FAILURE;
+        }
+    } else if (f_rc != FR_NO_FILE) {
+        log_err("%s: Unable to open ROI mask file.\n", ROI_FILE_NAME);
+        return f_rc;
+    }
+    log_verbose("%d of the %d ROI tiles are in the region of interest.\n",
+            roi_mask_count(roi), roi.tile_rows * roi.tile_cols);
+
+    // Pack the tiles outside of the region of interest into the words
+    int row_words = (roi.tile_cols + 31) / 32;
+    std::vector<u32> skip_tiles(roi.tile_rows * row_words, 0);
+    for (int row = 0; row < roi.tile_rows; row++) {
+        for (int col = 0; col < roi.tile_cols; col++) {
+            if (!roi.test(row, col)) {
+                skip_tiles[row * row_words + col / 32] |= 1U << (col % 32);
+            }
+        }
     }
 
-    // Disable all DMA interrupts for both channels, as we're polling
-    XAxiDma_IntrDisable(&axidma.dev, XAXIDMA_IRQ_ALL_MASK,
-            XAXIDMA_DEVICE_TO_DMA);
-    XAxiDma_IntrDisable(&axidma.dev, XAXIDMA_IRQ_ALL_MASK,
-                        XAXIDMA_DMA_TO_DEVICE);
-
+    // Program the bitmap, which must match the size the hardware was built for
+    u32 total_bytes = skip_tiles.size() * sizeof(skip_tiles[0]);
+    if (XBlob_detector_Get_Skip_tiles_TotalBytes(&blob_detector) !=
+            total_bytes) {
+        log_err("The hardware's ROI bitmap is not %u bytes, for %dx%d tiles.\n",
+                total_bytes, roi.tile_cols, roi.tile_rows);
+        return XST_FAILURE;
+    }
+    XBlob_detector_Write_Skip_tiles_Words(&blob_detector, 0, skip_tiles.data(),
+            skip_tiles.size());
     return XST_SUCCESS;
 }
 
@@ -115,13 +252,18 @@ static int init_devices(devices_context_t& devices)
         return rc;
     }
 
-    // Initialize the AXI DMA devices
-    rc = init_axidma(devices.axidma, AXIDMA_ID);
+    // Initialize the AXI DMA device, and its interrupts
+    if (dma_init(devices.dma, AXIDMA_ID) != 0) {
+        return XST_FAILURE;
+    }
+
+    // Initialize the blob detector's registers, and load its ROI mask
+    rc = XBlob_detector_Initialize(&devices.blob_detector, BLOB_DETECTOR_ID);
     if (rc != XST_SUCCESS) {
+        log_err("Unable to initialize the blob detector's registers.\n");
         return rc;
     }
-
-    return XST_SUCCESS;
+    return init_roi(devices.blob_detector);
 }
 
 /*----------------------------------------------------------------------------
@@ -152,23 +294,30 @@ static int open_image(const TCHAR *root_path, const TCHAR *tail_path,
 
     // Try to open the specified image file
     FIL file;
-    FRESULT rc = f_open(&file, image_path, FA_READ);
+    FRESULT rc;
+    {
+        trace_scope trace("open image");
+        rc = f_open(&file, image_path, FA_READ);
+    }
     if (rc != FR_OK) {
         log_err("%s: Unable to open input image file.\n", image_path);
         return rc;
     }
 
     // Check that the file is the expected size
-    if (file_size(&file) != image.size()) {
+    if (file_size(&file) != IMAGE_FILE_SIZE) {
         log_err("%s: File size does not match input image's. Expected %u "
-                "bytes, but the file size is %lu.\n", image_path, image.size(),
-                file.fsize);
+                "bytes, but the file size is %lu.\n", image_path,
+                IMAGE_FILE_SIZE, file.fsize);
         return XST_BUFFER_TOO_SMALL;
     }
 
     // Read an image's worth of data plus 1 byte to detect for too large files
     size_t bytes_read;
-    rc = f_read(&file, image.buffer, image.size(), &bytes_read);
+    {
+        trace_scope trace("read image");
+        rc = f_read(&file, image.buffer, image.size(), &bytes_read);
+    }
     assert(bytes_read == image.size());
     if (rc != FR_OK) {
         log_err("%s: Unable to read input image.\n", image_path);
@@ -185,38 +334,87 @@ static int open_image(const TCHAR *root_path, const TCHAR *tail_path,
     return XST_SUCCESS;
 }
 
-static int save_image(const TCHAR *root_path, const TCHAR *tail_path,
-        const image_t& image)
+// Writes a piece of an output file to the open file
+static int write_file(const void *data, size_t size, void *arg)
 {
-    // Join the root and tail paths to get the path to the image
-    TCHAR image_path[MAX_PATH_LEN+1];
-    join_paths(root_path, tail_path, image_path, sizeof(image_path));
+    FIL *file = (FIL *)arg;
+    size_t bytes_written;
+    FRESULT rc = f_write(file, data, size, &bytes_written);
+    return (rc == FR_OK && bytes_written == size) ? 0 : -1;
+}
+
+static int save_bboxes(const TCHAR *root_path, const TCHAR *image_name,
+        const bbox_t *bboxes, int num_bboxes)
+{
+    trace_scope trace("save bboxes");
+
+    /* The output file is named after the image, with the format's extension
+     * in place of the image's (e.g. "image0.rgb" becomes "image0.csv"). */
+    TCHAR output_name[sizeof(FILINFO::fname)];
+    strncpy(output_name, image_name, sizeof(output_name));
+    TCHAR *extension = strchr(output_name, '.');
+    size_t base_len = (extension == NULL) ? strlen(output_name) :
+            extension - output_name;
+    snprintf(&output_name[base_len], sizeof(output_name) - base_len, ".%s",
+            bbox_format_extension(OUTPUT_FORMAT));
+
+    // Join the root path and the output name to get the path to the file
+    TCHAR output_path[MAX_PATH_LEN+1];
+    join_paths(root_path, output_name, output_path, sizeof(output_path));
 
     // Try to open the specified output file
     FIL file;
-    FRESULT rc = f_open(&file, image_path, FA_CREATE_ALWAYS|FA_WRITE);
+    FRESULT rc = f_open(&file, output_path, FA_CREATE_ALWAYS|FA_WRITE);
     if (rc != FR_OK) {
-        log_err("%s: Unable to open output image file.\n", image_path);
+        log_err("%s: Unable to open output file.\n", output_path);
         return rc;
     }
 
-    // Write the entire image to the file, and verify that it was successful
-    size_t bytes_written;
-    rc = f_write(&file, image.buffer, image.size(), &bytes_written);
+    // Write the boxes to the file, and close it
+    if (bbox_list_write(OUTPUT_FORMAT, bboxes, num_bboxes, write_file,
+                &file) != 0) {
+        log_err("%s: Unable to write bounding boxes to file.\n", output_path);
+        f_close(&file);
+        return FR_DISK_ERR;
+    }
+    rc = f_close(&file);
     if (rc != FR_OK) {
-        log_err("%s: Unable to write output image to file.\n", image_path);
+        log_err("%s: Unable to close output file.\n", output_path);
         return rc;
-    } else if (bytes_written != image.size()) {
-        log_err("%s: File size does not match output image's. Expected %u "
-                "bytes, but the file size is %lu.\n", image_path, image.size(),
-                file.fsize);
-        return XST_BUFFER_TOO_SMALL;
     }
 
-    // Close the output file
+    return XST_SUCCESS;
+}
+
+// Writes a piece of the trace's JSON text to the open trace file
+static int write_trace(const char *data, size_t size, void *arg)
+{
+    return write_file(data, size, arg);
+}
+
+static int save_trace(const TCHAR *root_path, const TCHAR *tail_path)
+{
+    // Join the root and tail paths to get the path to the trace file
+    TCHAR trace_path[MAX_PATH_LEN+1];
+    join_paths(root_path, tail_path, trace_path, sizeof(trace_path));
+
+    // Try to open the specified trace file
+    FIL file;
+    FRESULT rc = f_open(&file, trace_path, FA_CREATE_ALWAYS|FA_WRITE);
+    if (rc != FR_OK) {
+        log_err("%s: Unable to open trace file.\n", trace_path);
+        return rc;
+    }
+
+    // Write out the trace as Chrome trace JSON, and close the file
+    if (trace_write_json(write_trace, &file) != 0) {
+        log_err("%s: Unable to write trace to file.\n", trace_path);
+        f_close(&file);
+        return FR_DISK_ERR;
+    }
     rc = f_close(&file);
     if (rc != FR_OK) {
-        log_err("%s: Unable to close output image file.\n", image_path);
+        log_err("%s: Unable to close trace file.\n", trace_path);
         return rc;
     }
 
@@ -227,132 +425,303 @@ static int save_image(const TCHAR *root_path, const TCHAR *tail_path,
  * Main Application
  *----------------------------------------------------------------------------*/
 
-static int send_image(axidma_t& axidma, const image_t& image,
-        image_t& output_image)
+// Notes when a transfer completes, called from the DMA interrupt handler
+static void transfer_done(dma_transfer_t *transfer, void *arg)
 {
-    // Get a handle to the AXI DMA device
-    XAxiDma* dma_dev = &axidma.dev;
+    (void)transfer;
+    *(uint64_t *)arg = trace_now();
+}
 
-    // Initiate the transfer to receive the output image from the FPGA
-    int rc = XAxiDma_SimpleTransfer(dma_dev, (u32)output_image.buffer,
-            output_image.size(), XAXIDMA_DEVICE_TO_DMA);
-    if (rc != XST_SUCCESS) {
-        log_err("Unable to start image transfer over AXI DMA from the FPGA.\n");
-        return rc;
-    }
+/* Starts sending a frame's image to the FPGA, and receiving its list of boxes,
+ * returning while the frame is still in flight. With stripes, each stripe is
+ * copied out of the image, and sent and received on its own, back to back.
+ * The stripes complete in order, so the frame's transfers end with the last
+ * stripe's. */
+static int start_frame(dma_t& dma, frame_t& frame)
+{
+    log_verbose("\tTransferring the image over the fabric...\n");
+    frame.begin_ns = trace_now();
+    for (int i = 0; i < NUM_STRIPES; i++) {
+#ifdef STRIPE_WIDTH
+        stripe_image_t& image = frame.stripe_images[i];
+        bbox_t *bboxes = &frame.stripe_bboxes[i * MAX_BBOX_LIST];
+        {
+            trace_scope trace("copy stripe");
+            stripe_copy(frame.image->buffer, IMAGE_WIDTH, IMAGE_HEIGHT,
+                    sizeof(input_pixel_t), frame.stripes[i], image.buffer);
+        }
+#else
+        image_t& image = *frame.image;
+        bbox_t *bboxes = frame.bboxes;
+#endif /* STRIPE_WIDTH */
+
+        int rc = dma_start(dma, frame.receives[i], DMA_RECEIVE, bboxes,
+                MAX_BBOX_LIST * sizeof(bbox_t), transfer_done,
+                &frame.receive_end_ns);
+        if (rc != 0) {
+            log_err("Unable to start bbox transfer over AXI DMA from the "
+                    "FPGA.\n");
+            return XST_FAILURE;
+        }
 
-    // Initiate the transfer to send the image to the FPGA
-    rc = XAxiDma_SimpleTransfer(dma_dev, (u32)image.buffer, image.size(),
-            XAXIDMA_DMA_TO_DEVICE);
-    if (rc != XST_SUCCESS) {
-        log_err("Unable to start image transfer over AXI DMA to the FPGA.\n");
-        return rc;
+        rc = dma_start(dma, frame.sends[i], DMA_SEND, image.buffer,
+                image.size(), transfer_done, &frame.send_end_ns);
+        if (rc != 0) {
+            log_err("Unable to start image transfer over AXI DMA to the "
+                    "FPGA.\n");
+            return XST_FAILURE;
+        }
     }
 
-    /* Wait for both the transfers to complete. We really only need to wait on the
-     * receive transfer, as it depends on the transmit transfer. */
-    while (XAxiDma_Busy(dma_dev, XAXIDMA_DMA_TO_DEVICE) &&
-            XAxiDma_Busy(dma_dev, XAXIDMA_DEVICE_TO_DMA));
-
     return XST_SUCCESS;
 }
 
-static int blob_detection(axidma_t axidma, const TCHAR *image_dir,
-        const TCHAR *image_name, const TCHAR *output_dir)
+/* Waits for all of a frame's transfers to complete, and parses its list of
+ * boxes, which only fills as much of the buffer as it needs. With stripes, the
+ * boxes of each stripe's list are stitched into the frame's list. */
+static int finish_frame(dma_t& dma, frame_t& frame)
 {
-    // Get handles to the global buffers for the images
-    image_t& image = IMAGE;
-    image_t& output_image = OUTPUT_IMAGE;
-
-    // Open the image file, and load it into memory
-    log_verbose("\tOpening the image file in '%s'...\n", image_dir);
-    int rc = open_image(image_dir, image_name, image);
-    if (rc != XST_SUCCESS) {
-        return rc;
+    bool failed = false;
+    for (int i = 0; i < NUM_STRIPES; i++) {
+        int send_rc = dma_wait(dma, frame.sends[i]);
+        int receive_rc = dma_wait(dma, frame.receives[i]);
+        failed = failed || send_rc != 0 || receive_rc != 0;
     }
-
-    /* Use the hardware on the FPGA to perform an operation on the image,
-     * sending it out, and receiving a new output image. */
-    log_verbose("\tTransferring the image over the fabric...\n");
-    rc = send_image(axidma, image, output_image);
-    if (rc != XST_SUCCESS) {
-        return rc;
+    if (failed) {
+        log_err("%s: Image transfer over AXI DMA failed.\n", frame.name);
+        return XST_FAILURE;
     }
 
-    // Save the image file
-    log_verbose("\tSaving the image to file '%s'...\n", output_dir);
-    rc = save_image(output_dir, image_name, output_image);
-    if (rc != XST_SUCCESS) {
-        return rc;
+    trace_event("dma send", frame.begin_ns, frame.send_end_ns, frame.index);
+    trace_event("dma receive", frame.begin_ns, frame.receive_end_ns,
+            frame.index);
+#ifdef STRIPE_WIDTH
+    frame.num_bboxes = 0;
+    for (int i = 0; i < NUM_STRIPES; i++) {
+        bbox_t *bboxes = &frame.stripe_bboxes[i * MAX_BBOX_LIST];
+        int num_bboxes = bbox_list_parse(bboxes,
+                frame.receives[i].bytes_transferred);
+        if (num_bboxes < 0) {
+            log_err("%s: Bounding box list from the FPGA for stripe %d has "
+                    "no terminator.\n", frame.name, i);
+            return XST_FAILURE;
+        }
+        frame.num_bboxes += stripe_stitch(frame.stripes[i], bboxes,
+                num_bboxes, &frame.bboxes[frame.num_bboxes],
+                MAX_BBOX_LIST - 1 - frame.num_bboxes);
+    }
+    stripe_sort(frame.bboxes, frame.num_bboxes);
+#else
+    frame.num_bboxes = bbox_list_parse(frame.bboxes,
+            frame.receives[0].bytes_transferred);
+    if (frame.num_bboxes < 0) {
+        log_err("%s: Bounding box list from the FPGA has no terminator.\n",
+                frame.name);
+        return XST_FAILURE;
     }
+#endif /* STRIPE_WIDTH */
 
+    printf("%s: frame %lu, %s: %d blobs\n", CAMERA_NAMES[frame.tag.source],
+            (unsigned long)frame.tag.frame, frame.name, frame.num_bboxes);
     return XST_SUCCESS;
 }
 
-static int run_blob_detections(axidma_t& axidma, const TCHAR* image_dir_path,
-        DIR *image_dir, const TCHAR *output_dir_path)
+/* Loads the next image in the input directory into the frame, leaving the
+ * frame's name empty when there are no images left. */
+static int load_frame(const TCHAR *image_dir_path, DIR *image_dir,
+        frame_t& frame)
 {
-    // Read and process each image file in the directory
-    while (true) {
-        // Get the next file in the input image directory, stop when none left
-        FILINFO file_info;
-        FRESULT f_rc = f_readdir(image_dir, &file_info);
-        if (f_rc != FR_OK) {
-            log_err("%s: Unable to read the next file in the input image "
-                    "directory.\n", image_dir_path);
-            return f_rc;
-        } else if (strlen(file_info.fname) == 0) {
+    // Get the next file in the input image directory, stop when none left
+    FILINFO file_info;
+    FRESULT f_rc = f_readdir(image_dir, &file_info);
+    if (f_rc != FR_OK) {
+        log_err("%s: Unable to read the next file in the input image "
+                "directory.\n", image_dir_path);
+        return f_rc;
+    }
+    strncpy(frame.name, file_info.fname, sizeof(frame.name));
+    if (strlen(frame.name) == 0) {
+        return XST_SUCCESS;
+    }
+
+    // Open the image file, and load it into memory
+    printf("\nRunning blob detection on file '%s' in '%s'...\n", frame.name,
+            image_dir_path);
+    log_verbose("\tOpening the image file in '%s'...\n", image_dir_path);
+    return open_image(image_dir_path, frame.name, *frame.image);
+}
+
+static int run_blob_detections(dma_t& dma, camera_t *cameras)
+{
+#ifdef STRIPE_WIDTH
+    // Split the frames into the stripes that the hardware is built for
+    std::vector<stripe_t> stripes;
+    int stripe_width = stripe_split(IMAGE_WIDTH, STRIPE_WIDTH, stripes);
+    assert(stripe_width == STRIPE_IMAGE_WIDTH);
+    assert((int)stripes.size() == NUM_STRIPES);
+#endif /* STRIPE_WIDTH */
+
+    // Setup each frame with its own buffers, all of them free to start with
+    frame_t frames[NUM_FRAME_BUFFERS];
+    frame_t *free_frames[NUM_FRAME_BUFFERS];
+    for (int i = 0; i < NUM_FRAME_BUFFERS; i++) {
+        frames[i].image = &IMAGES[i];
+        frames[i].bboxes = BBOX_LISTS[i];
+#ifdef STRIPE_WIDTH
+        frames[i].stripes = stripes.data();
+        frames[i].stripe_images = STRIPE_IMAGES[i];
+        frames[i].stripe_bboxes = STRIPE_BBOX_LISTS[i][0];
+#endif /* STRIPE_WIDTH */
+        free_frames[i] = &frames[i];
+    }
+    int num_free = NUM_FRAME_BUFFERS;
+
+    stream_mux_t mux;
+    int rc = stream_mux_init(mux, NUM_CAMERAS, CAMERA_CREDITS);
+    assert(rc == 0);
+
+    /* Read the next image from each camera with a free buffer, and queue them
+     * on the FPGA, taking turns between the cameras. The frames complete in
+     * the order they were queued, so the oldest one is waited on and saved,
+     * freeing its buffers for the next image from its camera. */
+    frame_t *in_flight[NUM_FRAME_BUFFERS];
+    int oldest = 0;
+    int num_in_flight = 0;
+    for (int index = 0; ; ) {
+        for (int i = 0; i < NUM_CAMERAS; i++) {
+            camera_t& camera = cameras[i];
+            if (camera.done || !stream_mux_can_push(mux, i)) {
+                continue;
+            }
+
+            // The credits never exceed the buffers, so one is always free
+            frame_t& next = *free_frames[--num_free];
+            next.index = index;
+            rc = load_frame(camera.image_path, &camera.image_dir, next);
+            if (rc != XST_SUCCESS) {
+                return rc;
+            }
+            if (strlen(next.name) == 0) {
+                camera.done = true;
+                free_frames[num_free++] = &next;
+                continue;
+            }
+
+            stream_mux_push(mux, i, &next, next.tag);
+            index++;
+        }
+
+        // Queue blob detection on the frames, in the cameras' turns
+        frame_t *next;
+        stream_tag_t tag;
+        while ((next = (frame_t *)stream_mux_pop(mux, tag)) != NULL) {
+            rc = start_frame(dma, *next);
+            if (rc != XST_SUCCESS) {
+                return rc;
+            }
+            in_flight[(oldest + num_in_flight) % NUM_FRAME_BUFFERS] = next;
+            num_in_flight++;
+        }
+
+        // Every camera with frames left has one in flight, so this is the end
+        if (num_in_flight == 0) {
             return XST_SUCCESS;
         }
 
-        // Run blob detection on this image, and save it to its output file
-        printf("\nRunning blob detection on file '%s' in '%s'...\n",
-                file_info.fname, image_dir_path);
-        int rc = blob_detection(axidma, image_dir_path, file_info.fname,
-                output_dir_path);
+        frame_t& frame = *in_flight[oldest];
+        oldest = (oldest + 1) % NUM_FRAME_BUFFERS;
+        num_in_flight--;
+        rc = finish_frame(dma, frame);
+        if (rc != XST_SUCCESS) {
+            return rc;
+        }
+
+        camera_t& camera = cameras[frame.tag.source];
+        log_verbose("\tSaving the bounding boxes to '%s'...\n",
+                camera.output_path);
+        rc = save_bboxes(camera.output_path, frame.name, frame.bboxes,
+                frame.num_bboxes);
         if (rc != XST_SUCCESS) {
             return rc;
         }
+        stream_mux_complete(mux, frame.tag);
+        free_frames[num_free++] = &frame;
     }
 }
 
+// Opens each camera's image directory, and creates its output directory
+static int open_cameras(camera_t *cameras)
+{
+    for (int i = 0; i < NUM_CAMERAS; i++) {
+        camera_t& camera = cameras[i];
+        camera.name = CAMERA_NAMES[i];
+        camera.done = false;
+        join_paths(IMAGE_DIR_PATH, camera.name, camera.image_path,
+                sizeof(camera.image_path));
+        join_paths(OUTPUT_DIR_PATH, camera.name, camera.output_path,
+                sizeof(camera.output_path));
+
+        FRESULT rc = f_opendir(&camera.image_dir, camera.image_path);
+        if (rc != FR_OK) {
+            log_err("%s: Unable to open input image directory.\n",
+                    camera.image_path);
+            return rc;
+        }
+
+        rc = f_mkdir(camera.output_path);
+        if (rc != FR_OK && rc != FR_EXIST) {
+            log_err("%s: Unable to create output directory.\n",
+                    camera.output_path);
+            return rc;
+        }
+    }
+
+    return XST_SUCCESS;
+}
+
 int main()
 {
     printf("\nBlob Detector Accelerator\n");
     printf("-------------------------\n");
 
     // Initialize the system, namely the SD card and AXI DMA
-    printf("Mounting the SD card and initializing AXI DMA devices...\n");
+    printf("Mounting the SD card, initializing AXI DMA devices, and loading "
+            "the ROI...\n");
     devices_context_t devices_context;
     int rc = init_devices(devices_context);
     if (rc != XST_SUCCESS) {
         return rc;
     }
 
-    // Open the input directory containing the images
-    FRESULT f_rc;
-    DIR input_dir;
-    f_rc = f_opendir(&input_dir, IMAGE_DIR_PATH);
-    if (f_rc != FR_OK) {
-        log_err("%s: Unable to open input image directory.\n", IMAGE_DIR_PATH);
-        return f_rc;
-    }
-
     // Create the output directory if it doesn't already exist
-    f_rc = f_mkdir(OUTPUT_DIR_PATH);
+    FRESULT f_rc = f_mkdir(OUTPUT_DIR_PATH);
     if (f_rc != FR_OK && f_rc != FR_EXIST) {
         log_err("%s: Unable to create output directory.\n", OUTPUT_DIR_PATH);
+        return f_rc;
+    }
+
+    // Open the input and output directories of each camera
+    camera_t cameras[NUM_CAMERAS];
+    rc = open_cameras(cameras);
+    if (rc != XST_SUCCESS) {
         return rc;
     }
 
-    // Run blob detection on all the images in the input directory
-    rc = run_blob_detections(devices_context.axidma, IMAGE_DIR_PATH, &input_dir,
-            OUTPUT_DIR_PATH);
+    // Run blob detection on all of the cameras' images, tracing it
+    trace_init(TRACE_EVENTS);
+    rc = run_blob_detections(devices_context.dma, cameras);
+    dma_destroy(devices_context.dma);
+    if (rc != XST_SUCCESS) {
+        return rc;
+    }
+
+    // Save the latency trace to the output directory
+    rc = save_trace(OUTPUT_DIR_PATH, TRACE_FILE_NAME);
     if (rc != XST_SUCCESS) {
         return rc;
     }
 
-    printf("\nBlob detection is complete. Output images can be found in %s.\n",
+    printf("\nBlob detection is complete. Bounding boxes can be found in %s.\n",
             OUTPUT_DIR_PATH);
     return XST_SUCCESS;
 }
@@ -0,0 +1,490 @@
+/**
+ * @file dma.cpp
+ * @date Friday, October 23, 2026 at 10:48:12 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of the asynchronous DMA transfers.
+ *
+ * On the Zynq, each transfer is a single descriptor in its direction's
+ * scatter-gather ring. The interrupt handler for each channel acknowledges the
+ * interrupt, and completes the transfers of the descriptors the engine has
+ * finished. The handlers preempt the main program, so a transfer's callback
+ * has always returned by the time the main program sees it complete, and
+ * dma_wait() sleeps the processor until the next interrupt. In the
+ * simulation, the worker completes the transfers and runs their callbacks
+ * while holding the engine's lock, and dma_wait() waits on the lock, so the
+ * same holds there.
+ *
+ * Both backends track the transfers in flight in each direction's queue, which
+ * is used to fail them if the engine stops.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstring>                  // Memory copy function
+
+#include <algorithm>                // Min function
+
+#ifdef DMA_XAXIDMA
+#include <xil_cache.h>              // Cache control functions
+#include <xil_exception.h>          // Processor exception handling
+#include <xparameters.h>            // Auto-generated params for FPGA IP
+#endif /* DMA_XAXIDMA */
+
+#include "dma.h"                    // Our interface
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+#ifdef DMA_XAXIDMA
+
+// The interrupt controller, and the interrupts of the DMA's two channels
+static const int GIC_ID             = XPAR_SCUGIC_SINGLE_DEVICE_ID;
+static const int SEND_INTR_ID       =
+        XPAR_FABRIC_INPUT_OUTPUT_DMA_MM2S_INTROUT_INTR;
+static const int RECEIVE_INTR_ID    =
+        XPAR_FABRIC_INPUT_OUTPUT_DMA_S2MM_INTROUT_INTR;
+
+// The priority of the interrupts, and their trigger type (rising edge)
+static const int INTR_PRIORITY      = 0xA0;
+static const int INTR_TRIGGER       = 0x3;
+
+#endif /* DMA_XAXIDMA */
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Fills in a transfer before it is started
+static void setup_transfer(dma_transfer_t& transfer, dma_direction direction,
+        void *buffer, size_t size, dma_callback_t callback, void *arg)
+{
+    transfer.direction = direction;
+    transfer.buffer = buffer;
+    transfer.size = size;
+    transfer.bytes_transferred = 0;
+    transfer.callback = callback;
+    transfer.arg = arg;
+    transfer.status.store(DMA_PENDING);
+}
+
+// Completes a transfer, and invokes its callback
+static void complete_transfer(dma_transfer_t *transfer, dma_status status,
+        size_t bytes_transferred)
+{
+    transfer->bytes_transferred = bytes_transferred;
+    transfer->status.store(status);
+    if (transfer->callback != NULL) {
+        transfer->callback(transfer, transfer->arg);
+    }
+}
+
+// Adds a transfer to the back of a queue, which must not be full
+static void queue_push(dma_queue_t& queue, dma_transfer_t *transfer)
+{
+    queue.transfers[(queue.head + queue.count) % DMA_RING_SIZE] = transfer;
+    queue.count += 1;
+}
+
+// Removes the oldest transfer from a queue, which must not be empty
+static dma_transfer_t *queue_pop(dma_queue_t& queue)
+{
+    dma_transfer_t *transfer = queue.transfers[queue.head];
+    queue.head = (queue.head + 1) % DMA_RING_SIZE;
+    queue.count -= 1;
+    return transfer;
+}
+
+// Fails all of the transfers in a queue
+static void fail_queue(dma_queue_t& queue)
+{
+    while (queue.count > 0) {
+        complete_transfer(queue_pop(queue), DMA_ERROR, 0);
+    }
+}
+
+#ifdef DMA_XAXIDMA
+
+// Returns the descriptor ring for a direction
+static XAxiDma_BdRing *direction_ring(dma_t& dma, dma_direction direction)
+{
+    return (direction == DMA_SEND) ? XAxiDma_GetTxRing(&dma.dev) :
+            XAxiDma_GetRxRing(&dma.dev);
+}
+
+// Handles an interrupt from one of the DMA's channels
+static void dma_interrupt(dma_t *dma, dma_direction direction)
+{
+    // Acknowledge the interrupt
+    XAxiDma_BdRing *ring = direction_ring(*dma, direction);
+    dma_queue_t& queue = dma->queues[direction];
+    u32 irq = XAxiDma_BdRingGetIrq(ring);
+    XAxiDma_BdRingAckIrq(ring, irq);
+
+    /* On an error, the engine halts, and has to be reset, which loses its
+     * rings, so fail everything in flight. The engine is unusable until it
+     * is initialized again. */
+    if ((irq & XAXIDMA_IRQ_ERROR_MASK) != 0) {
+        log_err("AXI DMA engine halted with an error.\n");
+        XAxiDma_Reset(&dma->dev);
+        dma->failed = true;
+        fail_queue(dma->queues[DMA_SEND]);
+        fail_queue(dma->queues[DMA_RECEIVE]);
+        return;
+    }
+
+    // Complete the transfers of the descriptors the engine has finished
+    XAxiDma_Bd *first_bd;
+    int num_bds = XAxiDma_BdRingFromHw(ring, XAXIDMA_ALL_BDS, &first_bd);
+    XAxiDma_Bd *bd = first_bd;
+    for (int i = 0; i < num_bds && queue.count > 0; i++) {
+        dma_transfer_t *transfer = queue_pop(queue);
+        size_t bytes_transferred = XAxiDma_BdGetActualLength(bd,
+                ring->MaxTransferLen);
+        bool failed = (XAxiDma_BdGetSts(bd) & XAXIDMA_BD_STS_ALL_ERR_MASK) != 0;
+
+        // Drop any stale lines, so the processor sees what the device wrote
+        if (direction == DMA_RECEIVE) {
+            Xil_DCacheInvalidateRange((UINTPTR)transfer->buffer,
+                    transfer->size);
+        }
+        complete_transfer(transfer, failed ? DMA_ERROR : DMA_DONE,
+                bytes_transferred);
+        bd = (XAxiDma_Bd *)XAxiDma_BdRingNext(ring, bd);
+    }
+    if (num_bds > 0) {
+        XAxiDma_BdRingFree(ring, num_bds, first_bd);
+    }
+}
+
+static void send_interrupt(void *arg)
+{
+    dma_interrupt((dma_t *)arg, DMA_SEND);
+}
+
+static void receive_interrupt(void *arg)
+{
+    dma_interrupt((dma_t *)arg, DMA_RECEIVE);
+}
+
+// Creates a direction's descriptor ring, and starts the channel
+static int setup_ring(dma_t& dma, dma_direction direction)
+{
+    XAxiDma_BdRing *ring = direction_ring(dma, direction);
+    XAxiDma_BdRingIntDisable(ring, XAXIDMA_IRQ_ALL_MASK);
+
+    // Interrupt after every descriptor, so each frame completes promptly
+    UINTPTR descriptors = (UINTPTR)dma.descriptors[direction];
+    int rc = XAxiDma_BdRingCreate(ring, descriptors, descriptors,
+            XAXIDMA_BD_MINIMUM_ALIGNMENT, DMA_RING_SIZE);
+    if (rc != XST_SUCCESS || XAxiDma_BdRingSetCoalesce(ring, 1, 0) !=
+            XST_SUCCESS) {
+        log_err("Unable to create the AXI DMA descriptor ring.\n");
+        return -1;
+    }
+
+    // Clear all of the descriptors, using a blank one as the template
+    XAxiDma_Bd template_bd;
+    XAxiDma_BdClear(&template_bd);
+    if (XAxiDma_BdRingClone(ring, &template_bd) != XST_SUCCESS) {
+        log_err("Unable to clear the AXI DMA descriptor ring.\n");
+        return -1;
+    }
+
+    XAxiDma_BdRingIntEnable(ring, XAXIDMA_IRQ_IOC_MASK |
+            XAXIDMA_IRQ_ERROR_MASK);
+    if (XAxiDma_BdRingStart(ring) != XST_SUCCESS) {
+        log_err("Unable to start the AXI DMA channel.\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+// Connects a channel's interrupt handler to the interrupt controller
+static int connect_interrupt(dma_t& dma, int interrupt_id,
+        Xil_InterruptHandler handler)
+{
+    XScuGic_SetPriorityTriggerType(&dma.gic, interrupt_id, INTR_PRIORITY,
+            INTR_TRIGGER);
+    int rc = XScuGic_Connect(&dma.gic, interrupt_id, handler, &dma);
+    if (rc != XST_SUCCESS) {
+        log_err("Unable to connect the handler for interrupt %d\n",
+                interrupt_id);
+        return -1;
+    }
+
+    XScuGic_Enable(&dma.gic, interrupt_id);
+    return 0;
+}
+
+// Queues a descriptor for the transfer on its direction's ring
+static int submit_descriptor(dma_t& dma, dma_transfer_t& transfer)
+{
+    XAxiDma_BdRing *ring = direction_ring(dma, transfer.direction);
+    XAxiDma_Bd *bd;
+    if (XAxiDma_BdRingAlloc(ring, 1, &bd) != XST_SUCCESS) {
+        log_err("Unable to allocate an AXI DMA descriptor.\n");
+        return -1;
+    }
+
+    // Each transfer is a whole packet, so it's both the start and the end
+    u32 control = (transfer.direction == DMA_SEND) ?
+            (XAXIDMA_BD_CTRL_TXSOF_MASK | XAXIDMA_BD_CTRL_TXEOF_MASK) : 0;
+    XAxiDma_BdSetBufAddr(bd, (UINTPTR)transfer.buffer);
+    XAxiDma_BdSetLength(bd, transfer.size, ring->MaxTransferLen);
+    XAxiDma_BdSetCtrl(bd, control);
+    XAxiDma_BdSetId(bd, (UINTPTR)&transfer);
+    if (XAxiDma_BdRingToHw(ring, 1, bd) != XST_SUCCESS) {
+        log_err("Unable to queue an AXI DMA descriptor.\n");
+        XAxiDma_BdRingUnAlloc(ring, 1, bd);
+        return -1;
+    }
+
+    return 0;
+}
+
+#else
+
+// Loops the sent data back, the default simulated device
+static int loopback_device(const void *input, size_t input_size, void *output,
+        size_t output_size, void *arg)
+{
+    (void)arg;
+    size_t size = std::min(input_size, output_size);
+    memcpy(output, input, size);
+    return size;
+}
+
+/* Runs the simulated device. Like the hardware, the device only consumes a
+ * sent buffer once there is a buffer to receive its output into, and it moves
+ * straight on to the next queued pair of buffers. */
+static void dma_worker(dma_t *dma)
+{
+    dma_queue_t& sends = dma->queues[DMA_SEND];
+    dma_queue_t& receives = dma->queues[DMA_RECEIVE];
+    std::unique_lock<std::mutex> guard(dma->lock);
+    while (true) {
+        dma->queued.wait(guard, [&] {
+            return dma->stopping || (sends.count > 0 && receives.count > 0);
+        });
+
+        // Fail any unpaired transfers once the engine is stopped
+        if (sends.count == 0 || receives.count == 0) {
+            fail_queue(sends);
+            fail_queue(receives);
+            dma->completed.notify_all();
+            return;
+        }
+
+        // Run the device without the lock, so more transfers can be queued
+        dma_transfer_t *send = sends.transfers[sends.head];
+        dma_transfer_t *receive = receives.transfers[receives.head];
+        guard.unlock();
+        int bytes_produced = dma->device(send->buffer, send->size,
+                receive->buffer, receive->size, dma->device_arg);
+        guard.lock();
+
+        queue_pop(sends);
+        queue_pop(receives);
+        if (bytes_produced < 0) {
+            complete_transfer(send, DMA_ERROR, 0);
+            complete_transfer(receive, DMA_ERROR, 0);
+        } else {
+            complete_transfer(send, DMA_DONE, send->size);
+            complete_transfer(receive, DMA_DONE, bytes_produced);
+        }
+        dma->completed.notify_all();
+    }
+}
+
+#endif /* DMA_XAXIDMA */
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+#ifdef DMA_XAXIDMA
+
+int dma_init(dma_t& dma, int device_id)
+{
+    dma.queues[DMA_SEND].head = dma.queues[DMA_SEND].count = 0;
+    dma.queues[DMA_RECEIVE].head = dma.queues[DMA_RECEIVE].count = 0;
+    dma.failed = false;
+
+    // Lookup the configuration for the AXI DMA device, and initialize it
+    XAxiDma_Config *config = XAxiDma_LookupConfig(device_id);
+    if (config == NULL) {
+        log_err("Unable to find AXI DMA device with id %d\n", device_id);
+        return -1;
+    }
+    int rc = XAxiDma_CfgInitialize(&dma.dev, config);
+    if (rc != XST_SUCCESS) {
+        log_err("Unable to initialize the AXI DMA device with id %d\n",
+                device_id);
+        return -1;
+    } else if (!XAxiDma_HasSg(&dma.dev)) {
+        log_err("AXI DMA device with id %d is not built with scatter-gather\n",
+                device_id);
+        return -1;
+    }
+
+    // Setup the descriptor rings of both channels
+    if (setup_ring(dma, DMA_SEND) != 0 || setup_ring(dma, DMA_RECEIVE) != 0) {
+        return -1;
+    }
+
+    // Initialize the interrupt controller, and route the exceptions to it
+    XScuGic_Config *gic_config = XScuGic_LookupConfig(GIC_ID);
+    if (gic_config == NULL || XScuGic_CfgInitialize(&dma.gic, gic_config,
+                gic_config->CpuBaseAddress) != XST_SUCCESS) {
+        log_err("Unable to initialize the interrupt controller\n");
+        return -1;
+    }
+    Xil_ExceptionInit();
+    Xil_ExceptionRegisterHandler(XIL_EXCEPTION_ID_INT,
+            (Xil_ExceptionHandler)XScuGic_InterruptHandler, &dma.gic);
+
+    // Connect the handlers for both channels, and enable the interrupts
+    if (connect_interrupt(dma, SEND_INTR_ID, send_interrupt) != 0 ||
+            connect_interrupt(dma, RECEIVE_INTR_ID, receive_interrupt) != 0) {
+        return -1;
+    }
+    Xil_ExceptionEnable();
+
+    return 0;
+}
+
+void dma_destroy(dma_t& dma)
+{
+    // The interrupt handler pops the queues, so wait on a snapshot of them
+    for (int i = 0; i < DMA_NUM_DIRECTIONS; i++) {
+        dma_queue_t queue = dma.queues[i];
+        for (int j = 0; j < queue.count; j++) {
+            dma_wait(dma, *queue.transfers[(queue.head + j) % DMA_RING_SIZE]);
+        }
+    }
+
+    XAxiDma_BdRingIntDisable(XAxiDma_GetTxRing(&dma.dev), XAXIDMA_IRQ_ALL_MASK);
+    XAxiDma_BdRingIntDisable(XAxiDma_GetRxRing(&dma.dev), XAXIDMA_IRQ_ALL_MASK);
+    XScuGic_Disconnect(&dma.gic, SEND_INTR_ID);
+    XScuGic_Disconnect(&dma.gic, RECEIVE_INTR_ID);
+}
+
+int dma_start(dma_t& dma, dma_transfer_t& transfer, dma_direction direction,
+        void *buffer, size_t size, dma_callback_t callback, void *arg)
+{
+    /* Write back the buffer, so the device reads the latest data, or doesn't
+     * have the data it writes overwritten by dirty lines being evicted. */
+    setup_transfer(transfer, direction, buffer, size, callback, arg);
+    Xil_DCacheFlushRange((UINTPTR)buffer, size);
+
+    /* The interrupt handler pops transfers off the queue, so keep it out
+     * while the transfer is queued, as it can complete immediately. */
+    int rc = -1;
+    dma_queue_t& queue = dma.queues[direction];
+    Xil_ExceptionDisable();
+    if (dma.failed) {
+        log_err("The AXI DMA engine has failed, and must be reinitialized.\n");
+    } else if (queue.count == DMA_RING_SIZE) {
+        log_err("The queue of transfers in this direction is full.\n");
+    } else if (submit_descriptor(dma, transfer) == 0) {
+        queue_push(queue, &transfer);
+        rc = 0;
+    }
+    Xil_ExceptionEnable();
+
+    if (rc != 0) {
+        transfer.status.store(DMA_ERROR);
+    }
+    return rc;
+}
+
+int dma_wait(dma_t& dma, dma_transfer_t& transfer)
+{
+    /* The transfer is completed by the interrupt handler, so sleep until the
+     * next interrupt instead of spinning. The check is made with interrupts
+     * masked, and WFI still wakes on a pending one, so one that arrives
+     * after the check isn't missed. Unmasking them lets the handler run. */
+    (void)dma;
+    Xil_ExceptionDisable();
+    while (!dma_done(transfer)) {
+        __asm__ __volatile__("wfi" ::: "memory");
+        Xil_ExceptionEnable();
+        Xil_ExceptionDisable();
+    }
+    Xil_ExceptionEnable();
+    return (transfer.status.load() == DMA_DONE) ? 0 : -1;
+}
+
+#else
+
+int dma_init(dma_t& dma, int device_id)
+{
+    (void)device_id;
+    dma.queues[DMA_SEND].head = dma.queues[DMA_SEND].count = 0;
+    dma.queues[DMA_RECEIVE].head = dma.queues[DMA_RECEIVE].count = 0;
+    dma.stopping = false;
+    dma.device = loopback_device;
+    dma.device_arg = NULL;
+    dma.worker = std::thread(dma_worker, &dma);
+    return 0;
+}
+
+void dma_destroy(dma_t& dma)
+{
+    {
+        std::lock_guard<std::mutex> guard(dma.lock);
+        dma.stopping = true;
+    }
+    dma.queued.notify_all();
+    dma.worker.join();
+}
+
+void dma_sim_set_device(dma_t& dma, dma_sim_device_t device, void *arg)
+{
+    std::lock_guard<std::mutex> guard(dma.lock);
+    dma.device = device;
+    dma.device_arg = arg;
+}
+
+int dma_start(dma_t& dma, dma_transfer_t& transfer, dma_direction direction,
+        void *buffer, size_t size, dma_callback_t callback, void *arg)
+{
+    {
+        std::lock_guard<std::mutex> guard(dma.lock);
+        dma_queue_t& queue = dma.queues[direction];
+        if (dma.stopping) {
+            log_err("The DMA engine has been stopped.\n");
+            transfer.status.store(DMA_ERROR);
+            return -1;
+        } else if (queue.count == DMA_RING_SIZE) {
+            log_err("The queue of transfers in this direction is full.\n");
+            transfer.status.store(DMA_ERROR);
+            return -1;
+        }
+
+        setup_transfer(transfer, direction, buffer, size, callback, arg);
+        queue_push(queue, &transfer);
+    }
+
+    dma.queued.notify_one();
+    return 0;
+}
+
+int dma_wait(dma_t& dma, dma_transfer_t& transfer)
+{
+    std::unique_lock<std::mutex> guard(dma.lock);
+    dma.completed.wait(guard, [&transfer] { return dma_done(transfer); });
+    return (transfer.status.load() == DMA_DONE) ? 0 : -1;
+}
+
+#endif /* DMA_XAXIDMA */
+
+bool dma_done(const dma_transfer_t& transfer)
+{
+    int status = transfer.status.load();
+    return status == DMA_DONE || status == DMA_ERROR;
+}
@@ -0,0 +1,202 @@
+/**
+ * @file dma.h
+ * @date Friday, October 23, 2026 at 09:26:51 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the asynchronous DMA transfers.
+ *
+ * A transfer is started with dma_start(), which returns as soon as the
+ * transfer is queued, so the processor can read the next image or save the
+ * last one while the frame is in flight. When the transfer completes, its
+ * status is updated and its callback, if any, is invoked. The caller can poll
+ * a transfer with dma_done(), or wait for it with dma_wait().
+ *
+ * There are two backends. When built with DMA_XAXIDMA defined, transfers run
+ * on the Zynq's AXI DMA engine, and complete from its interrupts, so callbacks
+ * run in interrupt context. Otherwise, transfers are simulated on Linux by a
+ * worker thread, which passes each sent buffer through a device function into
+ * the pending receive buffer, so callbacks run on the worker thread. In either
+ * case, callbacks must be short, and must not start or wait on transfers.
+ *
+ * Each direction has a queue of up to DMA_RING_SIZE transfers in flight, which
+ * complete in the order they were started. On the Zynq, the queue is backed by
+ * the engine's scatter-gather descriptor rings (so the AXI DMA must be built
+ * with scatter-gather enabled), so the engine moves straight on to the next
+ * queued frame without waiting for the processor to re-arm it. In the
+ * simulation, the worker pairs up the sent and received buffers in order.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef DMA_H_
+#define DMA_H_
+
+#include <stddef.h>             // Definition of size_t
+
+#include <atomic>               // Atomic types
+
+#ifdef DMA_XAXIDMA
+#include <xaxidma.h>            // Functions and definitions for AXI DMA
+#include <xscugic.h>            // Functions for the interrupt controller
+#else
+#include <condition_variable>   // Condition variable class
+#include <mutex>                // Mutex class
+#include <thread>               // Thread class
+#endif /* DMA_XAXIDMA */
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The maximum number of transfers queued in each direction.
+ **/
+static const int DMA_RING_SIZE = 8;
+
+/**
+ * The direction of a transfer, relative to the processor.
+ **/
+enum dma_direction {
+    DMA_SEND,                           // Memory to the device (MM2S)
+    DMA_RECEIVE,                        // The device to memory (S2MM)
+    DMA_NUM_DIRECTIONS,                 // The number of directions
+};
+
+/**
+ * The status of a transfer.
+ **/
+enum dma_status {
+    DMA_IDLE,                           // The transfer has not been started
+    DMA_PENDING,                        // The transfer is in flight
+    DMA_DONE,                           // The transfer completed successfully
+    DMA_ERROR,                          // The transfer failed
+};
+
+struct dma_transfer;
+
+/**
+ * The function called when a transfer completes, successfully or not.
+ **/
+typedef void (*dma_callback_t)(dma_transfer *transfer, void *arg);
+
+/**
+ * A single transfer. This must stay alive until the transfer completes.
+ **/
+typedef struct dma_transfer {
+    dma_direction direction;            // The direction of the transfer
+    void *buffer;                       // The buffer sent or received
+    size_t size;                        // The size of the buffer, in bytes
+    size_t bytes_transferred;           // The number of bytes transferred
+    dma_callback_t callback;            // Called on completion, or NULL
+    void *arg;                          // The argument to the callback
+    std::atomic<int> status;            // The transfer's dma_status
+
+    // Constructor, for a transfer that has not been started
+    dma_transfer() : direction(DMA_SEND), buffer(NULL), size(0),
+            bytes_transferred(0), callback(NULL), arg(NULL), status(DMA_IDLE) {}
+} dma_transfer_t;
+
+#ifndef DMA_XAXIDMA
+/**
+ * The simulated device, which consumes the sent buffer and produces the
+ * received one. It returns the number of bytes produced, or -1 on failure.
+ **/
+typedef int (*dma_sim_device_t)(const void *input, size_t input_size,
+        void *output, size_t output_size, void *arg);
+#endif /* DMA_XAXIDMA */
+
+/**
+ * The queue of transfers in flight in one direction, oldest first.
+ **/
+typedef struct dma_queue {
+    dma_transfer_t *transfers[DMA_RING_SIZE]; // The ring of transfers
+    int head;                           // The index of the oldest transfer
+    int count;                          // The number of transfers queued
+} dma_queue_t;
+
+/**
+ * A DMA engine, with a queue of transfers for each direction.
+ **/
+typedef struct dma {
+    dma_queue_t queues[DMA_NUM_DIRECTIONS]; // The transfers in flight
+#ifdef DMA_XAXIDMA
+    XAxiDma dev;                        // AXI DMA device structure
+    XScuGic gic;                        // The interrupt controller
+    bool failed;                        // Set when the engine has an error
+
+    // The scatter-gather descriptors of each direction's ring
+    alignas(XAXIDMA_BD_MINIMUM_ALIGNMENT)
+            XAxiDma_Bd descriptors[DMA_NUM_DIRECTIONS][DMA_RING_SIZE];
+#else
+    std::thread worker;                 // Runs the simulated device
+    std::mutex lock;                    // Protects the engine's state
+    std::condition_variable queued;     // Signalled when a transfer starts
+    std::condition_variable completed;  // Signalled when a transfer completes
+    bool stopping;                      // Set to stop the worker
+    dma_sim_device_t device;            // The simulated device
+    void *device_arg;                   // The argument to the device
+#endif /* DMA_XAXIDMA */
+} dma_t;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Initializes the DMA engine. On the Zynq, this sets up the engine and its
+ * interrupts. In the simulation, this starts the worker thread, with a device
+ * that loops the sent data back.
+ *
+ * @param dma The DMA engine.
+ * @param device_id The ID of the AXI DMA device, unused in the simulation.
+ * @return 0 on success, -1 on failure.
+ **/
+int dma_init(dma_t& dma, int device_id);
+
+/**
+ * Stops the DMA engine. In the simulation, the transfers in flight are
+ * completed first, and any sent buffer without a buffer to receive its output
+ * (or vice versa) is failed. On the Zynq, this waits for the transfers in
+ * flight to complete.
+ **/
+void dma_destroy(dma_t& dma);
+
+#ifndef DMA_XAXIDMA
+/**
+ * Replaces the simulated device. There must be no transfers in flight.
+ **/
+void dma_sim_set_device(dma_t& dma, dma_sim_device_t device, void *arg);
+#endif /* DMA_XAXIDMA */
+
+/**
+ * Starts a transfer, returning without waiting for it to complete. The
+ * transfer is queued behind the others in flight in the same direction.
+ *
+ * @param dma The DMA engine.
+ * @param transfer The transfer, which must outlive the transfer.
+ * @param direction The direction of the transfer.
+ * @param buffer The buffer sent or received.
+ * @param size The size of the buffer, in bytes.
+ * @param callback Called when the transfer completes, or NULL for none.
+ * @param arg The argument to the callback.
+ * @return 0 on success, -1 if the direction's queue is full or the transfer
+ *         could not be started.
+ **/
+int dma_start(dma_t& dma, dma_transfer_t& transfer, dma_direction direction,
+        void *buffer, size_t size, dma_callback_t callback=NULL,
+        void *arg=NULL);
+
+/**
+ * Returns true if the transfer has completed, successfully or not.
+ **/
+bool dma_done(const dma_transfer_t& transfer);
+
+/**
+ * Waits for a transfer to complete. On the Zynq, the processor sleeps until
+ * each interrupt, rather than spinning, while it waits.
+ *
+ * @return 0 if the transfer completed successfully, -1 otherwise.
+ **/
+int dma_wait(dma_t& dma, dma_transfer_t& transfer);
+
+#endif /* DMA_H_ */
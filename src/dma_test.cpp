@@ -0,0 +1,151 @@
+/**
+ * @file dma_test.cpp
+ * @date Friday, October 23, 2026 at 01:37:05 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for the simulated asynchronous DMA transfers.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+
+#include <algorithm>                // Min function
+#include <atomic>                   // Atomic types
+#include <vector>                   // Vector container
+
+#include "dma.h"                    // Asynchronous DMA transfers
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The size of the buffers sent and received
+static const size_t TEST_SIZE   = 4096;
+
+// The number of frames sent back to back
+static const int TEST_FRAMES    = 8;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+// Inverts the bytes of the input, and produces half as many bytes
+static int invert_device(const void *input, size_t input_size, void *output,
+        size_t output_size, void *arg)
+{
+    (void)arg;
+    const unsigned char *in = (const unsigned char *)input;
+    unsigned char *out = (unsigned char *)output;
+    size_t size = std::min(input_size, output_size) / 2;
+    for (size_t i = 0; i < size; i++) {
+        out[i] = ~in[i];
+    }
+    return size;
+}
+
+// Always fails, as if the device had an error
+static int failing_device(const void *input, size_t input_size, void *output,
+        size_t output_size, void *arg)
+{
+    (void)input;
+    (void)input_size;
+    (void)output;
+    (void)output_size;
+    (void)arg;
+    return -1;
+}
+
+// Counts the completed transfers
+static void count_completion(dma_transfer_t *transfer, void *arg)
+{
+    std::atomic<int> *completions = (std::atomic<int> *)arg;
+    assert(transfer->status.load() == DMA_DONE);
+    *completions += 1;
+}
+
+int main()
+{
+    dma_t dma;
+    int rc = dma_init(dma, 0);
+    assert(rc == 0);
+
+    // The default device loops the data back
+    std::vector<unsigned char> input(TEST_SIZE), output(TEST_SIZE);
+    for (size_t i = 0; i < TEST_SIZE; i++) {
+        input[i] = i;
+    }
+    dma_transfer_t send, receive;
+    assert(send.status.load() == DMA_IDLE && !dma_done(send));
+    rc = dma_start(dma, receive, DMA_RECEIVE, output.data(), output.size());
+    assert(rc == 0 && !dma_done(receive));
+    rc = dma_start(dma, send, DMA_SEND, input.data(), input.size());
+    assert(rc == 0);
+    rc = dma_wait(dma, receive);
+    assert(rc == 0 && receive.bytes_transferred == TEST_SIZE);
+    rc = dma_wait(dma, send);
+    assert(rc == 0 && send.bytes_transferred == TEST_SIZE);
+    assert(output == input);
+
+    // Stream frames back to back, with callbacks signalling completion
+    std::atomic<int> completions(0);
+    dma_sim_set_device(dma, invert_device, NULL);
+    for (int frame = 0; frame < TEST_FRAMES; frame++) {
+        input[0] = frame;
+        rc = dma_start(dma, receive, DMA_RECEIVE, output.data(),
+                output.size(), count_completion, &completions);
+        assert(rc == 0);
+        rc = dma_start(dma, send, DMA_SEND, input.data(), input.size(),
+                count_completion, &completions);
+        assert(rc == 0);
+        rc = dma_wait(dma, receive) | dma_wait(dma, send);
+        assert(rc == 0 && receive.bytes_transferred == TEST_SIZE / 2);
+        assert(output[0] == (unsigned char)~frame);
+    }
+    assert(completions == 2 * TEST_FRAMES);
+
+    // Queue a full ring of frames ahead, which complete in order
+    std::vector<unsigned char> inputs(DMA_RING_SIZE * TEST_SIZE);
+    std::vector<unsigned char> outputs(DMA_RING_SIZE * TEST_SIZE);
+    dma_transfer_t sends[DMA_RING_SIZE], receives[DMA_RING_SIZE];
+    for (int i = 0; i < DMA_RING_SIZE; i++) {
+        inputs[i * TEST_SIZE] = i;
+        rc = dma_start(dma, receives[i], DMA_RECEIVE, &outputs[i * TEST_SIZE],
+                TEST_SIZE);
+        assert(rc == 0);
+    }
+    rc = dma_start(dma, receive, DMA_RECEIVE, output.data(), output.size());
+    assert(rc == -1);
+
+    // The rejected transfer fails, rather than keeping its last status
+    assert(receive.status.load() == DMA_ERROR);
+    assert(dma_wait(dma, receive) == -1);
+    for (int i = 0; i < DMA_RING_SIZE; i++) {
+        rc = dma_start(dma, sends[i], DMA_SEND, &inputs[i * TEST_SIZE],
+                TEST_SIZE);
+        assert(rc == 0);
+    }
+    for (int i = 0; i < DMA_RING_SIZE; i++) {
+        rc = dma_wait(dma, receives[i]) | dma_wait(dma, sends[i]);
+        assert(rc == 0 && outputs[i * TEST_SIZE] == (unsigned char)~i);
+    }
+
+    // A device error fails both transfers
+    dma_sim_set_device(dma, failing_device, NULL);
+    rc = dma_start(dma, send, DMA_SEND, input.data(), input.size());
+    assert(rc == 0);
+    rc = dma_start(dma, receive, DMA_RECEIVE, output.data(), output.size());
+    assert(rc == 0);
+    assert(dma_wait(dma, send) == -1 && dma_wait(dma, receive) == -1);
+    assert(receive.status.load() == DMA_ERROR);
+
+    // An unpaired transfer fails when the engine is stopped
+    rc = dma_start(dma, send, DMA_SEND, input.data(), input.size());
+    assert(rc == 0);
+    dma_destroy(dma);
+    assert(send.status.load() == DMA_ERROR);
+
+    printf("DMA test passed.\n");
+    return 0;
+}
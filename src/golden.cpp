@@ -0,0 +1,392 @@
+/**
+ * @file golden.cpp
+ * @date Wednesday, October 21, 2026 at 10:04:52 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of the golden output files.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstdio>                   // C standard I/O library
+#include <cstdlib>                  // C standard library
+#include <cstring>                  // C string library
+
+#include <type_traits>              // Unsigned type trait
+
+#include "golden.h"                 // Our interface
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The magic number at the start of a golden file, and the format's version
+static const char GOLDEN_MAGIC[4]   = {'B', 'D', 'G', 'F'};
+static const uint16_t GOLDEN_VERSION = 1;
+
+// The size of a bounding box in the file, four 16-bit coordinates
+static const long GOLDEN_BBOX_SIZE  = 4 * sizeof(int16_t);
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Writes a value to the file in little-endian order, returning true on success
+template <typename T>
+static bool write_value(FILE *file, T value)
+{
+    // Store the bytes one at a time, so this doesn't depend on endianness
+    unsigned char bytes[sizeof(T)];
+    uint64_t bits = (uint64_t)value;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        bytes[i] = (bits >> (8 * i)) & 0xFF;
+    }
+    return fwrite(bytes, sizeof(bytes), 1, file) == 1;
+}
+
+// Reads a little-endian value from the file, returning true on success
+template <typename T>
+static bool read_value(FILE *file, T& value)
+{
+    unsigned char bytes[sizeof(T)];
+    if (fread(bytes, sizeof(bytes), 1, file) != 1) {
+        return false;
+    }
+
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        bits |= (uint64_t)bytes[i] << (8 * i);
+    }
+    value = (T)(typename std::make_unsigned<T>::type)bits;
+    return true;
+}
+
+// Returns the number of bytes left in the file, or -1 on failure
+static long remaining_bytes(FILE *file)
+{
+    long position = ftell(file);
+    if (position < 0 || fseek(file, 0, SEEK_END) != 0) {
+        return -1;
+    }
+
+    long end = ftell(file);
+    if (end < 0 || fseek(file, position, SEEK_SET) != 0) {
+        return -1;
+    }
+    return end - position;
+}
+
+// Writes the nonzero words of a packed mask to the file
+static bool write_plane(FILE *file, const std::vector<uint64_t>& mask)
+{
+    uint32_t num_words = 0;
+    for (size_t i = 0; i < mask.size(); i++) {
+        num_words += (mask[i] != 0);
+    }
+
+    bool ok = write_value(file, num_words);
+    for (size_t i = 0; i < mask.size() && ok; i++) {
+        if (mask[i] != 0) {
+            ok = write_value(file, (uint32_t)i) && write_value(file, mask[i]);
+        }
+    }
+
+    return ok;
+}
+
+// Reads the nonzero words of a packed mask from the file
+static bool read_plane(FILE *file, std::vector<uint64_t>& mask)
+{
+    uint32_t num_words;
+    if (!read_value(file, num_words)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < num_words; i++) {
+        uint32_t index;
+        uint64_t bits;
+        if (!read_value(file, index) || !read_value(file, bits) ||
+                index >= mask.size()) {
+            return false;
+        }
+        mask[index] = bits;
+    }
+
+    return true;
+}
+
+// Writes a single scale level of the frame to the file
+static bool write_scale(FILE *file, const golden_scale_t& scale)
+{
+    bool ok = write_value(file, (uint16_t)scale.scale) &&
+            write_value(file, (uint16_t)scale.planes) &&
+            write_value(file, (uint32_t)scale.width) &&
+            write_value(file, (uint32_t)scale.height);
+    if (ok && (scale.planes & GOLDEN_MONO_PLANE)) {
+        ok = write_plane(file, scale.mono);
+    }
+    if (ok && (scale.planes & GOLDEN_DETECTION_PLANE)) {
+        ok = write_plane(file, scale.detections);
+    }
+
+    ok = ok && write_value(file, (uint32_t)scale.bboxes.size());
+    for (size_t i = 0; i < scale.bboxes.size() && ok; i++) {
+        const bbox_t& bbox = scale.bboxes[i];
+        ok = write_value(file, bbox.x1) && write_value(file, bbox.y1) &&
+                write_value(file, bbox.x2) && write_value(file, bbox.y2);
+    }
+
+    return ok;
+}
+
+// Reads a single scale level of the frame from the file
+static bool read_scale(FILE *file, golden_scale_t& scale)
+{
+    uint16_t scale_factor, planes;
+    uint32_t width, height;
+    if (!read_value(file, scale_factor) || !read_value(file, planes) ||
+            !read_value(file, width) || !read_value(file, height)) {
+        return false;
+    }
+
+    scale.scale = scale_factor;
+    scale.planes = planes;
+    scale.width = width;
+    scale.height = height;
+    scale.mono.assign(scale.mask_words() * scale.height, 0);
+    scale.detections.assign(scale.mask_words() * scale.height, 0);
+    if ((planes & GOLDEN_MONO_PLANE) && !read_plane(file, scale.mono)) {
+        return false;
+    }
+    if ((planes & GOLDEN_DETECTION_PLANE) &&
+            !read_plane(file, scale.detections)) {
+        return false;
+    }
+
+    // Check the number of boxes against the file, before allocating them
+    uint32_t num_bboxes;
+    if (!read_value(file, num_bboxes)) {
+        return false;
+    }
+    long remaining = remaining_bytes(file);
+    if (remaining < 0 || num_bboxes > remaining / GOLDEN_BBOX_SIZE) {
+        return false;
+    }
+    scale.bboxes.resize(num_bboxes);
+    for (uint32_t i = 0; i < num_bboxes; i++) {
+        bbox_t& bbox = scale.bboxes[i];
+        if (!read_value(file, bbox.x1) || !read_value(file, bbox.y1) ||
+                !read_value(file, bbox.x2) || !read_value(file, bbox.y2)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Counts the pixels that differ between two packed masks
+static int mask_diffs(const std::vector<uint64_t>& expected,
+        const std::vector<uint64_t>& actual)
+{
+    int diffs = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        diffs += __builtin_popcountll(expected[i] ^ actual[i]);
+    }
+
+    return diffs;
+}
+
+// Returns true if every coordinate of the boxes is within the distance
+static bool bboxes_match(const bbox_t& a, const bbox_t& b, int distance)
+{
+    return abs(a.x1 - b.x1) <= distance && abs(a.y1 - b.y1) <= distance &&
+            abs(a.x2 - b.x2) <= distance && abs(a.y2 - b.y2) <= distance;
+}
+
+/* Matches the expected boxes against the actual ones, returning the number of
+ * expected boxes that have no match. Each actual box can match only one
+ * expected box. */
+static int unmatched_bboxes(const std::vector<bbox_t>& expected,
+        const std::vector<bbox_t>& actual, int distance)
+{
+    std::vector<bool> matched(actual.size(), false);
+    int unmatched = 0;
+    for (size_t i = 0; i < expected.size(); i++) {
+        size_t j = 0;
+        while (j < actual.size() && (matched[j] ||
+                !bboxes_match(expected[i], actual[j], distance))) {
+            j++;
+        }
+
+        if (j < actual.size()) {
+            matched[j] = true;
+        } else {
+            unmatched += 1;
+        }
+    }
+
+    return unmatched;
+}
+
+// Compares a single scale level of two frames
+static golden_diff_t compare_scale(const golden_scale_t& expected,
+        const golden_scale_t& actual, const golden_tolerance_t& tolerance)
+{
+    golden_diff_t diff;
+    diff.scale = expected.scale;
+    diff.pixels = expected.width * expected.height;
+    diff.mono_diffs = -1;
+    diff.detection_diffs = -1;
+    diff.passed = true;
+
+    // Compare the masks that both of the implementations produced
+    double max_mask_diffs = tolerance.mask_ratio * diff.pixels;
+    int planes = expected.planes & actual.planes;
+    if (planes & GOLDEN_MONO_PLANE) {
+        diff.mono_diffs = mask_diffs(expected.mono, actual.mono);
+        diff.passed &= (diff.mono_diffs <= max_mask_diffs);
+    }
+    if (planes & GOLDEN_DETECTION_PLANE) {
+        diff.detection_diffs = mask_diffs(expected.detections,
+                actual.detections);
+        diff.passed &= (diff.detection_diffs <= max_mask_diffs);
+    }
+
+    // Match up the bounding boxes in both directions
+    diff.expected_bboxes = expected.bboxes.size();
+    diff.missing_bboxes = unmatched_bboxes(expected.bboxes, actual.bboxes,
+            tolerance.bbox_distance);
+    diff.extra_bboxes = unmatched_bboxes(actual.bboxes, expected.bboxes,
+            tolerance.bbox_distance);
+    double max_bbox_diffs = tolerance.bbox_ratio * diff.expected_bboxes;
+    diff.passed &= (diff.missing_bboxes + diff.extra_bboxes <= max_bbox_diffs);
+
+    return diff;
+}
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+void golden_init(golden_frame_t& frame, int width, int height, int num_scales,
+        int scale_factor, int planes)
+{
+    frame.width = width;
+    frame.height = height;
+    frame.scales.resize(num_scales);
+
+    int scale = 1;
+    for (int i = 0; i < num_scales; i++) {
+        golden_scale_t& level = frame.scales[i];
+        level.scale = scale;
+        level.width = width / scale;
+        level.height = height / scale;
+        level.planes = planes;
+        level.mono.assign(level.mask_words() * level.height, 0);
+        level.detections.assign(level.mask_words() * level.height, 0);
+        level.bboxes.clear();
+        scale *= scale_factor;
+    }
+}
+
+void golden_set_pixel(const golden_scale_t& scale, std::vector<uint64_t>& mask,
+        int x, int y)
+{
+    mask[y * scale.mask_words() + x / GOLDEN_WORD_BITS] |= UINT64_C(1) <<
+            (x % GOLDEN_WORD_BITS);
+}
+
+int golden_write(const golden_frame_t& frame, const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        log_err("%s: Unable to open golden file for writing.\n", path);
+        return -1;
+    }
+
+    bool ok = fwrite(GOLDEN_MAGIC, sizeof(GOLDEN_MAGIC), 1, file) == 1 &&
+            write_value(file, GOLDEN_VERSION) &&
+            write_value(file, (uint16_t)frame.scales.size()) &&
+            write_value(file, (uint32_t)frame.width) &&
+            write_value(file, (uint32_t)frame.height);
+    for (size_t i = 0; i < frame.scales.size() && ok; i++) {
+        ok = write_scale(file, frame.scales[i]);
+    }
+
+    if (fclose(file) != 0 || !ok) {
+        log_err("%s: Unable to write golden file.\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+int golden_read(golden_frame_t& frame, const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        log_err("%s: Unable to open golden file.\n", path);
+        return -1;
+    }
+
+    // Check the header, then read in each scale level
+    char magic[sizeof(GOLDEN_MAGIC)];
+    uint16_t version, num_scales;
+    uint32_t width, height;
+    bool ok = fread(magic, sizeof(magic), 1, file) == 1 &&
+            memcmp(magic, GOLDEN_MAGIC, sizeof(magic)) == 0 &&
+            read_value(file, version) && version == GOLDEN_VERSION &&
+            read_value(file, num_scales) && read_value(file, width) &&
+            read_value(file, height);
+    if (ok) {
+        frame.width = width;
+        frame.height = height;
+        frame.scales.resize(num_scales);
+    }
+    for (size_t i = 0; i < frame.scales.size() && ok; i++) {
+        ok = read_scale(file, frame.scales[i]);
+    }
+    fclose(file);
+
+    if (!ok) {
+        log_err("%s: Golden file is malformed.\n", path);
+        return -1;
+    }
+
+    return 0;
+}
+
+int golden_compare(const golden_frame_t& expected,
+        const golden_frame_t& actual, const golden_tolerance_t& tolerance,
+        std::vector<golden_diff_t>& diffs)
+{
+    diffs.clear();
+    if (expected.width != actual.width || expected.height != actual.height ||
+            expected.scales.size() != actual.scales.size()) {
+        log_err("Golden frames differ in size: %dx%d with %zu scales, and "
+                "%dx%d with %zu scales.\n", expected.width, expected.height,
+                expected.scales.size(), actual.width, actual.height,
+                actual.scales.size());
+        return -1;
+    }
+
+    int rc = 0;
+    for (size_t i = 0; i < expected.scales.size(); i++) {
+        const golden_scale_t& expected_scale = expected.scales[i];
+        const golden_scale_t& actual_scale = actual.scales[i];
+        if (expected_scale.scale != actual_scale.scale ||
+                expected_scale.width != actual_scale.width ||
+                expected_scale.height != actual_scale.height) {
+            log_err("Golden frames differ in the size of scale level %zu.\n",
+                    i);
+            return -1;
+        }
+
+        diffs.push_back(compare_scale(expected_scale, actual_scale,
+                tolerance));
+        rc = diffs.back().passed ? rc : -1;
+    }
+
+    return rc;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file golden.h
+ * @date Wednesday, October 21, 2026 at 09:26:14 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the golden output files used for
+ * regression testing the blob detector implementations.
+ *
+ * A golden file holds the outputs of one implementation for one frame: for
+ * each scale level, the packed monochrome and blob detection masks, and the
+ * bounding boxes found at that level. The host detector, the HLS C-simulation
+ * of the hardware, and the MATLAB reference all write this format, so any two
+ * of them can be compared scale by scale.
+ *
+ * The file is little-endian, and consists of a header followed by each scale:
+ *      header: "BDGF", u16 version, u16 num_scales, u32 width, u32 height
+ *      scale:  u16 scale, u16 planes, u32 width, u32 height,
+ *              the monochrome plane, if (planes & GOLDEN_MONO_PLANE),
+ *              the detection plane, if (planes & GOLDEN_DETECTION_PLANE),
+ *              u32 num_bboxes, then num_bboxes * (i16 x1, y1, x2, y2)
+ *      plane:  u32 num_words, then num_words * (u32 index, u64 bits)
+ * The masks are mostly empty, so a plane only stores its nonzero words, along
+ * with their index in the packed plane.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef GOLDEN_H_
+#define GOLDEN_H_
+
+#include <stdint.h>             // Fixed-size integer types
+
+#include <vector>               // Vector container
+
+#include "bbox.h"               // Definition of a bounding box
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The number of pixels packed into each word of a mask. Masks are stored in
+ * row-major order, with each row padded out to a whole number of words, and
+ * the leftmost pixel of a word in its least significant bit.
+ **/
+static const int GOLDEN_WORD_BITS       = 64;
+
+/**
+ * Flags for which of the masks are present at a scale level. Every
+ * implementation produces bounding boxes, but not all of them produce both
+ * masks (e.g. the MATLAB reference does not threshold the full-scale image).
+ **/
+static const int GOLDEN_MONO_PLANE      = 0x1;
+static const int GOLDEN_DETECTION_PLANE = 0x2;
+
+/**
+ * The outputs of an implementation at a single scale level.
+ **/
+typedef struct golden_scale {
+    int scale;                          // Scale factor relative to the image
+    int width;                          // Width of the level, in pixels
+    int height;                         // Height of the level, in pixels
+    int planes;                         // Which masks are present
+    std::vector<uint64_t> mono;         // Packed monochrome values
+    std::vector<uint64_t> detections;   // Packed blob centerpoints
+    std::vector<bbox_t> bboxes;         // Boxes found at this level
+
+    // Returns the number of words per row of a mask
+    int mask_words() const
+    {
+        return (width + GOLDEN_WORD_BITS - 1) / GOLDEN_WORD_BITS;
+    }
+} golden_scale_t;
+
+/**
+ * The outputs of an implementation for a single frame.
+ **/
+typedef struct golden_frame {
+    int width;                          // Width of the full-resolution image
+    int height;                         // Height of the full-resolution image
+    std::vector<golden_scale_t> scales; // Outputs at each scale level
+} golden_frame_t;
+
+/**
+ * How far two golden frames are allowed to differ and still match. The default
+ * tolerance of zero requires the frames to be bit-exact.
+ **/
+typedef struct golden_tolerance {
+    double mask_ratio;          // Fraction of a mask's pixels that may differ
+    int bbox_distance;          // Max coordinate difference of matching boxes
+    double bbox_ratio;          // Fraction of boxes that may be unmatched
+
+    // Default constructor, for a bit-exact comparison
+    golden_tolerance() {
+        mask_ratio = 0.0;
+        bbox_distance = 0;
+        bbox_ratio = 0.0;
+    }
+} golden_tolerance_t;
+
+/**
+ * The differences found between two golden frames at a single scale level.
+ **/
+typedef struct golden_diff {
+    int scale;                  // Scale factor of the level
+    int pixels;                 // Number of pixels in the level
+    int mono_diffs;             // Monochrome pixels that differ, or -1
+    int detection_diffs;        // Detection pixels that differ, or -1
+    int expected_bboxes;        // Number of boxes expected
+    int missing_bboxes;         // Expected boxes with no match
+    int extra_bboxes;           // Actual boxes with no match
+    bool passed;                // True if the differences are in tolerance
+} golden_diff_t;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Initializes the golden frame for an image of the given size, with empty
+ * masks and no bounding boxes at each scale level.
+ *
+ * @param[out] frame The golden frame to initialize.
+ * @param width The width of the full-resolution image.
+ * @param height The height of the full-resolution image.
+ * @param num_scales The number of scale levels.
+ * @param scale_factor The amount each level is scaled down from the last.
+ * @param planes Which masks are present at each level.
+ **/
+void golden_init(golden_frame_t& frame, int width, int height, int num_scales,
+        int scale_factor, int planes);
+
+/**
+ * Sets the pixel at the given location in a packed mask.
+ *
+ * @param scale The scale level the mask belongs to.
+ * @param mask The packed mask, either the monochrome or detection plane.
+ * @param x The column of the pixel.
+ * @param y The row of the pixel.
+ **/
+void golden_set_pixel(const golden_scale_t& scale, std::vector<uint64_t>& mask,
+        int x, int y);
+
+/**
+ * Writes the golden frame to the given file.
+ *
+ * @return 0 on success, -1 if the file cannot be written.
+ **/
+int golden_write(const golden_frame_t& frame, const char *path);
+
+/**
+ * Reads the golden frame from the given file.
+ *
+ * @return 0 on success, -1 if the file cannot be read or is malformed.
+ **/
+int golden_read(golden_frame_t& frame, const char *path);
+
+/**
+ * Compares the actual outputs of an implementation against the expected ones,
+ * scale level by scale level.
+ *
+ * Masks are compared pixel by pixel, if both frames have them. Bounding boxes
+ * match if each of their coordinates are within the tolerance's distance, and
+ * each box can only match one other box.
+ *
+ * @param[in] expected The expected (golden) outputs.
+ * @param[in] actual The outputs of the implementation being tested.
+ * @param[in] tolerance How far the outputs are allowed to differ.
+ * @param[out] diffs The differences found at each scale level.
+ * @return 0 if the frames match within the tolerance, -1 otherwise.
+ **/
+int golden_compare(const golden_frame_t& expected,
+        const golden_frame_t& actual, const golden_tolerance_t& tolerance,
+        std::vector<golden_diff_t>& diffs);
+
+#endif /* GOLDEN_H_ */
@@ -0,0 +1,244 @@
+/**
+ * @file golden_regression.cpp
+ * @date Wednesday, October 21, 2026 at 11:37:45 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the application that runs the golden regression tests.
+ *
+ * The application runs the host detector on raw RGBA image files, and either
+ * records its outputs as the golden files for the images, or compares its
+ * outputs against the existing golden files, printing a report for each scale
+ * level. The golden file for an image is <golden_dir>/<image name>.golden. It
+ * can also compare two golden files directly, such as the outputs of the HLS
+ * C-simulation against those of the MATLAB reference.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstdlib>                  // C standard library
+#include <cstdio>                   // C standard I/O library
+#include <cstring>                  // C string library
+
+#include <unistd.h>                 // Command line option parsing
+
+#include <string>                   // String class
+#include <vector>                   // Vector container
+
+#include "host_detector.h"          // Host detector interface
+#include "golden.h"                 // Golden output files
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The maximum number of bounding boxes recorded for a single image
+static const int MAX_BBOXES     = 4096;
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+static void print_usage(const char *program)
+{
+    printf("Usage: %s [-u] [-m mask_ratio] [-b bbox_distance] "
+            "[-x bbox_ratio] <width> <height> <golden_dir> <image> "
+            "[image ...]\n", program);
+    printf("       %s [-m mask_ratio] [-b bbox_distance] [-x bbox_ratio] "
+            "-c <expected.golden> <actual.golden>\n", program);
+    printf("\t-u\tUpdate the golden files with the host detector's outputs.\n");
+    printf("\t-c\tCompare two golden files, instead of running the host "
+            "detector.\n");
+    printf("\t-m\tFraction of each mask's pixels that may differ.\n");
+    printf("\t-b\tMaximum coordinate difference of matching boxes.\n");
+    printf("\t-x\tFraction of each scale's boxes that may be unmatched.\n");
+}
+
+static int read_image(const char *path, std::vector<pixel_t>& image)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        log_err("%s: Unable to open input image file.\n", path);
+        return -1;
+    }
+
+    size_t pixels_read = fread(image.data(), sizeof(pixel_t), image.size(),
+            file);
+    fclose(file);
+    if (pixels_read != image.size()) {
+        log_err("%s: File size does not match input image's. Expected %zu "
+                "bytes, but read %zu.\n", path, image.size() * sizeof(pixel_t),
+                pixels_read * sizeof(pixel_t));
+        return -1;
+    }
+
+    return 0;
+}
+
+// Returns the path of the golden file for the given image
+static std::string golden_path(const char *golden_dir, const char *image_path)
+{
+    const char *name = strrchr(image_path, '/');
+    name = (name == NULL) ? image_path : name + 1;
+    return std::string(golden_dir) + "/" + name + ".golden";
+}
+
+/* Records the outputs of the host detector's last frame in the golden frame.
+ * The detection plane is only written for occupied tiles, so words in empty
+ * tiles are left out, and each box is assigned to a scale level by its size. */
+static void record_outputs(const host_detector_t& detector,
+        const bbox_t *bboxes, int num_bboxes, golden_frame_t& frame)
+{
+    golden_init(frame, detector.width, detector.height, NUM_SCALES,
+            DOWNSCALE_FACTOR, GOLDEN_MONO_PLANE | GOLDEN_DETECTION_PLANE);
+    for (int i = 0; i < NUM_SCALES; i++) {
+        const scale_level_t& level = detector.levels[i];
+        golden_scale_t& scale = frame.scales[i];
+        scale.mono = level.mono;
+
+        for (int y = 0; y < level.height; y++) {
+            const uint64_t *occupancy = &level.occupancy[
+                    (y / OCCUPANCY_TILE_ROWS) * level.tile_words];
+            for (int word = 0; word < level.mask_words; word++) {
+                int index = y * level.mask_words + word;
+                bool occupied = (occupancy[word / MASK_WORD_BITS] >>
+                        (word % MASK_WORD_BITS)) & 1;
+                scale.detections[index] = occupied ?
+                        level.detections[index] : 0;
+            }
+        }
+    }
+
+    for (int i = 0; i < num_bboxes; i++) {
+        int box_scale = (bboxes[i].x2 - bboxes[i].x1) / (BLOB_FILTER_WIDTH + 1);
+        for (int j = 0; j < NUM_SCALES; j++) {
+            if (frame.scales[j].scale == box_scale) {
+                frame.scales[j].bboxes.push_back(bboxes[i]);
+            }
+        }
+    }
+}
+
+// Prints the differences found at each scale level, returning the frame's rc
+static int print_report(const char *name, const std::vector<golden_diff_t>&
+        diffs, int rc)
+{
+    printf("%s: %s\n", name, (rc == 0) ? "PASS" : "FAIL");
+    for (size_t i = 0; i < diffs.size(); i++) {
+        const golden_diff_t& diff = diffs[i];
+        printf("\tscale %2d: %s  mono %d, detections %d of %d pixels; "
+                "%d boxes, %d missing, %d extra\n", diff.scale,
+                diff.passed ? "PASS" : "FAIL", diff.mono_diffs,
+                diff.detection_diffs, diff.pixels, diff.expected_bboxes,
+                diff.missing_bboxes, diff.extra_bboxes);
+    }
+
+    return rc;
+}
+
+// Compares two golden files, printing the report
+static int compare_files(const char *expected_path, const char *actual_path,
+        const golden_tolerance_t& tolerance)
+{
+    golden_frame_t expected, actual;
+    if (golden_read(expected, expected_path) != 0 ||
+            golden_read(actual, actual_path) != 0) {
+        return -1;
+    }
+
+    std::vector<golden_diff_t> diffs;
+    int rc = golden_compare(expected, actual, tolerance, diffs);
+    return print_report(actual_path, diffs, rc);
+}
+
+/*----------------------------------------------------------------------------
+ * Main Application
+ *----------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    // Parse the command line options
+    golden_tolerance_t tolerance;
+    bool update = false;
+    bool compare = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "ucm:b:x:")) != -1) {
+        if (opt == 'u') {
+            update = true;
+        } else if (opt == 'c') {
+            compare = true;
+        } else if (opt == 'm') {
+            tolerance.mask_ratio = atof(optarg);
+        } else if (opt == 'b') {
+            tolerance.bbox_distance = atoi(optarg);
+        } else if (opt == 'x') {
+            tolerance.bbox_ratio = atof(optarg);
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (compare) {
+        if (argc - optind != 2) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        return (compare_files(argv[optind], argv[optind+1], tolerance) == 0) ?
+                EXIT_SUCCESS : EXIT_FAILURE;
+    } else if (argc - optind < 4) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    int width = atoi(argv[optind]);
+    int height = atoi(argv[optind+1]);
+    const char *golden_dir = argv[optind+2];
+
+    host_detector_t detector;
+    if (host_detector_init(detector, width, height) != 0) {
+        return EXIT_FAILURE;
+    }
+
+    // Run the host detector on each image, then record or check its outputs
+    std::vector<pixel_t> image(width * height);
+    std::vector<bbox_t> bboxes(MAX_BBOXES);
+    int failures = 0;
+    for (int i = optind + 3; i < argc; i++) {
+        if (read_image(argv[i], image) != 0) {
+            host_detector_destroy(detector);
+            return EXIT_FAILURE;
+        }
+
+        int num_bboxes = host_detect_blobs(detector, image.data(),
+                bboxes.data(), bboxes.size());
+        golden_frame_t actual;
+        record_outputs(detector, bboxes.data(), num_bboxes, actual);
+
+        std::string path = golden_path(golden_dir, argv[i]);
+        if (update) {
+            if (golden_write(actual, path.c_str()) != 0) {
+                host_detector_destroy(detector);
+                return EXIT_FAILURE;
+            }
+            printf("%s: Wrote %d blobs to %s\n", argv[i], num_bboxes,
+                    path.c_str());
+            continue;
+        }
+
+        golden_frame_t expected;
+        std::vector<golden_diff_t> diffs;
+        int rc = golden_read(expected, path.c_str());
+        if (rc == 0) {
+            rc = golden_compare(expected, actual, tolerance, diffs);
+        }
+        failures += (print_report(argv[i], diffs, rc) != 0);
+    }
+    host_detector_destroy(detector);
+
+    if (failures > 0) {
+        printf("%d of %d images failed.\n", failures, argc - optind - 3);
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file golden_test.cpp
+ * @date Wednesday, October 21, 2026 at 01:02:19 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for the golden output files.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+
+#include <vector>                   // Vector container
+
+#include "golden.h"                 // Golden output files
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The size of the test frame, and the number of scale levels in it
+static const int TEST_WIDTH     = 200;
+static const int TEST_HEIGHT    = 100;
+static const int TEST_SCALES    = 3;
+
+// The file the test frame is written to
+static const char TEST_PATH[]   = "golden_test.golden";
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+int main()
+{
+    golden_frame_t expected;
+    golden_init(expected, TEST_WIDTH, TEST_HEIGHT, TEST_SCALES, 2,
+            GOLDEN_MONO_PLANE | GOLDEN_DETECTION_PLANE);
+    assert(expected.scales[2].scale == 4 && expected.scales[2].width == 50);
+
+    golden_scale_t& scale = expected.scales[0];
+    golden_set_pixel(scale, scale.mono, 0, 0);
+    golden_set_pixel(scale, scale.mono, 199, 99);
+    golden_set_pixel(scale, scale.detections, 64, 50);
+    scale.bboxes.push_back(bbox_t(61, 47, 67, 53));
+    assert(scale.mask_words() == 4 && scale.mono[0] == 1);
+    assert(scale.mono[99 * 4 + 3] == (UINT64_C(1) << 7));
+
+    // The frame should be unchanged after a round trip through a file
+    golden_frame_t actual;
+    int rc = golden_write(expected, TEST_PATH);
+    assert(rc == 0);
+    rc = golden_read(actual, TEST_PATH);
+    assert(rc == 0);
+
+    // The header is little-endian, whatever the host's byte order
+    FILE *file = fopen(TEST_PATH, "r+b");
+    assert(file != NULL);
+    unsigned char header[16];
+    assert(fread(header, sizeof(header), 1, file) == 1);
+    assert(header[4] == 1 && header[5] == 0 && header[6] == TEST_SCALES);
+    assert(header[8] == TEST_WIDTH && header[9] == 0 && header[12] ==
+            TEST_HEIGHT);
+
+    /* A count of boxes larger than the rest of the file is rejected, rather
+     * than allocated. The last scale's count is at the end of the file. */
+    const unsigned char bad_count[4] = {0xF0, 0xFF, 0xFF, 0xFF};
+    assert(fseek(file, -(long)sizeof(bad_count), SEEK_END) == 0);
+    assert(fwrite(bad_count, sizeof(bad_count), 1, file) == 1);
+    fclose(file);
+    golden_frame_t corrupt;
+    assert(golden_read(corrupt, TEST_PATH) == -1);
+    remove(TEST_PATH);
+
+    std::vector<golden_diff_t> diffs;
+    golden_tolerance_t tolerance;
+    rc = golden_compare(expected, actual, tolerance, diffs);
+    assert(rc == 0 && diffs.size() == TEST_SCALES);
+    assert(diffs[0].mono_diffs == 0 && diffs[0].expected_bboxes == 1);
+
+    // A moved box and a flipped pixel only pass with a tolerance
+    actual.scales[0].bboxes[0] = bbox_t(62, 47, 68, 53);
+    golden_set_pixel(actual.scales[0], actual.scales[0].mono, 10, 10);
+    rc = golden_compare(expected, actual, tolerance, diffs);
+    assert(rc == -1 && !diffs[0].passed && diffs[1].passed);
+    assert(diffs[0].mono_diffs == 1 && diffs[0].missing_bboxes == 1 &&
+            diffs[0].extra_bboxes == 1);
+
+    tolerance.mask_ratio = 1e-4;
+    tolerance.bbox_distance = 1;
+    rc = golden_compare(expected, actual, tolerance, diffs);
+    assert(rc == 0 && diffs[0].missing_bboxes == 0);
+
+    // Planes that only one of the frames has are not compared
+    actual.scales[0].planes = GOLDEN_DETECTION_PLANE;
+    rc = golden_compare(expected, actual, tolerance, diffs);
+    assert(rc == 0 && diffs[0].mono_diffs == -1);
+
+    printf("Golden file test passed.\n");
+    return 0;
+}
@@ -0,0 +1,415 @@
+/**
+ * @file host_blob_detector.cpp
+ * @date Monday, October 19, 2026 at 01:52:06 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the application that runs the host blob detector.
+ *
+ * The application runs blob detection on raw image files using the host
+ * (software) detector, and prints the bounding boxes found in each image. An
+ * optional region-of-interest mask is loaded at startup, and is used for all
+ * of the images.
+ *
+ * The images are raw RGBA by default. Camera frames can be passed as they are
+ * with -f: NV12 and I420 frames only have their luma plane read, and raw Bayer
+ * frames are demosaiced to luma by the detector.
+ *
+ * With -c, only the given number of the coarsest scale levels are searched in
+ * full, and the finer levels are only searched around the blobs found above
+ * them, within the margin given with -m.
+ *
+ * With -a, the monochrome threshold follows the brightness of the images: the
+ * histogram of each image picks the threshold used for the next one.
+ *
+ * With -k, the images are treated as consecutive frames, and the boxes are
+ * tracked across them, so each box is printed with the ID and velocity of the
+ * blob it belongs to.
+ *
+ * With -S, each image is split into vertical stripes of the given width, which
+ * are run through a detector only as wide as a stripe and its halos, and the
+ * boxes of the stripes are stitched back together. The boxes are the same as
+ * those found in the whole image, though pruning and the adaptive thresholds
+ * only see one stripe at a time.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstdlib>                  // C standard library
+#include <cstdio>                   // C standard I/O library
+#include <cstring>                  // String comparison
+
+#include <unistd.h>                 // Command line option parsing
+
+#include <vector>                   // Vector container
+
+#include "host_detector.h"          // Host detector interface
+#include "roi_mask.h"               // Region of interest mask
+#include "stripe.h"                 // Splitting images into stripes
+#include "tracker.h"                // Blob tracker
+#include "trace.h"                  // Latency tracer
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The maximum number of bounding boxes reported for a single image
+static const int MAX_BBOXES     = 1024;
+
+// The maximum number of events each thread records when tracing
+static const size_t TRACE_EVENTS = 1 << 16;
+
+// An input format accepted on the command line
+typedef struct format_option {
+    const char *name;               // The name of the format
+    input_format_t format;          // The format the detector reads
+    size_t pixel_size;              // Bytes read per pixel of the image
+} format_option_t;
+
+/* The input formats. NV12 and I420 start with their luma plane, so only it is
+ * read, and the chroma planes after it are ignored. */
+static const format_option_t FORMATS[] = {
+    {"rgba", INPUT_RGBA, sizeof(pixel_t)},
+    {"luma", INPUT_LUMA, 1},
+    {"nv12", INPUT_LUMA, 1},
+    {"i420", INPUT_LUMA, 1},
+    {"bayer_rggb", INPUT_BAYER_RGGB, 1},
+    {"bayer_bggr", INPUT_BAYER_RGGB, 1},
+    {"bayer_grbg", INPUT_BAYER_GRBG, 1},
+    {"bayer_gbrg", INPUT_BAYER_GRBG, 1},
+};
+static const int NUM_FORMATS    = sizeof(FORMATS) / sizeof(FORMATS[0]);
+
+// A monochrome threshold mode accepted on the command line
+typedef struct threshold_option {
+    const char *name;               // The name of the mode
+    threshold_mode_t mode;          // The mode the detector uses
+} threshold_option_t;
+
+static const threshold_option_t THRESHOLDS[] = {
+    {"fixed", THRESHOLD_FIXED},
+    {"percentile", THRESHOLD_PERCENTILE},
+    {"otsu", THRESHOLD_OTSU},
+};
+static const int NUM_THRESHOLDS = sizeof(THRESHOLDS) / sizeof(THRESHOLDS[0]);
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+static void print_usage(const char *program)
+{
+    printf("Usage: %s [-t] [-s] [-T trace] [-r roi_mask] [-f format] "
+            "[-a threshold] [-b box_size] [-c coarse_levels] [-m margin] "
+            "[-k distance] [-S stripe_width] <width> <height> <image> "
+            "[image ...]\n", program);
+    printf("\t-t\tRun the stages of the detector on multiple threads.\n");
+    printf("\t-s\tPrint the detector's statistics after the last image.\n");
+    printf("\t-T\tSave a trace of the stages' latencies as Chrome trace "
+            "JSON.\n");
+    printf("\t-f\tThe format of the images, one of:");
+    for (int i = 0; i < NUM_FORMATS; i++) {
+        printf(" %s", FORMATS[i].name);
+    }
+    printf(" (default rgba).\n");
+    printf("\t-a\tHow the monochrome threshold is chosen for each frame from "
+            "the last, one of:");
+    for (int i = 0; i < NUM_THRESHOLDS; i++) {
+        printf(" %s", THRESHOLDS[i].name);
+    }
+    printf(" (default fixed).\n");
+    printf("\t-b\tDetect with a box filter of the given odd size, instead of "
+            "the LoG filter.\n");
+    printf("\t-c\tSearch only the given number of the coarsest levels in "
+            "full, and prune the rest.\n");
+    printf("\t-m\tThe margin searched around the coarser levels' blobs when "
+            "pruning (default %d).\n", PRUNE_DEFAULT_MARGIN);
+    printf("\t-k\tTrack the blobs across the images, associating boxes within "
+            "the given distance (e.g. %d).\n", TRACKER_DEFAULT_MAX_DISTANCE);
+    printf("\t-S\tProcess the images in vertical stripes of the given width, a "
+            "multiple of %d.\n", STRIPE_ALIGN);
+}
+
+// Finds the input format with the given name
+static const format_option_t *find_format(const char *name)
+{
+    for (int i = 0; i < NUM_FORMATS; i++) {
+        if (strcmp(FORMATS[i].name, name) == 0) {
+            return &FORMATS[i];
+        }
+    }
+
+    log_err("%s: Unknown image format.\n", name);
+    return NULL;
+}
+
+// Finds the threshold mode with the given name
+static const threshold_option_t *find_threshold(const char *name)
+{
+    for (int i = 0; i < NUM_THRESHOLDS; i++) {
+        if (strcmp(THRESHOLDS[i].name, name) == 0) {
+            return &THRESHOLDS[i];
+        }
+    }
+
+    log_err("%s: Unknown threshold mode.\n", name);
+    return NULL;
+}
+
+static int read_image(const char *path, std::vector<uint8_t>& image)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        log_err("%s: Unable to open input image file.\n", path);
+        return -1;
+    }
+
+    size_t bytes_read = fread(image.data(), 1, image.size(), file);
+    fclose(file);
+    if (bytes_read != image.size()) {
+        log_err("%s: File size does not match input image's. Expected %zu "
+                "bytes, but read %zu.\n", path, image.size(), bytes_read);
+        return -1;
+    }
+
+    return 0;
+}
+
+/* Runs blob detection on each stripe of the image, and stitches their boxes
+ * together, sorted in the canonical order (see stripe.h). */
+static int detect_stripes(host_detector_t& detector, bool threaded,
+        const std::vector<stripe_t>& stripes, const std::vector<uint8_t>& image,
+        int width, size_t pixel_size, std::vector<uint8_t>& stripe_image,
+        std::vector<bbox_t>& stripe_bboxes, std::vector<bbox_t>& bboxes)
+{
+    int num_bboxes = 0;
+    for (size_t i = 0; i < stripes.size(); i++) {
+        {
+            trace_scope trace("copy stripe");
+            stripe_copy(image.data(), width, detector.height,
+                    pixel_size, stripes[i], stripe_image.data());
+        }
+
+        int num_stripe_bboxes = threaded ?
+                host_detect_blobs_threaded(detector, stripe_image.data(),
+                        stripe_bboxes.data(), stripe_bboxes.size()) :
+                host_detect_blobs(detector, stripe_image.data(),
+                        stripe_bboxes.data(), stripe_bboxes.size());
+        num_bboxes += stripe_stitch(stripes[i], stripe_bboxes.data(),
+                num_stripe_bboxes, &bboxes[num_bboxes],
+                bboxes.size() - num_bboxes);
+    }
+
+    stripe_sort(bboxes.data(), num_bboxes);
+    return num_bboxes;
+}
+
+// Prints the statistics for each scale level, averaged over the frames
+static void print_stats(const host_detector_t& detector)
+{
+    host_stats_t stats;
+    host_detector_stats(detector, stats);
+    if (!HOST_STATS_ENABLED || stats.frames == 0) {
+        printf("No statistics, build with HOST_DETECTOR_STATS to enable "
+                "them.\n");
+        return;
+    }
+
+    const double NS_PER_US = 1000.0;
+    double frames = stats.frames;
+    printf("\n%llu frames, %.1f us per frame, next threshold %d\n",
+            (unsigned long long)stats.frames, stats.frame_ns / NS_PER_US /
+            frames, stats.threshold);
+    printf("scale   pixels in  pixels out  density  detections  boxes  dropped"
+            "  pruned  pyramid  mono  detect  boxes (us)\n");
+    for (int i = 0; i < NUM_SCALES; i++) {
+        const scale_stats_t& scale = stats.scales[i];
+        double density = (scale.pixels_out == 0) ? 0.0 :
+                (double)scale.mono_pixels / scale.pixels_out;
+        printf("%5d  %10.0f  %10.0f  %7.4f  %10.1f  %5.1f  %7.1f  %6.1f  %7.1f"
+                "  %4.1f  %6.1f  %5.1f\n", detector.levels[i].scale,
+                scale.pixels_in / frames, scale.pixels_out / frames, density,
+                scale.detections / frames, scale.bboxes / frames,
+                scale.dropped_bboxes / frames, scale.pruned_tiles / frames,
+                scale.stage_ns[STAGE_PYRAMID] / NS_PER_US / frames,
+                scale.stage_ns[STAGE_MONOCHROME] / NS_PER_US / frames,
+                scale.stage_ns[STAGE_DETECTION] / NS_PER_US / frames,
+                scale.stage_ns[STAGE_BBOXES] / NS_PER_US / frames);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Main Application
+ *----------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    // Parse the command line options
+    const char *roi_path = NULL;
+    bool threaded = false;
+    const char *trace_path = NULL;
+    bool show_stats = false;
+    const format_option_t *format = &FORMATS[0];
+    const threshold_option_t *threshold = &THRESHOLDS[0];
+    int box_size = 0;
+    int coarse_levels = NUM_SCALES;
+    int margin = PRUNE_DEFAULT_MARGIN;
+    int track_distance = 0;
+    int stripe_width = 0;
+    int opt;
+    while ((opt = getopt(argc, argv, "tsT:r:f:a:b:c:m:k:S:")) != -1) {
+        if (opt == 'r') {
+            roi_path = optarg;
+        } else if (opt == 'f') {
+            format = find_format(optarg);
+            if (format == NULL) {
+                return EXIT_FAILURE;
+            }
+        } else if (opt == 'a') {
+            threshold = find_threshold(optarg);
+            if (threshold == NULL) {
+                return EXIT_FAILURE;
+            }
+        } else if (opt == 'b') {
+            box_size = atoi(optarg);
+        } else if (opt == 'c') {
+            coarse_levels = atoi(optarg);
+        } else if (opt == 'm') {
+            margin = atoi(optarg);
+        } else if (opt == 'k') {
+            track_distance = atoi(optarg);
+            if (track_distance <= 0) {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (opt == 'S') {
+            stripe_width = atoi(optarg);
+        } else if (opt == 'T') {
+            trace_path = optarg;
+        } else if (opt == 't') {
+            threaded = true;
+        } else if (opt == 's') {
+            show_stats = true;
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind < 3) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    int width = atoi(argv[optind]);
+    int height = atoi(argv[optind+1]);
+
+    /* Split the images into stripes if specified, which the detector is sized
+     * for instead. The halos only cover the reach of the LoG filter, and the
+     * ROI mask covers the whole image. */
+    std::vector<stripe_t> stripes;
+    int detector_width = width;
+    if (stripe_width != 0) {
+        if (roi_path != NULL || box_size != 0) {
+            log_err("Stripes cannot be used with an ROI mask or box filter.\n");
+            return EXIT_FAILURE;
+        }
+        detector_width = stripe_split(width, stripe_width, stripes);
+        if (detector_width < 0) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Start tracing before the detector is initialized, which starts its
+     * detection threads. */
+    if (trace_path != NULL) {
+        trace_init(TRACE_EVENTS);
+        trace_thread_name("main");
+    }
+
+    // Initialize the detector, and load the region of interest if specified
+    host_detector_t detector;
+    if (host_detector_init(detector, detector_width, height) != 0) {
+        return EXIT_FAILURE;
+    }
+    host_detector_set_format(detector, format->format);
+    host_detector_set_threshold(detector, threshold->mode);
+    if (host_detector_set_box_filter(detector, box_size) != 0 ||
+            host_detector_set_pruning(detector, coarse_levels, margin) != 0) {
+        host_detector_destroy(detector);
+        return EXIT_FAILURE;
+    }
+    roi_mask_t roi;
+    if (roi_path != NULL) {
+        if (roi_mask_load(roi, roi_path, width, height) != 0 ||
+                host_detector_set_roi(detector, &roi) != 0) {
+            host_detector_destroy(detector);
+            return EXIT_FAILURE;
+        }
+    }
+    blob_tracker_t tracker;
+    if (track_distance > 0 && blob_tracker_init(tracker, width, height,
+            track_distance) != 0) {
+        host_detector_destroy(detector);
+        return EXIT_FAILURE;
+    }
+
+    // Run blob detection on each image, and print out the bounding boxes
+    std::vector<uint8_t> image(width * height * format->pixel_size);
+    std::vector<bbox_t> bboxes(MAX_BBOXES);
+    std::vector<tracked_bbox_t> tracked(MAX_BBOXES);
+    std::vector<uint8_t> stripe_image;
+    std::vector<bbox_t> stripe_bboxes;
+    if (!stripes.empty()) {
+        stripe_image.resize(detector_width * height * format->pixel_size);
+        stripe_bboxes.resize(MAX_BBOXES);
+    }
+    for (int i = optind + 2; i < argc; i++) {
+        {
+            trace_scope trace("read image");
+            if (read_image(argv[i], image) != 0) {
+                host_detector_destroy(detector);
+                return EXIT_FAILURE;
+            }
+        }
+
+        int num_bboxes;
+        if (!stripes.empty()) {
+            num_bboxes = detect_stripes(detector, threaded, stripes, image,
+                    width, format->pixel_size, stripe_image, stripe_bboxes,
+                    bboxes);
+        } else if (threaded) {
+            num_bboxes = host_detect_blobs_threaded(detector, image.data(),
+                    bboxes.data(), bboxes.size());
+        } else {
+            num_bboxes = host_detect_blobs(detector, image.data(),
+                    bboxes.data(), bboxes.size());
+        }
+        printf("%s: %d blobs\n", argv[i], num_bboxes);
+        if (track_distance > 0) {
+            trace_scope trace("tracking");
+            blob_tracker_update(tracker, bboxes.data(), num_bboxes,
+                    tracked.data());
+            for (int j = 0; j < num_bboxes; j++) {
+                const tracked_bbox_t& box = tracked[j];
+                printf("\t(%d, %d), (%d, %d) #%u (%.1f, %.1f)\n", box.bbox.x1,
+                        box.bbox.y1, box.bbox.x2, box.bbox.y2, box.id, box.vx,
+                        box.vy);
+            }
+        } else {
+            for (int j = 0; j < num_bboxes; j++) {
+                printf("\t(%d, %d), (%d, %d)\n", bboxes[j].x1, bboxes[j].y1,
+                        bboxes[j].x2, bboxes[j].y2);
+            }
+        }
+    }
+
+    if (show_stats) {
+        print_stats(detector);
+    }
+
+    // Stop the detection threads before their events are saved
+    host_detector_destroy(detector);
+    if (trace_path != NULL && trace_save(trace_path) != 0) {
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
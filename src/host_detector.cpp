@@ -0,0 +1,1123 @@
+/**
+ * @file host_detector.cpp
+ * @date Monday, October 19, 2026 at 11:42:19 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of the host (software) blob detector.
+ *
+ * Each stage of the hardware pipeline is implemented as a pass over a scale
+ * level, and only visits the pixels inside the region of interest. Pixels
+ * outside of the region are never written, so their monochrome values stay
+ * zero, which matches dropping them before the monochrome stage.
+ *
+ * The monochrome plane is packed into bits, and each level keeps an occupancy
+ * bit per tile, so the LoG filter and the bounding box scan skip empty tiles.
+ * When the finer levels are pruned, the tiles outside of their search are
+ * cleared from the occupancy, so they are skipped the same way.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <algorithm>                // Min and max functions
+#include <cstring>                  // Memset function
+#include <chrono>                   // Clocks for timing the stages
+#include <functional>               // Reference wrapper function
+#include <thread>                   // Thread class
+
+#include "host_detector.h"          // Our interface
+#include "trace.h"                  // Latency tracer
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+/* The number of full-resolution rows in a band of the pyramid, which is one row
+ * of occupancy tiles at the smallest scale level, and the number of batches in
+ * the rings between the pyramid and detection threads. */
+static const int PYRAMID_BAND_ROWS      = OCCUPANCY_TILE_ROWS << (NUM_SCALES-1);
+static const int RING_SLOTS             = 4;
+
+/* The LoG filter and threshold used for detection, which are the narrow weights
+ * when built with NARROW_LOG_FILTER defined. */
+#ifdef NARROW_LOG_FILTER
+static const int (&DETECTION_FILTER)[BLOB_FILTER_HEIGHT][BLOB_FILTER_WIDTH] =
+        LOG_NARROW_FILTER;
+static const int DETECTION_THRESHOLD    = LOG_NARROW_RESPONSE_THRESHOLD;
+#else
+static const int (&DETECTION_FILTER)[BLOB_FILTER_HEIGHT][BLOB_FILTER_WIDTH] =
+        LOG_FILTER;
+static const int DETECTION_THRESHOLD    = LOG_RESPONSE_THRESHOLD;
+#endif /* NARROW_LOG_FILTER */
+
+/* The LoG response contributed by each row of the filter, indexed by the bits
+ * of the window in that row, with the leftmost pixel in the least significant
+ * bit. This is filled in from DETECTION_FILTER when a detector is
+ * initialized. */
+static int LOG_ROW_RESPONSE[BLOB_FILTER_HEIGHT][1 << BLOB_FILTER_WIDTH];
+
+/* Adds the value to a statistics counter. When statistics are disabled, this
+ * compiles away entirely, including the computation of the value. */
+#define stats_add(counter, value)                                             \
+    do {                                                                      \
+        if (HOST_STATS_ENABLED) {                                             \
+            (counter) += (value);                                             \
+        }                                                                     \
+    } while (0)
+
+/* Adds the time between its construction and destruction to the given timer,
+ * when statistics are enabled. */
+class stats_timer {
+public:
+    explicit stats_timer(uint64_t& ns) : ns(ns)
+    {
+        if (HOST_STATS_ENABLED) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~stats_timer()
+    {
+        if (HOST_STATS_ENABLED) {
+            ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+private:
+    uint64_t& ns;                               // The timer to add to
+    std::chrono::steady_clock::time_point start; // When the timer started
+};
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Computes the response of each filter row for every window of row bits
+static void init_log_row_response()
+{
+    for (int i = 0; i < BLOB_FILTER_HEIGHT; i++) {
+        for (int bits = 0; bits < (1 << BLOB_FILTER_WIDTH); bits++) {
+            int response = 0;
+            for (int j = 0; j < BLOB_FILTER_WIDTH; j++) {
+                response += ((bits >> j) & 1) ? DETECTION_FILTER[i][j] : 0;
+            }
+            LOG_ROW_RESPONSE[i][bits] = response;
+        }
+    }
+}
+
+/* Returns the distance from a pixel to the edge of the filter's window around
+ * it, for the box filter of the given size, or the LoG filter for 0. */
+static int filter_reach(int box_size)
+{
+    return (box_size == 0) ? BLOB_FILTER_WIDTH / 2 : box_size - 1;
+}
+
+/* Returns the number of rows below a pixel that are read to detect a blob on
+ * it. The box filter also compares the responses on the rows around it. */
+static int detection_rows_below(int box_size)
+{
+    int reach = filter_reach(box_size);
+    return (box_size == 0) ? reach : reach + 1;
+}
+
+/* Invokes the given operation on each row of each span in the level, within
+ * rows [y_begin, y_end), in row-major order. The operation is called as
+ * op(y, x0, x1). */
+template <typename SPAN_OP>
+static void for_each_span_row(const scale_level_t& level, int y_begin,
+        int y_end, SPAN_OP op)
+{
+    const std::vector<pixel_span_t>& spans = level.spans;
+    for (size_t band = 0; band < spans.size(); ) {
+        // Find the spans that share this band of rows
+        size_t band_end = band;
+        while (band_end < spans.size() &&
+                spans[band_end].y0 == spans[band].y0) {
+            band_end++;
+        }
+
+        int y0 = std::max(spans[band].y0, y_begin);
+        int y1 = std::min(spans[band].y1, y_end);
+        for (int y = y0; y < y1; y++) {
+            for (size_t i = band; i < band_end; i++) {
+                op(y, spans[i].x0, spans[i].x1);
+            }
+        }
+        band = band_end;
+    }
+}
+
+// Computes the spans of pixels inside the region of interest for the level
+static void compute_level_spans(scale_level_t& level, const roi_mask_t& roi)
+{
+    int tile_size = roi.tile_size / level.scale;
+
+    level.spans.clear();
+    for (int tile_row = 0; tile_row < roi.tile_rows; tile_row++) {
+        pixel_span_t span;
+        span.y0 = tile_row * tile_size;
+        span.y1 = std::min(span.y0 + tile_size, level.height);
+        if (span.y0 >= span.y1) {
+            break;
+        }
+
+        // Merge consecutive tiles in the region into a single span
+        for (int tile_col = 0; tile_col < roi.tile_cols; tile_col++) {
+            if (!roi.test(tile_row, tile_col)) {
+                continue;
+            }
+
+            span.x0 = tile_col * tile_size;
+            while (tile_col + 1 < roi.tile_cols &&
+                    roi.test(tile_row, tile_col + 1)) {
+                tile_col++;
+            }
+            span.x1 = std::min((tile_col + 1) * tile_size, level.width);
+            if (span.x0 < span.x1) {
+                level.spans.push_back(span);
+            }
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Pipeline Stages
+ *----------------------------------------------------------------------------*/
+
+/* Demosaics a row of a Bayer image to luma. Each pixel takes the 2x2 block of
+ * samples to the right of and below it, which always holds a red, a blue, and
+ * two green samples, and weights the three colors like an RGBA pixel, with red
+ * and blue sharing the mean of their weights. The last row and column take the
+ * block to their left or above them instead. */
+static void bayer_row(uint8_t *gray, const uint8_t *mosaic, int width,
+        int height, int y, int x0, int x1, int green_parity)
+{
+    int top = std::min(y, height - 2);
+    const uint8_t *row0 = &mosaic[top * width];
+    const uint8_t *row1 = row0 + width;
+    for (int x = x0; x < x1; x++) {
+        int left = std::min(x, width - 2);
+        int diagonal = row0[left] + row1[left+1];
+        int anti_diagonal = row0[left+1] + row1[left];
+        bool greens_on_diagonal = ((left + top) & 1) == green_parity;
+        int greens = greens_on_diagonal ? diagonal : anti_diagonal;
+        int red_blue = greens_on_diagonal ? anti_diagonal : diagonal;
+        int sum = (GRAYSCALE_RED_WEIGHT + GRAYSCALE_BLUE_WEIGHT) * red_blue +
+                GRAYSCALE_GREEN_WEIGHT * greens;
+        gray[x] = sum >> (GRAYSCALE_WEIGHT_BITS + 1);
+    }
+}
+
+/* Converts rows [y0, y1) of the image to grayscale. RGBA pixels take the
+ * weighted sum of their RGB channels, luma is copied as is, and Bayer is
+ * demosaiced to luma. Unless the histogram is NULL, the grayscale values are
+ * counted in it as each row is converted. */
+static void grayscale_rows(scale_level_t& level, input_format_t format,
+        const void *image, int y0, int y1, uint32_t *histogram)
+{
+    const pixel_t *pixels = static_cast<const pixel_t *>(image);
+    const uint8_t *samples = static_cast<const uint8_t *>(image);
+    for_each_span_row(level, y0, y1, [&](int y, int x0, int x1) {
+        int row = y * level.width;
+        uint8_t *gray = &level.gray[row];
+        stats_add(level.stats.pixels_out, x1 - x0);
+        if (format == INPUT_RGBA) {
+            for (int x = x0; x < x1; x++) {
+                const pixel_t& pixel = pixels[row + x];
+                int sum = GRAYSCALE_RED_WEIGHT * pixel.red +
+                        GRAYSCALE_GREEN_WEIGHT * pixel.green +
+                        GRAYSCALE_BLUE_WEIGHT * pixel.blue;
+                gray[x] = sum >> GRAYSCALE_WEIGHT_BITS;
+            }
+        } else if (format == INPUT_LUMA) {
+            std::copy(&samples[row + x0], &samples[row + x1], &gray[x0]);
+        } else {
+            bayer_row(gray, samples, level.width, level.height, y, x0, x1,
+                    (format == INPUT_BAYER_RGGB) ? 1 : 0);
+        }
+
+        if (histogram != NULL) {
+            for (int x = x0; x < x1; x++) {
+                histogram[gray[x]]++;
+            }
+        }
+    });
+}
+
+/* Returns the lowest threshold that leaves at most 1 in 2^ADAPTIVE_SHIFT of the
+ * pixels in the histogram set, in the same way as the hardware. */
+static int percentile_threshold(const uint32_t *histogram, uint64_t pixels)
+{
+    uint64_t limit = pixels >> ADAPTIVE_SHIFT;
+    uint64_t brighter = 0;
+    for (int bin = HISTOGRAM_BINS - 1; bin >= 0; bin--) {
+        brighter += histogram[bin];
+        if (brighter > limit) {
+            return bin + 1;
+        }
+    }
+
+    return 0;
+}
+
+/* Returns the threshold that splits the histogram into the two classes with
+ * the most variance between them, with Otsu's method. */
+static int otsu_threshold(const uint32_t *histogram, uint64_t pixels)
+{
+    double total_sum = 0.0;
+    for (int bin = 0; bin < HISTOGRAM_BINS; bin++) {
+        total_sum += (double)bin * histogram[bin];
+    }
+
+    // The darker class is the bins below the threshold
+    int threshold = 0;
+    double best_variance = -1.0;
+    double dark_sum = 0.0;
+    uint64_t dark_pixels = 0;
+    for (int bin = 0; bin < HISTOGRAM_BINS - 1; bin++) {
+        dark_pixels += histogram[bin];
+        dark_sum += (double)bin * histogram[bin];
+        uint64_t bright_pixels = pixels - dark_pixels;
+        if (dark_pixels == 0 || bright_pixels == 0) {
+            continue;
+        }
+
+        double mean_diff = dark_sum / dark_pixels - (total_sum - dark_sum) /
+                bright_pixels;
+        double variance = (double)dark_pixels * bright_pixels * mean_diff *
+                mean_diff;
+        if (variance > best_variance) {
+            best_variance = variance;
+            threshold = bin + 1;
+        }
+    }
+
+    return threshold;
+}
+
+/* Computes the threshold for the next frame from the histogram of the frame
+ * that was just processed, and clears the histogram for the next frame. */
+static void update_threshold(host_detector_t& detector)
+{
+    if (detector.threshold_mode == THRESHOLD_FIXED) {
+        return;
+    }
+
+    uint64_t pixels = 0;
+    for (int bin = 0; bin < HISTOGRAM_BINS; bin++) {
+        pixels += detector.histogram[bin];
+    }
+    int threshold = (detector.threshold_mode == THRESHOLD_PERCENTILE) ?
+            percentile_threshold(detector.histogram, pixels) :
+            otsu_threshold(detector.histogram, pixels);
+    detector.threshold = std::min(std::max(threshold, ADAPTIVE_MIN_THRESHOLD),
+            HISTOGRAM_BINS - 1);
+    memset(detector.histogram, 0, sizeof(detector.histogram));
+}
+
+/* Computes rows [y0, y1) of the level by downscaling the previous level,
+ * averaging each block of pixels. */
+static void downscale_rows(scale_level_t& level, const scale_level_t& prev,
+        int y0, int y1)
+{
+    for_each_span_row(level, y0, y1, [&](int y, int x0, int x1) {
+        const uint8_t *row0 = &prev.gray[(DOWNSCALE_FACTOR * y) * prev.width];
+        const uint8_t *row1 = row0 + prev.width;
+        uint8_t *gray = &level.gray[y * level.width];
+        stats_add(level.stats.pixels_out, x1 - x0);
+        for (int x = x0; x < x1; x++) {
+            int px = DOWNSCALE_FACTOR * x;
+            int sum = row0[px] + row0[px+1] + row1[px] + row1[px+1];
+            gray[x] = sum >> DOWNSCALE_SHIFT;
+        }
+    });
+}
+
+/* Converts rows [y0, y1) of the level to monochrome with the threshold, packing
+ * the values into bits. The packed rows are written to the given buffer, with
+ * pixels outside of the region of interest cleared. */
+static void monochrome_rows(const scale_level_t& level, int threshold, int y0,
+        int y1, uint64_t *mono_rows)
+{
+    std::fill(mono_rows, mono_rows + (y1 - y0) * level.mask_words, 0);
+    for_each_span_row(level, y0, y1, [&](int y, int x0, int x1) {
+        const uint8_t *gray = &level.gray[y * level.width];
+        uint64_t *mono = &mono_rows[(y - y0) * level.mask_words];
+        for (int x = x0; x < x1; x++) {
+            uint64_t bit = (gray[x] >= threshold);
+            mono[x / MASK_WORD_BITS] |= bit << (x % MASK_WORD_BITS);
+        }
+    });
+}
+
+/* Computes rows [y0, y1) of the integral image of the level's monochrome
+ * plane. Entry (x, y) of the integral image counts the set pixels above and to
+ * the left of pixel (x, y), so it has an extra row and column of zeros at the
+ * top and left, and row y of the plane is row y + 1 of the image. */
+static void integral_rows(scale_level_t& level, int y0, int y1)
+{
+    int stride = level.width + 1;
+    for (int y = y0; y < y1; y++) {
+        const uint64_t *mono = &level.mono[y * level.mask_words];
+        const uint32_t *above = &level.integral[y * stride];
+        uint32_t *integral = &level.integral[(y + 1) * stride];
+        uint32_t count = 0;
+        for (int x = 0; x < level.width; x++) {
+            count += (mono[x / MASK_WORD_BITS] >> (x % MASK_WORD_BITS)) & 1;
+            integral[x+1] = above[x+1] + count;
+        }
+    }
+}
+
+/* Marks which tiles in rows [tile_row0, tile_row1) of the level have any
+ * monochrome pixels set, by taking the OR-reduction of the words in each
+ * tile. */
+static void occupancy_tiles(scale_level_t& level, int tile_row0,
+        int tile_row1)
+{
+    std::fill(level.occupancy.data() + tile_row0 * level.tile_words,
+            level.occupancy.data() + tile_row1 * level.tile_words, 0);
+    int y1 = std::min(tile_row1 * OCCUPANCY_TILE_ROWS, level.height);
+    for (int y = tile_row0 * OCCUPANCY_TILE_ROWS; y < y1; y++) {
+        const uint64_t *mono = &level.mono[y * level.mask_words];
+        uint64_t *occupancy = &level.occupancy[(y / OCCUPANCY_TILE_ROWS) *
+                level.tile_words];
+        for (int word = 0; word < level.mask_words; word++) {
+            uint64_t occupied = (mono[word] != 0);
+            stats_add(level.stats.mono_pixels,
+                    __builtin_popcountll(mono[word]));
+            occupancy[word / MASK_WORD_BITS] |= occupied <<
+                    (word % MASK_WORD_BITS);
+        }
+    }
+}
+
+/* Invokes the given operation on each occupied tile in rows [tile_row0,
+ * tile_row1) of the level, in row-major order of the tiles. The operation is
+ * called as op(tile_row, word). */
+template <typename TILE_OP>
+static void for_each_occupied_tile(const scale_level_t& level, int tile_row0,
+        int tile_row1, TILE_OP op)
+{
+    for (int tile_row = tile_row0; tile_row < tile_row1; tile_row++) {
+        const uint64_t *occupancy = &level.occupancy[tile_row *
+                level.tile_words];
+        for (int i = 0; i < level.tile_words; i++) {
+            for (uint64_t bits = occupancy[i]; bits != 0; bits &= bits - 1) {
+                op(tile_row, i * MASK_WORD_BITS + __builtin_ctzll(bits));
+            }
+        }
+    }
+}
+
+// Returns the bits of the given word that are in the range of pixels [x0, x1)
+static uint64_t word_span_bits(int word, int x0, int x1)
+{
+    int first = std::max(x0 - word * MASK_WORD_BITS, 0);
+    int last = std::min(x1 - word * MASK_WORD_BITS, MASK_WORD_BITS);
+    if (first >= last) {
+        return 0;
+    }
+
+    uint64_t bits = ~UINT64_C(0) << first;
+    return (last < MASK_WORD_BITS) ? bits & ((UINT64_C(1) << last) - 1) : bits;
+}
+
+// Returns the given number of the least significant set bits of the word
+static uint64_t lowest_set_bits(uint64_t bits, int count)
+{
+    uint64_t lowest = 0;
+    for (int i = 0; i < count && bits != 0; i++) {
+        uint64_t bit = bits & -bits;
+        lowest |= bit;
+        bits ^= bit;
+    }
+
+    return lowest;
+}
+
+// Returns the filter-width window of bits in the packed row, starting at x
+static unsigned window_bits(const uint64_t *mono, int x)
+{
+    int word = x / MASK_WORD_BITS;
+    int bit = x % MASK_WORD_BITS;
+    uint64_t bits = mono[word] >> bit;
+    if (bit > MASK_WORD_BITS - BLOB_FILTER_WIDTH) {
+        bits |= mono[word+1] << (MASK_WORD_BITS - bit);
+    }
+
+    return bits & ((1 << BLOB_FILTER_WIDTH) - 1);
+}
+
+// Computes the LoG response centered on the given pixel
+static int log_response(const scale_level_t& level, int cx, int cy)
+{
+    int response = 0;
+    for (int i = 0; i < BLOB_FILTER_HEIGHT; i++) {
+        const uint64_t *mono = &level.mono[(cy - BLOB_FILTER_HEIGHT/2 + i) *
+                level.mask_words];
+        response += LOG_ROW_RESPONSE[i][window_bits(mono,
+                cx - BLOB_FILTER_WIDTH/2)];
+    }
+
+    return response;
+}
+
+// Counts the set pixels in the box [x0, x1) by [y0, y1) of the level
+static int64_t box_sum(const scale_level_t& level, int x0, int y0, int x1,
+        int y1)
+{
+    int stride = level.width + 1;
+    const uint32_t *integral = level.integral.data();
+    return (int64_t)integral[y1 * stride + x1] - integral[y0 * stride + x1] -
+            integral[y1 * stride + x0] + integral[y0 * stride + x0];
+}
+
+/* Computes the box filter's response centered on the given pixel, scaled by
+ * the areas of the inner box and the ring, so it is an integer. */
+static int64_t box_response(const scale_level_t& level, int box_size, int cx,
+        int cy)
+{
+    int half = box_size / 2;
+    int reach = filter_reach(box_size);
+    int64_t inner = box_sum(level, cx - half, cy - half, cx + half + 1,
+            cy + half + 1);
+    int64_t outer = box_sum(level, cx - reach, cy - reach, cx + reach + 1,
+            cy + reach + 1);
+    int64_t inner_area = box_size * box_size;
+    int64_t ring_area = (2 * reach + 1) * (2 * reach + 1) - inner_area;
+    return inner * ring_area - (outer - inner) * inner_area;
+}
+
+/* Returns true if the box filter detects a blob centered on the given pixel,
+ * which must be set. The response must reach the threshold, and be the
+ * strongest of the set pixels around it that can be detected, with ties going
+ * to the earliest pixel in row-major order, so a blob is only detected once. */
+static bool box_detection(const scale_level_t& level, int box_size, int cx,
+        int cy)
+{
+    int reach = filter_reach(box_size);
+    int64_t inner_area = box_size * box_size;
+    int64_t ring_area = (2 * reach + 1) * (2 * reach + 1) - inner_area;
+    int64_t response = box_response(level, box_size, cx, cy);
+    if (256 * response < BOX_RESPONSE_THRESHOLD * inner_area * ring_area) {
+        return false;
+    }
+
+    for (int dy = -1; dy <= 1; dy++) {
+        int y = cy + dy;
+        const uint64_t *mono = &level.mono[y * level.mask_words];
+        for (int dx = -1; dx <= 1; dx++) {
+            int x = cx + dx;
+            bool set = (mono[x / MASK_WORD_BITS] >> (x % MASK_WORD_BITS)) & 1;
+            if ((dx == 0 && dy == 0) || !set || x < reach || y < reach ||
+                    x >= level.width - reach || y >= level.height - reach) {
+                continue;
+            }
+
+            int64_t neighbor = box_response(level, box_size, x, y);
+            bool earlier = (dy < 0) || (dy == 0 && dx < 0);
+            if (neighbor > response || (neighbor == response && earlier)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/* Applies the LoG filter to the occupied tiles in rows [tile_row0, tile_row1)
+ * of the level, and thresholds the response, packing the detections into the
+ * bits of the detection plane. The monochrome plane must already hold the rows
+ * below the tiles that are covered by the filter. A
+ * window can only reach the threshold if its centerpoint is set, because the
+ * center tap is the only weight large enough, so the filter is only evaluated
+ * at set pixels, and empty tiles are skipped altogether. Like the hardware,
+ * there are no detections along the edges of the level. With a box size, the
+ * box filter is applied instead, which needs the integral image of the rows
+ * it covers, and is also only evaluated at set pixels. */
+static void blob_detection_tiles(scale_level_t& level, int box_size,
+        int tile_row0, int tile_row1)
+{
+    int reach = filter_reach(box_size);
+    int min_x = reach;
+    int max_x = level.width - reach;
+    int min_y = reach;
+    int max_y = level.height - reach;
+
+    for_each_occupied_tile(level, tile_row0, tile_row1,
+            [&](int tile_row, int word) {
+        int y0 = tile_row * OCCUPANCY_TILE_ROWS;
+        int y1 = std::min(y0 + OCCUPANCY_TILE_ROWS, level.height);
+        uint64_t inner_bits = word_span_bits(word, min_x, max_x);
+
+        // Every row of the tile is written, so no stale detections are left
+        for (int y = y0; y < y1; y++) {
+            uint64_t center_bits = level.mono[y * level.mask_words + word];
+            center_bits &= (y >= min_y && y < max_y) ? inner_bits : 0;
+
+            uint64_t detection_bits = 0;
+            for (; center_bits != 0; center_bits &= center_bits - 1) {
+                int bit = __builtin_ctzll(center_bits);
+                int x = word * MASK_WORD_BITS + bit;
+                bool detected = (box_size == 0) ?
+                        log_response(level, x, y) >= DETECTION_THRESHOLD :
+                        box_detection(level, box_size, x, y);
+                if (detected) {
+                    detection_bits |= UINT64_C(1) << bit;
+                }
+            }
+            level.detections[y * level.mask_words + word] = detection_bits;
+            stats_add(level.stats.detections,
+                    __builtin_popcountll(detection_bits));
+        }
+    });
+}
+
+/* Marks the tiles of the level that overlap the pixels [x0, x1) by [y0, y1) as
+ * searched, clipping the pixels to the level. */
+static void mark_search_tiles(scale_level_t& level, int x0, int y0, int x1,
+        int y1)
+{
+    int tile_row0 = std::max(y0, 0) / OCCUPANCY_TILE_ROWS;
+    int tile_row1 = (std::min(y1, level.height) - 1) / OCCUPANCY_TILE_ROWS;
+    int word0 = std::max(x0, 0) / MASK_WORD_BITS;
+    int word1 = (std::min(x1, level.width) - 1) / MASK_WORD_BITS;
+    for (int tile_row = tile_row0; tile_row <= tile_row1; tile_row++) {
+        uint64_t *search = &level.search[tile_row * level.tile_words];
+        for (int word = word0; word <= word1; word++) {
+            search[word / MASK_WORD_BITS] |= UINT64_C(1) <<
+                    (word % MASK_WORD_BITS);
+        }
+    }
+}
+
+/* Marks the tiles of the level within the margin of the blobs detected at the
+ * coarser level, in the level's pixels. */
+static void search_around_blobs(scale_level_t& level,
+        const scale_level_t& coarser, int margin)
+{
+    int factor = coarser.scale / level.scale;
+    for_each_occupied_tile(coarser, 0, coarser.tile_rows,
+            [&](int tile_row, int word) {
+        int y0 = tile_row * OCCUPANCY_TILE_ROWS;
+        int y1 = std::min(y0 + OCCUPANCY_TILE_ROWS, coarser.height);
+        for (int y = y0; y < y1; y++) {
+            for (uint64_t bits = coarser.detections[y * coarser.mask_words +
+                    word]; bits != 0; bits &= bits - 1) {
+                int x = word * MASK_WORD_BITS + __builtin_ctzll(bits);
+                mark_search_tiles(level, factor * x - margin,
+                        factor * y - margin, factor * (x + 1) + margin,
+                        factor * (y + 1) + margin);
+            }
+        }
+    });
+}
+
+/* Prunes the occupied tiles of a level to the tiles within the margin of the
+ * blobs detected at any coarser level, and the tiles with a saturated pixel.
+ * A blob need not be detected at every level in between, so each coarser
+ * level is searched around, rather than just the next one. The pruned tiles
+ * are cleared from the occupancy, so the rest of the pipeline skips them like
+ * empty tiles. The coarser levels' detections must already be computed. */
+static void prune_tiles(host_detector_t& detector, int index)
+{
+    scale_level_t& level = detector.levels[index];
+    std::fill(level.search.begin(), level.search.end(), 0);
+    for (int i = index + 1; i < NUM_SCALES; i++) {
+        search_around_blobs(level, detector.levels[i], detector.prune_margin);
+    }
+
+    // Search the tiles with a saturated pixel, which can only be set pixels
+    for_each_occupied_tile(level, 0, level.tile_rows,
+            [&](int tile_row, int word) {
+        int y0 = tile_row * OCCUPANCY_TILE_ROWS;
+        int y1 = std::min(y0 + OCCUPANCY_TILE_ROWS, level.height);
+        for (int y = y0; y < y1; y++) {
+            const uint8_t *gray = &level.gray[y * level.width];
+            for (uint64_t bits = level.mono[y * level.mask_words + word];
+                    bits != 0; bits &= bits - 1) {
+                int x = word * MASK_WORD_BITS + __builtin_ctzll(bits);
+                if (gray[x] >= PRUNE_BRIGHT_THRESHOLD) {
+                    mark_search_tiles(level, x, y, x + 1, y + 1);
+                    return;
+                }
+            }
+        }
+    });
+
+    for (size_t i = 0; i < level.occupancy.size(); i++) {
+        uint64_t pruned = level.occupancy[i] & ~level.search[i];
+        stats_add(level.stats.pruned_tiles, __builtin_popcountll(pruned));
+        level.occupancy[i] &= level.search[i];
+    }
+}
+
+/* Converts the detections in rows [tile_row0, tile_row1) of the level's tiles
+ * into bounding boxes in the original image, returning the number of boxes
+ * written to the buffer. This jumps straight to the set bits of the occupied
+ * tiles' detection words, so its cost depends on the number of detections,
+ * rather than the size of the level. */
+static int blob_bounding_boxes(const scale_level_t& level, int box_size,
+        int tile_row0, int tile_row1, bbox_t *bboxes, int max_bboxes)
+{
+    int radius = level.scale * (filter_reach(box_size) + 1);
+    int num_bboxes = 0;
+
+    for (int tile_row = tile_row0; tile_row < tile_row1; tile_row++) {
+        const uint64_t *occupancy = &level.occupancy[tile_row *
+                level.tile_words];
+        int y0 = tile_row * OCCUPANCY_TILE_ROWS;
+        int y1 = std::min(y0 + OCCUPANCY_TILE_ROWS, level.height);
+
+        // Scan the rows of the band in order, so boxes stay in row-major order
+        for (int y = y0; y < y1; y++) {
+            const uint64_t *detections = &level.detections[y *
+                    level.mask_words];
+            int cy = level.scale * y;
+            for (int i = 0; i < level.tile_words; i++) {
+                for (uint64_t tiles = occupancy[i]; tiles != 0;
+                        tiles &= tiles - 1) {
+                    int word = i * MASK_WORD_BITS + __builtin_ctzll(tiles);
+                    uint64_t bits = detections[word];
+
+                    // Only keep the earliest boxes that fit in the buffer
+                    int remaining = max_bboxes - num_bboxes;
+                    if (__builtin_popcountll(bits) > remaining) {
+                        bits = lowest_set_bits(bits, remaining);
+                    }
+
+                    for (; bits != 0; bits &= bits - 1) {
+                        int cx = level.scale * (word * MASK_WORD_BITS +
+                                __builtin_ctzll(bits));
+                        bboxes[num_bboxes++] = bbox_t(cx - radius, cy - radius,
+                                cx + radius, cy + radius);
+                    }
+                    if (num_bboxes == max_bboxes) {
+                        return num_bboxes;
+                    }
+                }
+            }
+        }
+    }
+
+    return num_bboxes;
+}
+
+/*----------------------------------------------------------------------------
+ * Threaded Pipeline
+ *----------------------------------------------------------------------------*/
+
+/* Builds the image pyramid one band at a time, and streams the monochrome rows
+ * of each level to that level's detection thread, one tile row per batch. */
+static void pyramid_stage(host_detector_t& detector, const void *image,
+        spsc_ring<uint64_t> *rings)
+{
+    trace_scope trace("pyramid stage");
+    uint32_t *histogram = (detector.threshold_mode == THRESHOLD_FIXED) ? NULL :
+            detector.histogram;
+    int num_bands = (detector.height + PYRAMID_BAND_ROWS - 1) /
+            PYRAMID_BAND_ROWS;
+    for (int band = 0; band < num_bands; band++) {
+        for (int i = 0; i < NUM_SCALES; i++) {
+            scale_level_t& level = detector.levels[i];
+            int band_rows = PYRAMID_BAND_ROWS / level.scale;
+            int y0 = band * band_rows;
+            int y1 = std::min(y0 + band_rows, level.height);
+            stats_add(level.stats.pixels_in, (y1 - y0) * level.width);
+            {
+                stats_timer timer(level.stats.stage_ns[STAGE_PYRAMID]);
+                if (i == 0) {
+                    grayscale_rows(level, detector.format, image, y0, y1,
+                            histogram);
+                } else {
+                    downscale_rows(level, detector.levels[i-1], y0, y1);
+                }
+            }
+
+            // Pack the monochrome rows directly into the ring's slots
+            stats_timer timer(level.stats.stage_ns[STAGE_MONOCHROME]);
+            for (int y = y0; y < y1; y += OCCUPANCY_TILE_ROWS) {
+                int y_end = std::min(y + OCCUPANCY_TILE_ROWS, y1);
+                monochrome_rows(level, detector.threshold, y, y_end,
+                        rings[i].begin_write());
+                rings[i].end_write((y_end - y) * level.mask_words);
+            }
+        }
+    }
+}
+
+/* Runs blob detection on a level as its tile rows arrive from the ring. The
+ * filter covers the rows below a tile, so detection lags behind the monochrome
+ * rows by as many tile rows as it covers, which is one for the LoG filter. */
+static void detection_stage(scale_level_t& level, spsc_ring<uint64_t>& ring,
+        int box_size, int max_bboxes, int index)
+{
+    trace_thread_name("detection", index);
+    trace_scope trace("detection stage", index);
+    int lag = (detection_rows_below(box_size) + OCCUPANCY_TILE_ROWS - 1) /
+            OCCUPANCY_TILE_ROWS;
+    level.num_bboxes = 0;
+    for (int tile_row = 0; tile_row < level.tile_rows + lag; tile_row++) {
+        if (tile_row < level.tile_rows) {
+            size_t count;
+            const uint64_t *mono_rows = ring.begin_read(count);
+            std::copy(mono_rows, mono_rows + count, &level.mono[tile_row *
+                    OCCUPANCY_TILE_ROWS * level.mask_words]);
+            ring.end_read();
+
+            stats_timer timer(level.stats.stage_ns[STAGE_DETECTION]);
+            occupancy_tiles(level, tile_row, tile_row + 1);
+            if (box_size != 0) {
+                int y0 = tile_row * OCCUPANCY_TILE_ROWS;
+                integral_rows(level, y0, y0 + count / level.mask_words);
+            }
+        }
+
+        if (tile_row >= lag) {
+            int detect_row = tile_row - lag;
+            {
+                stats_timer timer(level.stats.stage_ns[STAGE_DETECTION]);
+                blob_detection_tiles(level, box_size, detect_row,
+                        detect_row + 1);
+            }
+
+            stats_timer timer(level.stats.stage_ns[STAGE_BBOXES]);
+            level.num_bboxes += blob_bounding_boxes(level, box_size,
+                    detect_row, detect_row + 1,
+                    level.bboxes.data() + level.num_bboxes,
+                    max_bboxes - level.num_bboxes);
+        }
+    }
+}
+
+/* Runs a level's detection stage on each frame, from when the frame is started
+ * until the detector is destroyed. The last worker to finish a frame wakes the
+ * thread waiting on it. */
+static void detection_worker(host_detector_t& detector, int index)
+{
+    trace_thread_name("detection", index);
+    uint64_t frames_done = 0;
+    while (true) {
+        int max_bboxes;
+        {
+            std::unique_lock<std::mutex> lock(detector.worker_lock);
+            while (!detector.stopping && detector.frame_number == frames_done) {
+                detector.frame_start.wait(lock);
+            }
+            if (detector.stopping) {
+                return;
+            }
+            max_bboxes = detector.frame_max_bboxes;
+        }
+
+        detection_stage(detector.levels[index], detector.rings[index],
+                detector.box_size, max_bboxes, index);
+        frames_done++;
+
+        std::lock_guard<std::mutex> lock(detector.worker_lock);
+        if (--detector.busy_workers == 0) {
+            detector.frame_done.notify_one();
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+int host_detector_init(host_detector_t& detector, int width, int height)
+{
+    // The smallest scale level must still be large enough for the filter
+    int min_scale = 1;
+    for (int i = 1; i < NUM_SCALES; i++) {
+        min_scale *= DOWNSCALE_FACTOR;
+    }
+    if (width / min_scale < BLOB_FILTER_WIDTH ||
+            height / min_scale < BLOB_FILTER_HEIGHT) {
+        log_err("Image size %dx%d is too small for %d scale levels.\n", width,
+                height, NUM_SCALES);
+        return -1;
+    }
+
+    init_log_row_response();
+    host_detector_destroy(detector);
+    detector.width = width;
+    detector.height = height;
+    detector.format = INPUT_RGBA;
+    detector.box_size = 0;
+    detector.coarse_levels = NUM_SCALES;
+    detector.prune_margin = PRUNE_DEFAULT_MARGIN;
+    host_detector_set_threshold(detector, THRESHOLD_FIXED);
+    host_detector_reset_stats(detector);
+    int scale = 1;
+    for (int i = 0; i < NUM_SCALES; i++) {
+        scale_level_t& level = detector.levels[i];
+        level.scale = scale;
+        level.width = width / scale;
+        level.height = height / scale;
+        level.gray.assign(level.width * level.height, 0);
+        level.mask_words = (level.width + MASK_WORD_BITS - 1) / MASK_WORD_BITS;
+        level.tile_rows = (level.height + OCCUPANCY_TILE_ROWS - 1) /
+                OCCUPANCY_TILE_ROWS;
+        level.tile_words = (level.mask_words + MASK_WORD_BITS - 1) /
+                MASK_WORD_BITS;
+        level.mono.assign(level.mask_words * level.height, 0);
+        level.occupancy.assign(level.tile_words * level.tile_rows, 0);
+        level.search.assign(level.tile_words * level.tile_rows, 0);
+        level.detections.assign(level.mask_words * level.height, 0);
+        level.num_bboxes = 0;
+        detector.rings[i].init(RING_SLOTS, OCCUPANCY_TILE_ROWS *
+                level.mask_words);
+        scale *= DOWNSCALE_FACTOR;
+    }
+
+    int rc = roi_mask_init(detector.full_roi, width, height,
+            ROI_DEFAULT_TILE_SIZE);
+    if (rc != 0) {
+        return rc;
+    }
+    rc = host_detector_set_roi(detector, NULL);
+    if (rc != 0) {
+        return rc;
+    }
+
+    // Start the detection threads, which wait for the first frame
+    detector.frame_number = 0;
+    detector.busy_workers = 0;
+    detector.frame_max_bboxes = 0;
+    detector.stopping = false;
+    for (int i = 0; i < NUM_SCALES; i++) {
+        detector.workers[i] = std::thread(detection_worker, std::ref(detector),
+                i);
+    }
+
+    return 0;
+}
+
+void host_detector_destroy(host_detector_t& detector)
+{
+    if (!detector.workers[0].joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(detector.worker_lock);
+        detector.stopping = true;
+    }
+    detector.frame_start.notify_all();
+    for (int i = 0; i < NUM_SCALES; i++) {
+        detector.workers[i].join();
+    }
+}
+
+int host_detector_set_roi(host_detector_t& detector, const roi_mask_t *roi)
+{
+    if (roi == NULL) {
+        roi = &detector.full_roi;
+    }
+
+    // Check that the ROI mask covers the image
+    int tile_size = roi->tile_size;
+    if (roi->tile_cols != (detector.width + tile_size - 1) / tile_size ||
+            roi->tile_rows != (detector.height + tile_size - 1) / tile_size) {
+        log_err("ROI mask of %dx%d tiles does not match the %dx%d image.\n",
+                roi->tile_cols, roi->tile_rows, detector.width,
+                detector.height);
+        return -1;
+    }
+
+    // Compute the spans of pixels inside the region at each level
+    detector.roi = roi;
+    for (int i = 0; i < NUM_SCALES; i++) {
+        compute_level_spans(detector.levels[i], *roi);
+    }
+
+    return 0;
+}
+
+void host_detector_set_format(host_detector_t& detector,
+        input_format_t format)
+{
+    detector.format = format;
+}
+
+int host_detector_set_box_filter(host_detector_t& detector, int size)
+{
+    if (size != 0 && (size < 3 || size % 2 == 0)) {
+        log_err("Box filter size %d must be odd and at least 3.\n", size);
+        return -1;
+    }
+
+    // The integral images are only kept while the box filter is used
+    detector.box_size = size;
+    for (int i = 0; i < NUM_SCALES; i++) {
+        scale_level_t& level = detector.levels[i];
+        if (size == 0) {
+            std::vector<uint32_t>().swap(level.integral);
+        } else {
+            level.integral.assign((level.width + 1) * (level.height + 1), 0);
+        }
+    }
+
+    return 0;
+}
+
+void host_detector_set_threshold(host_detector_t& detector,
+        threshold_mode_t mode)
+{
+    detector.threshold_mode = mode;
+    detector.threshold = MONOCHROME_THRESHOLD;
+    memset(detector.histogram, 0, sizeof(detector.histogram));
+}
+
+int host_detector_set_pruning(host_detector_t& detector, int coarse_levels,
+        int margin)
+{
+    if (coarse_levels < 1 || coarse_levels > NUM_SCALES) {
+        log_err("Number of coarse levels %d must be from 1 to %d.\n",
+                coarse_levels, NUM_SCALES);
+        return -1;
+    } else if (margin < 0) {
+        log_err("Pruning margin %d must not be negative.\n", margin);
+        return -1;
+    }
+
+    detector.coarse_levels = coarse_levels;
+    detector.prune_margin = margin;
+    return 0;
+}
+
+int host_detect_blobs(host_detector_t& detector, const void *image,
+        bbox_t *bboxes, int max_bboxes)
+{
+    trace_scope frame_trace("frame");
+    stats_timer frame_timer(detector.frame_ns);
+    stats_add(detector.frames, 1);
+
+    // Convert the image to grayscale, and build the image pyramid
+    uint32_t *histogram = (detector.threshold_mode == THRESHOLD_FIXED) ? NULL :
+            detector.histogram;
+    for (int i = 0; i < NUM_SCALES; i++) {
+        scale_level_t& level = detector.levels[i];
+        trace_scope trace("pyramid", i);
+        stats_timer timer(level.stats.stage_ns[STAGE_PYRAMID]);
+        stats_add(level.stats.pixels_in, level.width * level.height);
+        if (i == 0) {
+            grayscale_rows(level, detector.format, image, 0, level.height,
+                    histogram);
+        } else {
+            downscale_rows(level, detector.levels[i-1], 0, level.height);
+        }
+    }
+
+    /* Run blob detection on each of the scale levels, from the coarsest, so
+     * the finer levels can be pruned to the blobs found at the coarser ones. */
+    int first_pruned = NUM_SCALES - detector.coarse_levels;
+    for (int i = NUM_SCALES - 1; i >= 0; i--) {
+        scale_level_t& level = detector.levels[i];
+        {
+            trace_scope trace("monochrome", i);
+            stats_timer timer(level.stats.stage_ns[STAGE_MONOCHROME]);
+            monochrome_rows(level, detector.threshold, 0, level.height,
+                    level.mono.data());
+        }
+
+        trace_scope trace("detection", i);
+        stats_timer timer(level.stats.stage_ns[STAGE_DETECTION]);
+        occupancy_tiles(level, 0, level.tile_rows);
+        if (i < first_pruned) {
+            prune_tiles(detector, i);
+        }
+        if (detector.box_size != 0) {
+            integral_rows(level, 0, level.height);
+        }
+        blob_detection_tiles(level, detector.box_size, 0, level.tile_rows);
+    }
+
+    // Convert the detections into boxes, in order of the levels
+    int num_bboxes = 0;
+    for (int i = 0; i < NUM_SCALES; i++) {
+        scale_level_t& level = detector.levels[i];
+        trace_scope trace("bounding boxes", i);
+        stats_timer timer(level.stats.stage_ns[STAGE_BBOXES]);
+        int count = blob_bounding_boxes(level, detector.box_size, 0,
+                level.tile_rows, &bboxes[num_bboxes], max_bboxes - num_bboxes);
+        stats_add(level.stats.bboxes, count);
+        num_bboxes += count;
+    }
+
+    update_threshold(detector);
+    return num_bboxes;
+}
+
+int host_detect_blobs_threaded(host_detector_t& detector,
+        const void *image, bbox_t *bboxes, int max_bboxes)
+{
+    trace_scope frame_trace("frame");
+    stats_timer frame_timer(detector.frame_ns);
+    stats_add(detector.frames, 1);
+
+    // Start the frame on the detection threads, with room for the boxes
+    for (int i = 0; i < NUM_SCALES; i++) {
+        scale_level_t& level = detector.levels[i];
+        if ((int)level.bboxes.size() < max_bboxes) {
+            level.bboxes.resize(max_bboxes);
+        }
+    }
+    {
+        std::lock_guard<std::mutex> lock(detector.worker_lock);
+        detector.frame_max_bboxes = max_bboxes;
+        detector.busy_workers = NUM_SCALES;
+        detector.frame_number++;
+    }
+    detector.frame_start.notify_all();
+
+    // Build the pyramid on this thread, then wait for the detections
+    pyramid_stage(detector, image, detector.rings);
+    {
+        std::unique_lock<std::mutex> lock(detector.worker_lock);
+        while (detector.busy_workers != 0) {
+            detector.frame_done.wait(lock);
+        }
+    }
+
+    // Combine the boxes from each level, in order of the levels
+    int num_bboxes = 0;
+    for (int i = 0; i < NUM_SCALES && num_bboxes < max_bboxes; i++) {
+        scale_level_t& level = detector.levels[i];
+        int count = std::min(level.num_bboxes, max_bboxes - num_bboxes);
+        std::copy(level.bboxes.begin(), level.bboxes.begin() + count,
+                &bboxes[num_bboxes]);
+        stats_add(level.stats.bboxes, count);
+        num_bboxes += count;
+    }
+
+    update_threshold(detector);
+    return num_bboxes;
+}
+
+void host_detector_stats(const host_detector_t& detector, host_stats_t& stats)
+{
+    stats.frames = detector.frames;
+    stats.frame_ns = detector.frame_ns;
+    stats.threshold = detector.threshold;
+    for (int i = 0; i < NUM_SCALES; i++) {
+        /* Every detection becomes a box unless the buffer is full, so the
+         * dropped boxes are the detections that were not written. */
+        stats.scales[i] = detector.levels[i].stats;
+        stats.scales[i].dropped_bboxes = stats.scales[i].detections -
+                stats.scales[i].bboxes;
+    }
+}
+
+void host_detector_reset_stats(host_detector_t& detector)
+{
+    detector.frames = 0;
+    detector.frame_ns = 0;
+    for (int i = 0; i < NUM_SCALES; i++) {
+        detector.levels[i].stats = scale_stats_t();
+    }
+}
@@ -0,0 +1,443 @@
+/**
+ * @file host_detector.h
+ * @date Monday, October 19, 2026 at 11:05:37 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the host (software) blob detector.
+ *
+ * The host detector is a software implementation of the multi-scale blob
+ * detector pipeline in the hardware, and produces the same detections. The
+ * image is converted to grayscale, downscaled into a pyramid of scale levels,
+ * then each level is converted to monochrome, filtered with the LoG filter,
+ * and the detections are converted to bounding boxes in the original image.
+ * Optionally, the LoG filter can be replaced by a box filter approximating a
+ * larger LoG filter, which the hardware does not have. Also unlike the
+ * hardware, the finer scale levels can be pruned to the neighborhoods of the
+ * blobs found at the coarser levels.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef HOST_DETECTOR_H_
+#define HOST_DETECTOR_H_
+
+#include <stdint.h>             // Fixed-size integer types
+
+#include <condition_variable>   // Condition variable class
+#include <mutex>                // Mutex class
+#include <thread>               // Thread class
+#include <vector>               // Vector container
+
+#include "image.h"              // Definition of the image format
+#include "bbox.h"               // Definition of a bounding box
+#include "preprocess_params.h"  // Grayscale weights and downscale factor
+#include "roi_mask.h"           // Definition of the region of interest mask
+#include "spsc_ring.h"          // Single-producer, single-consumer ring
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The number of scale levels in the pyramid, including the original image. The
+ * amount each level is scaled down by, and the grayscale weights, are shared
+ * with the hardware (see preprocess_params.h).
+ **/
+static const int NUM_SCALES             = 5;
+
+/**
+ * The dimensions of the blob filter (which is LoG). This also determines the
+ * size of the window operated on in the image.
+ **/
+static const int BLOB_FILTER_WIDTH      = 5;
+static const int BLOB_FILTER_HEIGHT     = BLOB_FILTER_WIDTH;
+
+/**
+ * The LoG filter kernel, and the threshold on its response, quantized to the
+ * 14 fractional bits of the hardware's fixed-point type (truncating towards
+ * negative infinity). Summing these as integers gives the exact same response
+ * as the hardware.
+ **/
+static const int LOG_RESPONSE_THRESHOLD = 8028;     // 0.490
+static const int LOG_FILTER[BLOB_FILTER_HEIGHT][BLOB_FILTER_WIDTH] = {
+    { -392,  -754,  -818,  -754,  -392},
+    { -754,  -100,  1512,  -100,  -754},
+    { -818,  1512,  5213,  1512,  -818},
+    { -754,  -100,  1512,  -100,  -754},
+    { -392,  -754,  -818,  -754,  -392},
+};
+
+/**
+ * The reduced-precision LoG filter kernel, and the threshold on its response,
+ * which are 7-bit integer weights found by log_quantize. They make the same
+ * decisions as the full filter on every window of the headlight images, with
+ * an 8-bit response. Detection uses them when built with NARROW_LOG_FILTER
+ * defined, like the hardware.
+ **/
+static const int LOG_NARROW_RESPONSE_THRESHOLD = 74;
+static const int LOG_NARROW_FILTER[BLOB_FILTER_HEIGHT][BLOB_FILTER_WIDTH] = {
+    {  -4,  -7,  -8,  -7,  -4},
+    {  -7,  -1,  14,  -1,  -7},
+    {  -8,  14,  48,  14,  -8},
+    {  -7,  -1,  14,  -1,  -7},
+    {  -4,  -7,  -8,  -7,  -4},
+};
+
+/**
+ * The threshold on the response of the box filter, with 8 fractional bits. The
+ * response is the density of set pixels in the filter's inner box, less the
+ * density in the ring around it, so it ranges from -1 to 1.
+ **/
+static const int BOX_RESPONSE_THRESHOLD = 128;      // 0.5
+
+/**
+ * The threshold used to convert grayscale to monochrome. This is 0.85 * 255,
+ * truncated to an integer in the same way as the hardware's threshold.
+ **/
+static const int MONOCHROME_THRESHOLD   = 216;
+
+/**
+ * The number of bins in the histogram of grayscale values that the adaptive
+ * thresholds are computed from, one per value.
+ **/
+static const int HISTOGRAM_BINS         = 256;
+
+/**
+ * The percentile threshold is the lowest one that leaves at most 1 in
+ * 2^ADAPTIVE_SHIFT of the pixels set, the same as the hardware's. Neither
+ * adaptive threshold goes below ADAPTIVE_MIN_THRESHOLD, so a dark frame does
+ * not set its noise.
+ **/
+static const int ADAPTIVE_SHIFT         = 8;
+static const int ADAPTIVE_MIN_THRESHOLD = 128;
+
+/**
+ * The ways the monochrome threshold is chosen. The adaptive thresholds are
+ * computed from the histogram of the last frame's grayscale values.
+ **/
+typedef enum threshold_mode {
+    THRESHOLD_FIXED,                    // Always MONOCHROME_THRESHOLD
+    THRESHOLD_PERCENTILE,               // Keep the brightest pixels
+    THRESHOLD_OTSU,                     // Otsu's method on the histogram
+} threshold_mode_t;
+
+/**
+ * The pixels that are always searched when pruning the finer scale levels, and
+ * the default distance around the blobs at a coarser level that is searched at
+ * the next finer level, in pixels at the finer level. Headlights saturate the
+ * sensor, so a saturated pixel may be a light too small to see at the coarser
+ * levels.
+ **/
+static const int PRUNE_BRIGHT_THRESHOLD = 255;
+static const int PRUNE_DEFAULT_MARGIN   = 8;
+
+/**
+ * The formats of the input images. Luma is a plane of 8-bit intensities, such
+ * as the Y plane at the start of an NV12 or I420 frame, and is used as the
+ * grayscale image directly. Bayer is the raw 8-bit mosaic from a sensor, which
+ * is demosaiced to luma as it is read. Only the position of the green samples
+ * matters for luma, so BGGR is read the same as RGGB, and GBRG as GRBG.
+ **/
+typedef enum input_format {
+    INPUT_RGBA,                         // 32-bit RGBA pixels (the default)
+    INPUT_LUMA,                         // 8-bit luma, e.g. NV12 or I420's Y
+    INPUT_BAYER_RGGB,                   // 8-bit Bayer, with RGGB or BGGR
+    INPUT_BAYER_GRBG,                   // 8-bit Bayer, with GRBG or GBRG
+} input_format_t;
+
+/**
+ * The size of an occupancy tile, in pixels at its scale level. A tile is one
+ * 64-bit word of the packed monochrome plane wide, so its occupancy bit is the
+ * OR-reduction of OCCUPANCY_TILE_ROWS words.
+ **/
+static const int MASK_WORD_BITS         = 64;
+static const int OCCUPANCY_TILE_ROWS    = 8;
+
+/**
+ * Whether the detector keeps statistics on each stage of the pipeline, which
+ * is enabled by defining HOST_DETECTOR_STATS when building it. Otherwise, the
+ * counters and timers compile away, and the statistics are always zero.
+ **/
+#ifdef HOST_DETECTOR_STATS
+static const bool HOST_STATS_ENABLED    = true;
+#else
+static const bool HOST_STATS_ENABLED    = false;
+#endif /* HOST_DETECTOR_STATS */
+
+/**
+ * The stages of the pipeline at each scale level that are timed.
+ **/
+typedef enum host_stage {
+    STAGE_PYRAMID,                      // Grayscale conversion or downscaling
+    STAGE_MONOCHROME,                   // Thresholding and packing into bits
+    STAGE_DETECTION,                    // Occupancy tiles and the LoG filter
+    STAGE_BBOXES,                       // Converting detections into boxes
+    NUM_STAGES,
+} host_stage_t;
+
+/**
+ * The statistics for a single scale level, accumulated over every frame since
+ * they were last reset. The mask density is mono_pixels / pixels_out.
+ **/
+typedef struct scale_stats {
+    uint64_t pixels_in;                 // Pixels in the level
+    uint64_t pixels_out;                // Pixels inside the ROI, thresholded
+    uint64_t mono_pixels;               // Monochrome pixels that were set
+    uint64_t detections;                // Blob centerpoints detected
+    uint64_t bboxes;                    // Boxes written to the output
+    uint64_t dropped_bboxes;            // Boxes dropped for lack of space
+    uint64_t pruned_tiles;              // Occupied tiles skipped by pruning
+    uint64_t stage_ns[NUM_STAGES];      // Time spent in each stage
+} scale_stats_t;
+
+/**
+ * The statistics for the detector, accumulated over every frame since they
+ * were last reset.
+ **/
+typedef struct host_stats {
+    uint64_t frames;                    // Number of frames processed
+    uint64_t frame_ns;                  // Total time spent on the frames
+    int threshold;                      // Threshold for the next frame
+    scale_stats_t scales[NUM_SCALES];   // Statistics for each scale level
+} host_stats_t;
+
+/**
+ * A rectangular span of pixels at a scale level, covering [x0, x1) by [y0, y1).
+ * Spans with the same y0 share a band of rows, and are sorted left to right.
+ **/
+typedef struct pixel_span {
+    int x0;                             // First column in the span
+    int x1;                             // One past the last column in the span
+    int y0;                             // First row in the span
+    int y1;                             // One past the last row in the span
+} pixel_span_t;
+
+/**
+ * A single level of the image pyramid. The grayscale plane holds one byte per
+ * pixel, while the monochrome and detection planes are packed into 64-bit
+ * words, with the leftmost pixel of a word in its least significant bit. All of
+ * the planes are stored in row-major order.
+ **/
+typedef struct scale_level {
+    int scale;                          // Scale factor relative to the image
+    int width;                          // Width of the level, in pixels
+    int height;                         // Height of the level, in pixels
+    int mask_words;                     // Words per row of monochrome
+    int tile_rows;                      // Number of rows of occupancy tiles
+    int tile_words;                     // Words per row of occupancy
+    std::vector<uint8_t> gray;          // Grayscale values of the level
+    std::vector<uint64_t> mono;         // Packed monochrome values
+    std::vector<uint64_t> occupancy;    // Tiles with any monochrome bit set
+    std::vector<uint64_t> search;       // Tiles searched when pruning
+    std::vector<uint64_t> detections;   // Packed blob centerpoints
+    std::vector<uint32_t> integral;     // Integral image of the monochrome
+    std::vector<pixel_span_t> spans;    // The pixels inside the ROI
+    std::vector<bbox_t> bboxes;         // Boxes found by a detection thread
+    int num_bboxes;                     // Number of boxes found by the thread
+    scale_stats_t stats;                // Statistics for the level
+} scale_level_t;
+
+/**
+ * The state of the host detector. The buffers for each scale level are
+ * allocated once, and reused for every frame. Likewise, the detection threads
+ * of the threaded pipeline, and the rings feeding them, are started once, and
+ * wait for each frame.
+ **/
+typedef struct host_detector {
+    int width;                          // Width of the full-resolution image
+    int height;                         // Height of the full-resolution image
+    input_format_t format;              // The format of the input images
+    int box_size;                       // Box filter's inner size, 0 for LoG
+    int coarse_levels;                  // Levels searched in full
+    int prune_margin;                   // Margin searched around coarse blobs
+    threshold_mode_t threshold_mode;    // How the threshold is chosen
+    int threshold;                      // Monochrome threshold for the frame
+    uint32_t histogram[HISTOGRAM_BINS]; // Histogram of the frame's grayscale
+    scale_level_t levels[NUM_SCALES];   // The levels of the image pyramid
+    roi_mask_t full_roi;                // ROI covering the whole image
+    const roi_mask_t *roi;              // The current region of interest
+    uint64_t frames;                    // Number of frames processed
+    uint64_t frame_ns;                  // Total time spent on the frames
+
+    // The detection threads, and the rings of monochrome rows feeding them
+    spsc_ring<uint64_t> rings[NUM_SCALES];
+    std::thread workers[NUM_SCALES];
+    std::mutex worker_lock;             // Protects the frame state below
+    std::condition_variable frame_start; // Signals the workers a new frame
+    std::condition_variable frame_done; // Signals the last worker finished
+    uint64_t frame_number;              // Number of frames started
+    int busy_workers;                   // Workers still on the frame
+    int frame_max_bboxes;               // Boxes each level can hold
+    bool stopping;                      // Tells the workers to exit
+} host_detector_t;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Initializes the host detector for RGBA images of the given size, with the
+ * region of interest covering the whole image, and starts the detection
+ * threads of the threaded pipeline. A detector that was already initialized
+ * is destroyed first, so it can be initialized again for a new size.
+ *
+ * @param[out] detector The host detector to initialize.
+ * @param width The width of the images that will be processed.
+ * @param height The height of the images that will be processed.
+ * @return 0 on success, -1 if the image size is invalid.
+ **/
+int host_detector_init(host_detector_t& detector, int width, int height);
+
+/**
+ * Stops and joins the detection threads of the host detector. This must be
+ * called once the detector is no longer used, even if initialization failed.
+ *
+ * @param detector The host detector.
+ **/
+void host_detector_destroy(host_detector_t& detector);
+
+/**
+ * Sets the region of interest for the host detector.
+ *
+ * Pixels in tiles outside of the region are treated as black, and the detector
+ * skips all work for them at every scale level. The ROI mask must outlive its
+ * use by the detector.
+ *
+ * @param detector The host detector.
+ * @param[in] roi The ROI mask to use, or NULL to process the whole image.
+ * @return 0 on success, -1 if the ROI mask does not match the image size.
+ **/
+int host_detector_set_roi(host_detector_t& detector, const roi_mask_t *roi);
+
+/**
+ * Sets the format of the images passed to the host detector.
+ *
+ * Luma and Bayer images are a single byte per pixel, a quarter of the size of
+ * RGBA, and skip the conversion to RGBA entirely. For NV12 and I420 frames,
+ * only the luma plane at the start of the frame is read. Luma differs from the
+ * average of the RGB channels that RGBA images are converted with, so the
+ * detections can differ slightly from those on the same image in RGBA.
+ *
+ * @param detector The host detector.
+ * @param format The format of the images.
+ **/
+void host_detector_set_format(host_detector_t& detector,
+        input_format_t format);
+
+/**
+ * Sets the size of the box filter that the host detector uses in place of the
+ * LoG filter, or switches back to the LoG filter.
+ *
+ * The box filter approximates a LoG filter of any size, by comparing the
+ * density of set pixels in an inner box around each pixel to the density in
+ * the ring around it, out to an outer box of 2 * size - 1 pixels. The box sums
+ * are looked up in an integral image of each level's monochrome plane, which
+ * is built in a single pass, so the filter costs the same per pixel whatever
+ * its size. Like the LoG filter, it is only evaluated at set pixels, and only
+ * the strongest response among the set pixels around each one is kept, so a
+ * large blob is detected once. A size of 3 covers the same window as the LoG
+ * filter. There are no detections within the outer box's reach of the edges,
+ * so scale levels smaller than the outer box have no detections.
+ *
+ * @param detector The host detector.
+ * @param size The width of the inner box, which must be odd and at least 3,
+ *        or 0 to use the LoG filter.
+ * @return 0 on success, -1 if the size is invalid.
+ **/
+int host_detector_set_box_filter(host_detector_t& detector, int size);
+
+/**
+ * Sets how the host detector chooses the threshold that converts grayscale to
+ * monochrome, and resets the threshold to the default.
+ *
+ * With an adaptive threshold, the histogram of the grayscale values is counted
+ * as each row is converted to grayscale, while the row is still in the cache,
+ * and the threshold for the next frame is computed from it at the end of the
+ * frame. The percentile threshold is the same as the hardware's, though only
+ * the pixels inside the region of interest are counted. Otsu's method splits
+ * the histogram into the two classes with the most variance between them,
+ * which suits frames with many bright pixels better.
+ *
+ * @param detector The host detector.
+ * @param mode How the threshold is chosen.
+ **/
+void host_detector_set_threshold(host_detector_t& detector,
+        threshold_mode_t mode);
+
+/**
+ * Sets how many of the coarsest scale levels the host detector searches in
+ * full, pruning the search of the finer levels.
+ *
+ * With pruning, the levels are searched from the coarsest to the finest. Each
+ * finer level is only searched in the tiles within the margin of the blobs
+ * found at the level above it, and in the tiles with saturated pixels, so
+ * only the tiles around the lights are searched at full resolution. The
+ * detections in the searched tiles are the same as without pruning, but the
+ * blobs elsewhere are missed, such as a dim blob too small to see at the
+ * coarser levels, so a larger margin trades speed for recall. Only
+ * host_detect_blobs() prunes the levels, since the levels are searched at the
+ * same time in host_detect_blobs_threaded().
+ *
+ * @param detector The host detector.
+ * @param coarse_levels The number of the coarsest levels searched in full,
+ *        from 1 to NUM_SCALES, where NUM_SCALES disables pruning.
+ * @param margin The distance searched around each blob at the next finer
+ *        level, in pixels at that level.
+ * @return 0 on success, -1 if the levels or margin are invalid.
+ **/
+int host_detector_set_pruning(host_detector_t& detector, int coarse_levels,
+        int margin);
+
+/**
+ * Runs multi-scale blob detection on the given image, in the detector's
+ * input format.
+ *
+ * The bounding boxes are ordered by scale level, then in row-major order of
+ * their centerpoints within each level. At most max_bboxes are written.
+ *
+ * @param detector The host detector.
+ * @param[in] image The pixels of the image, in row-major order.
+ * @param[out] bboxes The buffer to write the bounding boxes to.
+ * @param max_bboxes The number of bounding boxes the buffer can hold.
+ * @return The number of bounding boxes written to the buffer.
+ **/
+int host_detect_blobs(host_detector_t& detector, const void *image,
+        bbox_t *bboxes, int max_bboxes);
+
+/**
+ * Runs multi-scale blob detection on the given image, in the detector's input
+ * format, with the stages of the pipeline on multiple threads.
+ *
+ * Like the hardware, each scale level has its own detection stage, running on
+ * its own thread, which is started with the detector and waits for each frame.
+ * The calling thread builds the image pyramid, and streams rows of monochrome
+ * values to the detection stages through lock-free rings.
+ * The bounding boxes are the same as those from host_detect_blobs().
+ *
+ * @param detector The host detector.
+ * @param[in] image The pixels of the image, in row-major order.
+ * @param[out] bboxes The buffer to write the bounding boxes to.
+ * @param max_bboxes The number of bounding boxes the buffer can hold.
+ * @return The number of bounding boxes written to the buffer.
+ **/
+int host_detect_blobs_threaded(host_detector_t& detector,
+        const void *image, bbox_t *bboxes, int max_bboxes);
+
+/**
+ * Gets the statistics accumulated by the host detector since they were last
+ * reset. The statistics are all zero unless the detector was built with
+ * HOST_DETECTOR_STATS defined.
+ *
+ * @param[in] detector The host detector.
+ * @param[out] stats The statistics for the detector.
+ **/
+void host_detector_stats(const host_detector_t& detector, host_stats_t& stats);
+
+/**
+ * Resets all of the host detector's statistics to zero.
+ *
+ * @param detector The host detector.
+ **/
+void host_detector_reset_stats(host_detector_t& detector);
+
+#endif /* HOST_DETECTOR_H_ */
@@ -0,0 +1,269 @@
+/**
+ * @file host_detector_test.cpp
+ * @date Monday, October 19, 2026 at 01:15:48 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for the host blob detector.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+
+#include <algorithm>                // Fill function
+#include <vector>                   // Vector container
+
+#include "host_detector.h"          // Host detector interface
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The size of the test image
+static const int TEST_WIDTH     = 128;
+static const int TEST_HEIGHT    = 128;
+
+// The centerpoint of the blob in the test image
+static const int BLOB_X         = 40;
+static const int BLOB_Y         = 40;
+
+// The size of the large square blob, and of the box filter that detects it
+static const int SQUARE_SIZE    = 9;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+// Draws a plus-shaped white blob, which is only detected at its centerpoint
+template <typename T>
+static void draw_blob(std::vector<T>& image, int cx, int cy, const T& white)
+{
+    const int offsets[][2] = {{0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}};
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        int x = cx + offsets[i][0];
+        int y = cy + offsets[i][1];
+        image[y * TEST_WIDTH + x] = white;
+    }
+}
+
+/* Fills the image with a Bayer mosaic of a single color, where the green
+ * samples are on the pixels whose coordinates sum to the parity. */
+static void fill_bayer(std::vector<uint8_t>& mosaic, int green_parity,
+        const pixel_t& color)
+{
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            uint8_t& sample = mosaic[y * TEST_WIDTH + x];
+            if ((x + y) % 2 == green_parity) {
+                sample = color.green;
+            } else {
+                sample = (y % 2 == 0) ? color.red : color.blue;
+            }
+        }
+    }
+}
+
+int main()
+{
+    std::vector<pixel_t> image(TEST_WIDTH * TEST_HEIGHT, pixel_t(0, 0, 0, 0));
+    const pixel_t white(255, 255, 255, 255);
+    draw_blob(image, BLOB_X, BLOB_Y, white);
+
+    host_detector_t detector;
+    int rc = host_detector_init(detector, TEST_WIDTH, TEST_HEIGHT);
+    assert(rc == 0);
+
+    // The blob should be found only at the full-resolution scale level
+    bbox_t bboxes[16];
+    int num_bboxes = host_detect_blobs(detector, image.data(), bboxes, 16);
+    assert(num_bboxes == 1);
+    assert(bboxes[0].x1 == BLOB_X - 3 && bboxes[0].y1 == BLOB_Y - 3);
+    assert(bboxes[0].x2 == BLOB_X + 3 && bboxes[0].y2 == BLOB_Y + 3);
+
+    // Masking out the tile containing the blob should remove the detection
+    roi_mask_t roi;
+    rc = roi_mask_init(roi, TEST_WIDTH, TEST_HEIGHT, ROI_DEFAULT_TILE_SIZE);
+    assert(rc == 0);
+    roi.tiles[(BLOB_Y / roi.tile_size) * roi.tile_cols +
+            BLOB_X / roi.tile_size] = 0;
+    rc = host_detector_set_roi(detector, &roi);
+    assert(rc == 0);
+    num_bboxes = host_detect_blobs(detector, image.data(), bboxes, 16);
+    assert(num_bboxes == 0);
+
+    // A blob in a tile that is still inside the region is detected
+    draw_blob(image, TEST_WIDTH - BLOB_X, TEST_HEIGHT - BLOB_Y, white);
+    num_bboxes = host_detect_blobs(detector, image.data(), bboxes, 16);
+    assert(num_bboxes == 1);
+    assert(bboxes[0].x1 == TEST_WIDTH - BLOB_X - 3);
+
+    // The threaded pipeline finds the same blobs
+    host_detector_reset_stats(detector);
+    num_bboxes = host_detect_blobs_threaded(detector, image.data(), bboxes, 16);
+    assert(num_bboxes == 1);
+    assert(bboxes[0].x1 == TEST_WIDTH - BLOB_X - 3);
+
+    // The statistics count the blob's pixels, and the box that didn't fit
+    num_bboxes = host_detect_blobs(detector, image.data(), bboxes, 0);
+    assert(num_bboxes == 0);
+    host_stats_t stats;
+    host_detector_stats(detector, stats);
+    if (HOST_STATS_ENABLED) {
+        const scale_stats_t& scale0 = stats.scales[0];
+        assert(stats.frames == 2);
+        assert(scale0.pixels_in == 2 * TEST_WIDTH * TEST_HEIGHT);
+        assert(scale0.mono_pixels == 2 * 5 && scale0.detections == 2);
+        assert(scale0.bboxes == 1 && scale0.dropped_bboxes == 1);
+    } else {
+        assert(stats.frames == 0 && stats.scales[0].detections == 0);
+    }
+
+    // The threaded pipeline also stops at a full buffer, or an empty one
+    assert(host_detect_blobs_threaded(detector, image.data(), bboxes, 0) == 0);
+    assert(host_detect_blobs_threaded(detector, image.data(), bboxes, 1) == 1);
+
+    // A luma plane is read as the grayscale image directly
+    host_detector_set_roi(detector, NULL);
+    host_detector_set_format(detector, INPUT_LUMA);
+    std::vector<uint8_t> plane(TEST_WIDTH * TEST_HEIGHT, 0);
+    draw_blob(plane, BLOB_X, BLOB_Y, (uint8_t)255);
+    num_bboxes = host_detect_blobs(detector, plane.data(), bboxes, 16);
+    assert(num_bboxes == 1);
+    assert(bboxes[0].x1 == BLOB_X - 3 && bboxes[0].y1 == BLOB_Y - 3);
+
+    /* Every pixel of a Bayer mosaic of a single color demosaics to the average
+     * of its RGB channels, including the last row and column, in either
+     * position of the green samples. */
+    const pixel_t color(30, 90, 201, 255);
+    const int color_gray = (color.red + color.green + color.blue) / 3;
+    const input_format_t bayer_formats[] = {INPUT_BAYER_GRBG,
+            INPUT_BAYER_RGGB};
+    for (int parity = 0; parity < 2; parity++) {
+        fill_bayer(plane, parity, color);
+        host_detector_set_format(detector, bayer_formats[parity]);
+        host_detect_blobs_threaded(detector, plane.data(), bboxes, 16);
+        const std::vector<uint8_t>& gray = detector.levels[0].gray;
+        for (size_t i = 0; i < gray.size(); i++) {
+            assert(gray[i] == color_gray);
+        }
+    }
+
+    /* The fixed-point grayscale of an RGBA pixel is exactly the average of its
+     * channels, rounded down, for every sum of the channels. */
+    const int max_sum = 3 * 255;
+    for (int sum = 0; sum <= max_sum; sum++) {
+        int red = std::min(sum, 255);
+        int green = std::min(sum - red, 255);
+        image[sum] = pixel_t(red, green, sum - red - green, 255);
+    }
+    host_detector_set_format(detector, INPUT_RGBA);
+    host_detect_blobs(detector, image.data(), bboxes, 16);
+    for (int sum = 0; sum <= max_sum; sum++) {
+        assert(detector.levels[0].gray[sum] == sum / 3);
+    }
+
+    /* A large square blob is detected once at its center by a box filter of
+     * its size, in both pipelines, and the box covers the filter's reach. */
+    assert(host_detector_set_box_filter(detector, 4) == -1);
+    assert(host_detector_set_box_filter(detector, 1) == -1);
+    assert(host_detector_set_box_filter(detector, SQUARE_SIZE) == 0);
+    host_detector_set_format(detector, INPUT_LUMA);
+    std::fill(plane.begin(), plane.end(), 0);
+    for (int y = -SQUARE_SIZE/2; y <= SQUARE_SIZE/2; y++) {
+        for (int x = -SQUARE_SIZE/2; x <= SQUARE_SIZE/2; x++) {
+            plane[(BLOB_Y + y) * TEST_WIDTH + BLOB_X + x] = 255;
+        }
+    }
+    for (int threaded = 0; threaded < 2; threaded++) {
+        num_bboxes = threaded ?
+                host_detect_blobs_threaded(detector, plane.data(), bboxes, 16) :
+                host_detect_blobs(detector, plane.data(), bboxes, 16);
+        assert(num_bboxes == 1);
+        assert(bboxes[0].x1 == BLOB_X - SQUARE_SIZE);
+        assert(bboxes[0].y2 == BLOB_Y + SQUARE_SIZE);
+    }
+    assert(host_detector_set_box_filter(detector, 0) == 0);
+    assert(detector.levels[0].integral.empty());
+
+    /* A large dim blob is only detected at the coarsest level, and a small dim
+     * blob away from it only at full resolution, so pruning the finer levels
+     * misses the small blob, unless the margin reaches it. */
+    assert(host_detector_set_pruning(detector, 0, 0) == -1);
+    assert(host_detector_set_pruning(detector, NUM_SCALES + 1, 0) == -1);
+    assert(host_detector_set_pruning(detector, 1, -1) == -1);
+    const int coarse_scale = 1 << (NUM_SCALES - 1);
+    const uint8_t dim = 230;
+    std::fill(plane.begin(), plane.end(), 0);
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            int dx = x / coarse_scale - TEST_WIDTH / coarse_scale / 2;
+            int dy = y / coarse_scale - TEST_HEIGHT / coarse_scale / 2;
+            if (dx * dx + dy * dy <= 1) {
+                plane[y * TEST_WIDTH + x] = dim;
+            }
+        }
+    }
+    draw_blob(plane, BLOB_X, TEST_HEIGHT - BLOB_X / 2, dim);
+    assert(host_detect_blobs(detector, plane.data(), bboxes, 16) == 2);
+    assert(host_detector_set_pruning(detector, 1, PRUNE_DEFAULT_MARGIN) == 0);
+    assert(host_detect_blobs(detector, plane.data(), bboxes, 16) == 1);
+    assert(bboxes[0].x1 < TEST_WIDTH / 2 && bboxes[0].x2 > TEST_WIDTH / 2);
+    assert(host_detector_set_pruning(detector, 1, TEST_WIDTH) == 0);
+    assert(host_detect_blobs(detector, plane.data(), bboxes, 16) == 2);
+
+    // Saturated blobs are always searched, however far from the coarse blobs
+    assert(host_detector_set_pruning(detector, 1, 0) == 0);
+    draw_blob(plane, BLOB_X, TEST_HEIGHT - BLOB_X / 2, (uint8_t)255);
+    num_bboxes = host_detect_blobs(detector, plane.data(), bboxes, 16);
+    assert(num_bboxes == 2);
+    assert(bboxes[0].x1 == BLOB_X - 3);
+    assert(host_detector_set_pruning(detector, NUM_SCALES, 0) == 0);
+
+    /* A dim blob on a gray background is missed by the fixed threshold, but
+     * the percentile threshold computed from the first frame lies just above
+     * the background, so the blob is detected in the next frame, first at
+     * full resolution. */
+    std::fill(plane.begin(), plane.end(), 140);
+    draw_blob(plane, BLOB_X, BLOB_Y, (uint8_t)180);
+    host_stats_t threshold_stats;
+    for (int threaded = 0; threaded < 2; threaded++) {
+        host_detector_set_threshold(detector, THRESHOLD_PERCENTILE);
+        num_bboxes = threaded ?
+                host_detect_blobs_threaded(detector, plane.data(), bboxes, 16) :
+                host_detect_blobs(detector, plane.data(), bboxes, 16);
+        assert(num_bboxes == 0);
+        host_detector_stats(detector, threshold_stats);
+        assert(threshold_stats.threshold == 141);
+        num_bboxes = threaded ?
+                host_detect_blobs_threaded(detector, plane.data(), bboxes, 16) :
+                host_detect_blobs(detector, plane.data(), bboxes, 16);
+        assert(num_bboxes >= 1);
+        assert(bboxes[0].x1 == BLOB_X - 3 && bboxes[0].y1 == BLOB_Y - 3);
+    }
+
+    // Otsu's threshold splits a bimodal image between its two values
+    for (int i = 0; i < TEST_WIDTH * TEST_HEIGHT; i++) {
+        plane[i] = (i % TEST_WIDTH < TEST_WIDTH / 2) ? 140 : 200;
+    }
+    host_detector_set_threshold(detector, THRESHOLD_OTSU);
+    host_detect_blobs(detector, plane.data(), bboxes, 16);
+    host_detector_stats(detector, threshold_stats);
+    assert(threshold_stats.threshold == 141);
+
+    // A dark frame doesn't lower the threshold below the minimum
+    std::fill(plane.begin(), plane.end(), 0);
+    host_detect_blobs(detector, plane.data(), bboxes, 16);
+    host_detector_stats(detector, threshold_stats);
+    assert(threshold_stats.threshold == ADAPTIVE_MIN_THRESHOLD);
+
+    // The fixed threshold never changes
+    host_detector_set_threshold(detector, THRESHOLD_FIXED);
+    host_detect_blobs(detector, plane.data(), bboxes, 16);
+    host_detector_stats(detector, threshold_stats);
+    assert(threshold_stats.threshold == MONOCHROME_THRESHOLD);
+
+    host_detector_destroy(detector);
+    printf("Host detector test passed.\n");
+    return 0;
+}
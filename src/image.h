@@ -17,6 +17,7 @@
 #ifndef IMAGE_H_
 #define IMAGE_H_
 
+#include <stddef.h>             // Definition of size_t
 #include <stdint.h>             // Fixed-size integer types
 
 // The size of the images we're going to be processing
@@ -65,7 +66,14 @@ struct matrix {
     }
 };
 
-// Alias for an image containing 32-bit RGBA pixels
-typedef matrix<pixel, IMAGE_WIDTH, IMAGE_HEIGHT> image_t;
+/* Alias for the image sent to the hardware, which contains 32-bit RGBA pixels,
+ * unless the hardware is built to read a luma plane or a Bayer mosaic (with
+ * LUMA_INPUT or BAYER_INPUT), which have a single byte per pixel. */
+#if defined(LUMA_INPUT) || defined(BAYER_INPUT)
+typedef uint8_t input_pixel_t;
+#else
+typedef pixel input_pixel_t;
+#endif /* defined(LUMA_INPUT) || defined(BAYER_INPUT) */
+typedef matrix<input_pixel_t, IMAGE_WIDTH, IMAGE_HEIGHT> image_t;
 
 #endif /* IMAGE_H_ */
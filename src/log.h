@@ -0,0 +1,31 @@
+/**
+ * @file log.h
+ * @date Monday, October 19, 2026 at 10:12:40 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the logging macros shared by the software.
+ *
+ * The verbose messages are only printed when VERBOSE is defined before this
+ * file is included.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef LOG_H_
+#define LOG_H_
+
+#include <cstdio>                   // C standard I/O library
+
+/* A macro to print an error message, on stderr so that it never mixes with
+ * data an application writes to stdout. */
+#define log_err(msg, ...) fprintf(stderr, "%s: %s: %d: Error: " msg, \
+        __FILE__, __func__, __LINE__, ##__VA_ARGS__)
+
+// A macro to enable print messages when VERBOSE is defined
+#ifdef VERBOSE
+#define log_verbose(...) printf(__VA_ARGS__)
+#else
+#define log_verbose(...)
+#endif
+
+#endif /* LOG_H_ */
@@ -0,0 +1,391 @@
+/**
+ * @file log_quantize.cpp
+ * @date Thursday, October 29, 2026 at 10:08:52 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the application that searches for reduced-precision LoG
+ * filter weights.
+ *
+ * The monochrome windows are binary, so the LoG response is just the sum of the
+ * weights under the set pixels, and integer weights of a few bits, scaled by a
+ * common factor, can make the same decisions as the hardware's 16-bit weights,
+ * with much narrower adders. The application runs the host detector on raw
+ * RGBA image files, and counts every window the filter is evaluated on. Then,
+ * for each weight width, it scales the filter to each integer center weight
+ * that fits the width, rounds the other weights, and picks the threshold with
+ * the fewest decisions that differ from the full-precision filter's on the
+ * images. The best weights of each width are also compared against the full
+ * filter on every possible window, and the narrowest weights that match on
+ * the images are printed, to be used as the reduced-precision filter.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstdlib>                  // C standard library
+#include <cstdio>                   // C standard I/O library
+#include <cmath>                    // Rounding function
+
+#include <unistd.h>                 // Command line option parsing
+
+#include <algorithm>                // Min and max functions
+#include <unordered_map>            // Hash table container
+#include <vector>                   // Vector container
+
+#include "host_detector.h"          // Host detector interface
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The default range of weight widths searched, in bits, including the sign
+static const int DEFAULT_MIN_BITS   = 4;
+static const int DEFAULT_MAX_BITS   = 10;
+
+// The number of bits in a window, and the number of distinct rows of a window
+static const int WINDOW_BITS        = BLOB_FILTER_WIDTH * BLOB_FILTER_HEIGHT;
+static const int ROW_VALUES         = 1 << BLOB_FILTER_WIDTH;
+
+// The row and column of the center tap of the filter
+static const int CENTER             = BLOB_FILTER_WIDTH / 2;
+
+// The width of the full filter's weights in the hardware, including the sign
+static const int FULL_WEIGHT_BITS   = 16;
+
+// The number of times each window was seen in the images, by its bits
+typedef std::unordered_map<uint32_t, uint64_t> window_counts_t;
+
+// The response of each row of a filter, indexed by the bits of the row
+typedef int row_table_t[BLOB_FILTER_HEIGHT][ROW_VALUES];
+
+// A quantized filter, and how its decisions compare to the full filter's
+typedef struct quantized_filter {
+    int weights[BLOB_FILTER_HEIGHT][BLOB_FILTER_WIDTH];
+    int threshold;                  // The threshold on the response
+    int response_bits;              // Bits of the response, with its sign
+    uint64_t missed;                // Windows only the full filter detects
+    uint64_t extra;                 // Windows only this filter detects
+} quantized_filter_t;
+
+// The response of each row of the full filter, indexed by the bits of the row
+static row_table_t full_row_table;
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+static void print_usage(const char *program)
+{
+    printf("Usage: %s [-w min_bits] [-W max_bits] <width> <height> <image> "
+            "[image ...]\n", program);
+    printf("\t-w\tThe narrowest weights searched, in bits (default %d).\n",
+            DEFAULT_MIN_BITS);
+    printf("\t-W\tThe widest weights searched, in bits (default %d).\n",
+            DEFAULT_MAX_BITS);
+}
+
+static int read_image(const char *path, std::vector<pixel_t>& image)
+{
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        log_err("%s: Unable to open input image file.\n", path);
+        return -1;
+    }
+
+    size_t pixels_read = fread(image.data(), sizeof(image[0]), image.size(),
+            file);
+    fclose(file);
+    if (pixels_read != image.size()) {
+        log_err("%s: File size does not match input image's. Expected %zu "
+                "pixels, but read %zu.\n", path, image.size(), pixels_read);
+        return -1;
+    }
+
+    return 0;
+}
+
+// Computes the response of each row of the filter for every row of a window
+static void init_row_table(const int filter[BLOB_FILTER_HEIGHT]
+        [BLOB_FILTER_WIDTH], row_table_t table)
+{
+    for (int i = 0; i < BLOB_FILTER_HEIGHT; i++) {
+        for (int bits = 0; bits < ROW_VALUES; bits++) {
+            table[i][bits] = 0;
+            for (int j = 0; j < BLOB_FILTER_WIDTH; j++) {
+                table[i][bits] += ((bits >> j) & 1) ? filter[i][j] : 0;
+            }
+        }
+    }
+}
+
+// Computes a filter's response to a window, with row i in bits [5i, 5i + 5)
+static int window_response(const row_table_t table, uint32_t window)
+{
+    int response = 0;
+    for (int i = 0; i < BLOB_FILTER_HEIGHT; i++) {
+        response += table[i][(window >> (i * BLOB_FILTER_WIDTH)) &
+                (ROW_VALUES - 1)];
+    }
+
+    return response;
+}
+
+/* Counts the windows around every pixel of each scale level of the detector's
+ * last frame, where the filter is evaluated, i.e. away from the edges. */
+static void count_windows(const host_detector_t& detector,
+        window_counts_t& counts)
+{
+    for (int s = 0; s < NUM_SCALES; s++) {
+        const scale_level_t& level = detector.levels[s];
+        for (int y = CENTER; y < level.height - CENTER; y++) {
+            for (int x = CENTER; x < level.width - CENTER; x++) {
+                uint32_t window = 0;
+                for (int i = 0; i < BLOB_FILTER_HEIGHT; i++) {
+                    const uint64_t *mono = &level.mono[(y - CENTER + i) *
+                            level.mask_words];
+                    for (int j = 0; j < BLOB_FILTER_WIDTH; j++) {
+                        int px = x - CENTER + j;
+                        uint32_t bit = (mono[px / MASK_WORD_BITS] >>
+                                (px % MASK_WORD_BITS)) & 1;
+                        window |= bit << (i * BLOB_FILTER_WIDTH + j);
+                    }
+                }
+                counts[window] += 1;
+            }
+        }
+    }
+}
+
+/* Scales the full filter so its center tap has the given weight, rounding the
+ * other taps, and finds the range of its responses. */
+static void quantize_filter(int center_weight, quantized_filter_t& filter,
+        int& min_response, int& max_response)
+{
+    min_response = 0;
+    max_response = 0;
+    for (int i = 0; i < BLOB_FILTER_HEIGHT; i++) {
+        for (int j = 0; j < BLOB_FILTER_WIDTH; j++) {
+            int weight = lround((double)LOG_FILTER[i][j] * center_weight /
+                    LOG_FILTER[CENTER][CENTER]);
+            filter.weights[i][j] = weight;
+            min_response += std::min(weight, 0);
+            max_response += std::max(weight, 0);
+        }
+    }
+
+    int magnitude = std::max(-min_response, max_response);
+    filter.response_bits = 1;
+    while ((1 << (filter.response_bits - 1)) <= magnitude) {
+        filter.response_bits += 1;
+    }
+}
+
+/* Picks the threshold for the quantized filter with the fewest decisions that
+ * differ from the full filter's on the counted windows, preferring the one
+ * nearest the full threshold scaled down. The threshold is kept above the
+ * largest response without the center pixel, so, like the full filter, only
+ * windows with their center set are detected. */
+static void choose_threshold(const window_counts_t& counts,
+        const row_table_t table, int center_weight, int min_response,
+        int max_response, quantized_filter_t& filter)
+{
+    // Count the full filter's detections and misses at each quantized response
+    int range = max_response - min_response + 1;
+    std::vector<uint64_t> detected(range, 0);
+    std::vector<uint64_t> rejected(range, 0);
+    for (window_counts_t::const_iterator it = counts.begin();
+            it != counts.end(); ++it) {
+        int full = window_response(full_row_table, it->first);
+        int response = window_response(table, it->first) - min_response;
+        if (full >= LOG_RESPONSE_THRESHOLD) {
+            detected[response] += it->second;
+        } else {
+            rejected[response] += it->second;
+        }
+    }
+
+    /* Sweep the threshold up from the lowest response, where every window is
+     * detected, so the full filter's rejections are extra detections. */
+    uint64_t missed = 0;
+    uint64_t extra = 0;
+    for (int i = 0; i < range; i++) {
+        extra += rejected[i];
+    }
+
+    int off_center = max_response - std::max(center_weight, 0);
+    int target = lround((double)LOG_RESPONSE_THRESHOLD * center_weight /
+            LOG_FILTER[CENTER][CENTER]);
+    filter.threshold = target;
+    filter.missed = UINT64_MAX;
+    filter.extra = 0;
+    for (int threshold = min_response; threshold <= max_response + 1;
+            threshold++) {
+        if (threshold > off_center) {
+            // The first allowed threshold is taken, there is nothing to beat
+            bool better = (filter.missed == UINT64_MAX);
+            if (!better) {
+                uint64_t errors = missed + extra;
+                uint64_t best = filter.missed + filter.extra;
+                bool nearer = abs(threshold - target) <
+                        abs(filter.threshold - target);
+                better = (errors < best || (errors == best && nearer));
+            }
+            if (better) {
+                filter.threshold = threshold;
+                filter.missed = missed;
+                filter.extra = extra;
+            }
+        }
+
+        if (threshold <= max_response) {
+            missed += detected[threshold - min_response];
+            extra -= rejected[threshold - min_response];
+        }
+    }
+}
+
+/* Compares the decisions of the quantized filter against the full filter's on
+ * every possible window, returning the number that differ. */
+static uint64_t count_all_mismatches(const quantized_filter_t& filter)
+{
+    row_table_t table;
+    init_row_table(filter.weights, table);
+
+    uint64_t mismatches = 0;
+    for (uint32_t window = 0; window < (UINT32_C(1) << WINDOW_BITS);
+            window++) {
+        bool full = window_response(full_row_table, window) >=
+                LOG_RESPONSE_THRESHOLD;
+        bool quantized = window_response(table, window) >= filter.threshold;
+        mismatches += (full != quantized);
+    }
+
+    return mismatches;
+}
+
+// Prints the weights and threshold of the filter as C definitions
+static void print_filter(const quantized_filter_t& filter, int bits)
+{
+    printf("\n%d-bit weights:\n", bits);
+    printf("static const int LOG_NARROW_RESPONSE_THRESHOLD = %d;\n",
+            filter.threshold);
+    printf("static const int LOG_NARROW_FILTER[BLOB_FILTER_HEIGHT]"
+            "[BLOB_FILTER_WIDTH] = {\n");
+    for (int i = 0; i < BLOB_FILTER_HEIGHT; i++) {
+        printf("    {");
+        for (int j = 0; j < BLOB_FILTER_WIDTH; j++) {
+            printf("%4d%s", filter.weights[i][j],
+                    (j == BLOB_FILTER_WIDTH - 1) ? "" : ",");
+        }
+        printf("},\n");
+    }
+    printf("};\n");
+}
+
+/*----------------------------------------------------------------------------
+ * Main Application
+ *----------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[])
+{
+    // Parse the command line options
+    int min_bits = DEFAULT_MIN_BITS;
+    int max_bits = DEFAULT_MAX_BITS;
+    int opt;
+    while ((opt = getopt(argc, argv, "w:W:")) != -1) {
+        if (opt == 'w') {
+            min_bits = atoi(optarg);
+        } else if (opt == 'W') {
+            max_bits = atoi(optarg);
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind < 3 || min_bits < 2 || max_bits < min_bits ||
+            max_bits >= FULL_WEIGHT_BITS) {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    int width = atoi(argv[optind]);
+    int height = atoi(argv[optind+1]);
+
+    // Count the windows the filter is evaluated on in each image
+    host_detector_t detector;
+    if (host_detector_init(detector, width, height) != 0) {
+        return EXIT_FAILURE;
+    }
+    init_row_table(LOG_FILTER, full_row_table);
+    std::vector<pixel_t> image(width * height);
+    std::vector<bbox_t> bboxes(1);
+    window_counts_t counts;
+    uint64_t windows = 0;
+    uint64_t detections = 0;
+    for (int i = optind + 2; i < argc; i++) {
+        if (read_image(argv[i], image) != 0) {
+            host_detector_destroy(detector);
+            return EXIT_FAILURE;
+        }
+        host_detect_blobs(detector, image.data(), bboxes.data(), 0);
+        count_windows(detector, counts);
+    }
+    host_detector_destroy(detector);
+    for (window_counts_t::const_iterator it = counts.begin();
+            it != counts.end(); ++it) {
+        windows += it->second;
+        if (window_response(full_row_table, it->first) >=
+                LOG_RESPONSE_THRESHOLD) {
+            detections += it->second;
+        }
+    }
+    printf("%llu windows, %zu distinct, %llu detected by the %d-bit "
+            "filter\n\n", (unsigned long long)windows, counts.size(),
+            (unsigned long long)detections, FULL_WEIGHT_BITS);
+
+    /* For each width, try every center weight that fits it, but doesn't fit
+     * the next narrower width, and keep the one with the fewest mismatches. */
+    printf("bits  center  threshold  response bits  missed  extra  "
+            "mismatch rate  all windows\n");
+    quantized_filter_t narrowest;
+    int narrowest_bits = 0;
+    for (int bits = min_bits; bits <= max_bits; bits++) {
+        quantized_filter_t best;
+        best.missed = UINT64_MAX;
+        best.extra = 0;
+        int best_center = 0;
+        int max_weight = (1 << (bits - 1)) - 1;
+        for (int center = max_weight / 2 + 1; center <= max_weight; center++) {
+            quantized_filter_t filter;
+            int min_response, max_response;
+            quantize_filter(center, filter, min_response, max_response);
+            row_table_t table;
+            init_row_table(filter.weights, table);
+            choose_threshold(counts, table, center, min_response,
+                    max_response, filter);
+
+            if (filter.missed + filter.extra < best.missed + best.extra) {
+                best = filter;
+                best_center = center;
+            }
+        }
+
+        uint64_t all_mismatches = count_all_mismatches(best);
+        printf("%4d  %6d  %9d  %13d  %6llu  %5llu  %13.2e  %11.2e\n", bits,
+                best_center, best.threshold, best.response_bits,
+                (unsigned long long)best.missed,
+                (unsigned long long)best.extra,
+                (double)(best.missed + best.extra) / windows,
+                (double)all_mismatches / (1 << WINDOW_BITS));
+        if (narrowest_bits == 0 && best.missed + best.extra == 0) {
+            narrowest = best;
+            narrowest_bits = bits;
+        }
+    }
+
+    if (narrowest_bits == 0) {
+        printf("\nNo weights searched match the full filter on the images.\n");
+        return EXIT_SUCCESS;
+    }
+    print_filter(narrowest, narrowest_bits);
+    return EXIT_SUCCESS;
+}
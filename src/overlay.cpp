@@ -0,0 +1,64 @@
+/**
+ * @file overlay.cpp
+ * @date Saturday, October 24, 2026 at 02:47:13 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation for drawing bounding boxes over
+ * frames.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <algorithm>                // Min, max, and fill functions
+
+#include "overlay.h"                // Our interface
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Fills the rectangle with inclusive corners (x1, y1) and (x2, y2), clipped
+static void fill_rect(pixel_t *frame, int width, int height, int x1, int y1,
+        int x2, int y2, const pixel_t& color)
+{
+    x1 = std::max(x1, 0);
+    y1 = std::max(y1, 0);
+    x2 = std::min(x2, width - 1);
+    y2 = std::min(y2, height - 1);
+    if (x1 > x2 || y1 > y2) {
+        return;
+    }
+
+    for (int y = y1; y <= y2; y++) {
+        std::fill_n(&frame[y * width + x1], x2 - x1 + 1, color);
+    }
+}
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+void overlay_draw_bbox(pixel_t *frame, int width, int height,
+        const bbox_t& bbox, int thickness, const pixel_t& color)
+{
+    // The top and bottom edges span the whole box, the sides fill between
+    int x1 = bbox.x1, y1 = bbox.y1, x2 = bbox.x2, y2 = bbox.y2;
+    int t = thickness;
+    fill_rect(frame, width, height, x1, y1, x2, std::min(y1 + t - 1, y2),
+            color);
+    fill_rect(frame, width, height, x1, std::max(y2 - t + 1, y1 + t), x2, y2,
+            color);
+    fill_rect(frame, width, height, x1, y1 + t, std::min(x1 + t - 1, x2),
+            y2 - t, color);
+    fill_rect(frame, width, height, std::max(x2 - t + 1, x1 + t), y1 + t, x2,
+            y2 - t, color);
+}
+
+void overlay_draw_bboxes(pixel_t *frame, int width, int height,
+        const bbox_t *bboxes, int num_bboxes, int thickness,
+        const pixel_t& color)
+{
+    for (int i = 0; i < num_bboxes; i++) {
+        overlay_draw_bbox(frame, width, height, bboxes[i], thickness, color);
+    }
+}
@@ -0,0 +1,48 @@
+/**
+ * @file overlay.h
+ * @date Saturday, October 24, 2026 at 02:18:46 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface for drawing bounding boxes over frames.
+ *
+ * The boxes are drawn in place into a row-major RGBA frame buffer, as outlines
+ * of a given thickness just inside the box's edges. Each edge of the outline
+ * is a rectangle that is clipped to the frame, then filled one horizontal span
+ * at a time, so boxes that run off the edge of the frame are only partially
+ * drawn, and no pixel outside the frame is ever touched.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef OVERLAY_H_
+#define OVERLAY_H_
+
+#include "image.h"              // Definition of a pixel
+#include "bbox.h"               // Definition of a bounding box
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Draws the outline of a bounding box into a frame. The box's coordinates are
+ * inclusive, and its outline is drawn inside of them.
+ *
+ * @param frame The frame buffer, in row-major order.
+ * @param width The width of the frame, in pixels.
+ * @param height The height of the frame, in pixels.
+ * @param bbox The box to draw.
+ * @param thickness The thickness of the outline, in pixels.
+ * @param color The color of the outline.
+ **/
+void overlay_draw_bbox(pixel_t *frame, int width, int height,
+        const bbox_t& bbox, int thickness, const pixel_t& color);
+
+/**
+ * Draws the outlines of a list of bounding boxes into a frame.
+ **/
+void overlay_draw_bboxes(pixel_t *frame, int width, int height,
+        const bbox_t *bboxes, int num_bboxes, int thickness,
+        const pixel_t& color);
+
+#endif /* OVERLAY_H_ */
@@ -0,0 +1,86 @@
+/**
+ * @file overlay_test.cpp
+ * @date Saturday, October 24, 2026 at 03:26:55 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for drawing bounding boxes over frames.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+
+#include <algorithm>                // Fill function
+#include <vector>                   // Vector container
+
+#include "overlay.h"                // Bounding box overlay
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The size of the test frame, which is padded on both sides to catch overruns
+static const int TEST_WIDTH     = 16;
+static const int TEST_HEIGHT    = 12;
+static const int TEST_PADDING   = 64;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+// Returns true if the pixel has been drawn over
+static bool drawn(const pixel_t *frame, int x, int y)
+{
+    return frame[y * TEST_WIDTH + x].red == 255;
+}
+
+// Counts the pixels of the frame that have been drawn over
+static int count_drawn(const pixel_t *frame)
+{
+    int count = 0;
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            count += drawn(frame, x, y);
+        }
+    }
+    return count;
+}
+
+int main()
+{
+    const pixel_t black(0, 0, 0, 255), red(255, 0, 0, 255);
+    std::vector<pixel_t> buffer(TEST_WIDTH * TEST_HEIGHT + 2 * TEST_PADDING,
+            black);
+    pixel_t *frame = &buffer[TEST_PADDING];
+
+    // A box inside the frame is outlined inside of its edges
+    overlay_draw_bbox(frame, TEST_WIDTH, TEST_HEIGHT, bbox_t(2, 3, 7, 6), 1,
+            red);
+    assert(count_drawn(frame) == 2 * 6 + 2 * 2);
+    assert(drawn(frame, 2, 3) && drawn(frame, 7, 6) && drawn(frame, 2, 5));
+    assert(!drawn(frame, 3, 4) && !drawn(frame, 8, 6));
+
+    // A thick outline fills a small box completely, and nothing around it
+    std::fill(buffer.begin(), buffer.end(), black);
+    overlay_draw_bbox(frame, TEST_WIDTH, TEST_HEIGHT, bbox_t(1, 1, 4, 4), 3,
+            red);
+    assert(count_drawn(frame) == 16);
+
+    // Boxes running off every edge of the frame are clipped
+    std::fill(buffer.begin(), buffer.end(), black);
+    bbox_t bboxes[] = {bbox_t(-5, -5, 2, 2), bbox_t(13, 9, 20, 20),
+            bbox_t(-10, 4, 30, 6), bbox_t(-8, -8, -2, -2)};
+    overlay_draw_bboxes(frame, TEST_WIDTH, TEST_HEIGHT, bboxes, 4, 2, red);
+    assert(drawn(frame, 1, 0) && drawn(frame, 2, 2) && !drawn(frame, 0, 0));
+    assert(drawn(frame, 13, 9) && drawn(frame, 14, 11));
+    assert(!drawn(frame, 15, 11) && !drawn(frame, 12, 9));
+    assert(drawn(frame, 0, 4) && drawn(frame, 15, 6) && drawn(frame, 5, 5));
+    for (int i = 0; i < TEST_PADDING; i++) {
+        assert(buffer[i].red == 0);
+        assert(buffer[TEST_PADDING + TEST_WIDTH * TEST_HEIGHT + i].red == 0);
+    }
+
+    printf("Overlay test passed.\n");
+    return 0;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file preprocess_params.h
+ * @date Monday, November 02, 2026 at 09:41:05 AM EST
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the fixed-point parameters of the grayscale conversion
+ * and the downscaling of the pyramid.
+ *
+ * The host detector matches the hardware's results exactly, so both must use
+ * the same weights and shifts. This file has no dependencies, so the hardware
+ * includes it as well, by adding the src directory to its include path.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef PREPROCESS_PARAMS_H_
+#define PREPROCESS_PARAMS_H_
+
+/**
+ * The weights of the RGB channels in the grayscale value, in fixed point with
+ * GRAYSCALE_WEIGHT_BITS fractional bits, so the grayscale value is computed
+ * with constant multiplies and a shift, rather than a divider.
+ *
+ * By default, each weight is 1/3, rounded up, which makes the weighted sum the
+ * average of the channels, rounded down, for every 8-bit pixel. With
+ * BT601_GRAYSCALE defined, the weights are BT.601's luma coefficients, which
+ * sum to one, so white stays white.
+ **/
+#ifdef BT601_GRAYSCALE
+static const int GRAYSCALE_WEIGHT_BITS  = 8;
+static const int GRAYSCALE_RED_WEIGHT   = 77;       // 0.299
+static const int GRAYSCALE_GREEN_WEIGHT = 150;      // 0.587
+static const int GRAYSCALE_BLUE_WEIGHT  = 29;       // 0.114
+#else
+static const int GRAYSCALE_WEIGHT_BITS  = 11;
+static const int GRAYSCALE_RED_WEIGHT   = 683;      // 1/3
+static const int GRAYSCALE_GREEN_WEIGHT = 683;      // 1/3
+static const int GRAYSCALE_BLUE_WEIGHT  = 683;      // 1/3
+#endif /* BT601_GRAYSCALE */
+
+/**
+ * The amount that the image is scaled down by at each scale level, in each
+ * dimension, and the number of bits the sum of a block is shifted by to
+ * average it. The factor must be a power of two, so that the average doesn't
+ * need a divider.
+ **/
+static const int DOWNSCALE_FACTOR       = 2;
+static const int DOWNSCALE_SHIFT        = 2;
+static_assert((1 << DOWNSCALE_SHIFT) == DOWNSCALE_FACTOR * DOWNSCALE_FACTOR,
+        "The downscale window must hold 2^DOWNSCALE_SHIFT pixels.");
+
+#endif /* PREPROCESS_PARAMS_H_ */
@@ -0,0 +1,143 @@
+/**
+ * @file roi_mask.cpp
+ * @date Monday, October 19, 2026 at 10:48:13 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of the region-of-interest (ROI) mask.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstdio>                   // C standard I/O library
+#include <cstdlib>                  // C standard library
+#include <cstring>                  // C string library
+
+#include <vector>                   // Vector container
+
+#include "roi_mask.h"               // Our interface
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+/* The tile size must be a multiple of this, the scale factor of the smallest
+ * scale level (2^4), so tiles stay aligned at every scale. */
+static const int ROI_TILE_ALIGNMENT = 16;
+
+// The maximum length of a line in the ROI mask file
+static const int MAX_LINE_LEN       = 1024;
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+/* Reads the next non-comment line from the text, stripping the newline, and
+ * advances the text past it. Lines too long for the buffer are truncated. */
+static bool read_line(const char *&text, char *line, size_t line_size)
+{
+    while (*text != '\0') {
+        size_t length = strcspn(text, "\n");
+        size_t copied = (length < line_size - 1) ? length : line_size - 1;
+        memcpy(line, text, copied);
+        line[copied] = '\0';
+        line[strcspn(line, "\r")] = '\0';
+        text += (text[length] == '\n') ? length + 1 : length;
+        if (line[0] != '#') {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+int roi_mask_init(roi_mask_t& roi, int width, int height, int tile_size)
+{
+    if (tile_size <= 0 || tile_size % ROI_TILE_ALIGNMENT != 0) {
+        log_err("ROI tile size %d is not a multiple of %d.\n", tile_size,
+                ROI_TILE_ALIGNMENT);
+        return -1;
+    }
+
+    roi.tile_size = tile_size;
+    roi.tile_cols = (width + tile_size - 1) / tile_size;
+    roi.tile_rows = (height + tile_size - 1) / tile_size;
+    roi.tiles.assign(roi.tile_rows * roi.tile_cols, 1);
+    return 0;
+}
+
+int roi_mask_parse(roi_mask_t& roi, const char *name, const char *text,
+        int width, int height)
+{
+    // The first line of the file is the size of the tiles
+    char line[MAX_LINE_LEN+1];
+    if (!read_line(text, line, sizeof(line))) {
+        log_err("%s: ROI mask file is empty.\n", name);
+        return -1;
+    }
+    int rc = roi_mask_init(roi, width, height, atoi(line));
+    if (rc != 0) {
+        return rc;
+    }
+
+    // Each following line is one row of tiles
+    for (int row = 0; row < roi.tile_rows; row++) {
+        if (!read_line(text, line, sizeof(line)) ||
+                (int)strlen(line) != roi.tile_cols) {
+            log_err("%s: Row %d of the ROI mask does not have %d tiles.\n",
+                    name, row, roi.tile_cols);
+            return -1;
+        }
+
+        for (int col = 0; col < roi.tile_cols; col++) {
+            if (line[col] != '0' && line[col] != '1') {
+                log_err("%s: Invalid character '%c' in row %d of the ROI "
+                        "mask.\n", name, line[col], row);
+                return -1;
+            }
+            roi.tiles[row * roi.tile_cols + col] = line[col] - '0';
+        }
+    }
+
+    return 0;
+}
+
+int roi_mask_load(roi_mask_t& roi, const char *path, int width, int height)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        log_err("%s: Unable to open ROI mask file.\n", path);
+        return -1;
+    }
+
+    // Read the whole file, which is small, and parse it from memory
+    std::vector<char> text;
+    char buffer[MAX_LINE_LEN+1];
+    size_t bytes_read;
+    while ((bytes_read = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.insert(text.end(), buffer, buffer + bytes_read);
+    }
+    bool failed = ferror(file);
+    fclose(file);
+    if (failed) {
+        log_err("%s: Unable to read ROI mask file.\n", path);
+        return -1;
+    }
+    text.push_back('\0');
+
+    return roi_mask_parse(roi, path, text.data(), width, height);
+}
+
+int roi_mask_count(const roi_mask_t& roi)
+{
+    int count = 0;
+    for (size_t i = 0; i < roi.tiles.size(); i++) {
+        count += (roi.tiles[i] != 0);
+    }
+
+    return count;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file roi_mask.h
+ * @date Monday, October 19, 2026 at 10:31:52 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the region-of-interest (ROI) mask.
+ *
+ * The ROI mask divides the full-resolution frame into square tiles, and marks
+ * each tile as either inside or outside of the region of interest. Pixels in
+ * tiles outside the region are treated as black, so the detector can skip
+ * them entirely at every scale level.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef HOST_ROI_MASK_H_
+#define HOST_ROI_MASK_H_
+
+#include <stdint.h>             // Fixed-size integer types
+
+#include <vector>               // Vector container
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The default size of an ROI tile, in full-resolution pixels. The tile size
+ * must be a multiple of the largest scale factor in the detector, so that a
+ * tile always covers a whole number of pixels at every scale level.
+ **/
+static const int ROI_DEFAULT_TILE_SIZE = 64;
+
+/**
+ * A bitmap of tiles over the image, where a nonzero value indicates that the
+ * tile is inside the region of interest.
+ **/
+typedef struct roi_mask {
+    int tile_size;              // Size of a tile in full-resolution pixels
+    int tile_cols;              // Number of tiles along the image's width
+    int tile_rows;              // Number of tiles along the image's height
+    std::vector<uint8_t> tiles; // Row-major bitmap of the tiles
+
+    // Returns true if the given tile is inside the region of interest
+    bool test(int tile_row, int tile_col) const
+    {
+        return tiles[tile_row * tile_cols + tile_col] != 0;
+    }
+} roi_mask_t;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Initializes the ROI mask to cover the whole image, with every tile inside the
+ * region of interest.
+ *
+ * @param[out] roi The ROI mask to initialize.
+ * @param width The width of the full-resolution image.
+ * @param height The height of the full-resolution image.
+ * @param tile_size The size of each tile, in full-resolution pixels.
+ * @return 0 on success, -1 if the tile size is invalid.
+ **/
+int roi_mask_init(roi_mask_t& roi, int width, int height, int tile_size);
+
+/**
+ * Parses the ROI mask for an image of the given size from the text of an ROI
+ * mask file, for platforms without the C standard I/O library's files.
+ *
+ * Lines starting with '#' are comments. The first line gives the tile size,
+ * and it is followed by one line per row of tiles, with one character per
+ * tile: '1' if the tile is inside the region of interest, '0' if it is not.
+ *
+ * @param[out] roi The ROI mask to parse.
+ * @param name The name of the ROI mask file, for error messages.
+ * @param text The NUL-terminated contents of the ROI mask file.
+ * @param width The width of the full-resolution image.
+ * @param height The height of the full-resolution image.
+ * @return 0 on success, -1 if the text is malformed.
+ **/
+int roi_mask_parse(roi_mask_t& roi, const char *name, const char *text,
+        int width, int height);
+
+/**
+ * Loads the ROI mask for an image of the given size from a text file, in the
+ * format described by roi_mask_parse.
+ *
+ * @param[out] roi The ROI mask to load.
+ * @param path The path to the ROI mask file.
+ * @param width The width of the full-resolution image.
+ * @param height The height of the full-resolution image.
+ * @return 0 on success, -1 if the file is malformed or cannot be read.
+ **/
+int roi_mask_load(roi_mask_t& roi, const char *path, int width, int height);
+
+/**
+ * Returns the number of tiles in the ROI mask that are inside the region of
+ * interest.
+ **/
+int roi_mask_count(const roi_mask_t& roi);
+
+#endif /* HOST_ROI_MASK_H_ */
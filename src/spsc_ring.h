@@ -0,0 +1,250 @@
+/**
+ * @file spsc_ring.h
+ * @date Tuesday, October 20, 2026 at 09:14:27 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the definition of a single-producer, single-consumer
+ * (SPSC) ring buffer.
+ *
+ * The ring is the software equivalent of the hls::stream FIFOs between the
+ * stages of the hardware pipeline, for stages running on different threads.
+ * Rather than single packets, each slot of the ring holds a batch of elements,
+ * such as a row or a tile of an image. The ring is lock-free: the producer only
+ * writes the tail index, and the consumer only writes the head index, and the
+ * two indices are kept on separate cache lines so they do not false share.
+ * Likewise, each slot starts on a cache line, and is padded out to whole ones,
+ * with its count of elements stored at the start of the slot, so the producer
+ * filling in one slot never shares a line with the consumer reading another.
+ *
+ * Slots are accessed in place, so batches are never copied by the ring itself.
+ * The producer calls begin_write() to get the next free slot, fills it in, then
+ * publishes it with end_write(). The consumer calls begin_read() to get the
+ * next full slot, and releases it with end_read() once it is done with it.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+#include <stddef.h>             // Definition of size_t
+#include <stdint.h>             // Definition of uintptr_t
+
+#include <algorithm>            // Min and max functions
+#include <atomic>               // Atomic types and memory ordering
+#include <new>                  // Placement new
+#include <thread>               // Thread yield function
+#include <type_traits>          // Trivially copyable type trait
+#include <vector>               // Vector container
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The size of a cache line on the processors we target. Data that is written
+ * by different threads is aligned to this to avoid false sharing.
+ **/
+static const size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * A single-producer, single-consumer ring of batches of elements. The elements
+ * are copied in and out of the slots as raw memory, so they must be trivially
+ * copyable.
+ *
+ * @tparam T The type of the elements in a batch.
+ **/
+template <typename T>
+struct spsc_ring {
+    static_assert(std::is_trivially_copyable<T>::value,
+            "The ring's elements must be trivially copyable.");
+
+    // Consumer's state: the next slot to read, and its copy of the tail
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> head;
+    size_t cached_tail;
+
+    // Producer's state: the next slot to write, and its copy of the head
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> tail;
+    size_t cached_head;
+
+    /* Shared, read-only after initialization: the slots and their sizes. Each
+     * slot is its count, followed by its elements, in slot_size bytes. */
+    alignas(CACHE_LINE_SIZE) size_t num_slots;
+    size_t batch_size;
+    size_t count_size;
+    size_t slot_size;
+    std::vector<char> storage;
+    char *slots;
+
+    // Constructor
+    spsc_ring() {
+        head = 0;
+        tail = 0;
+        cached_head = 0;
+        cached_tail = 0;
+        num_slots = 0;
+        batch_size = 0;
+        count_size = 0;
+        slot_size = 0;
+        slots = NULL;
+    }
+
+    /**
+     * Allocates the ring's slots. This must be called before the ring is
+     * shared between threads.
+     *
+     * @param num_slots The number of batches the ring can hold.
+     * @param batch_size The maximum number of elements in a batch.
+     **/
+    void init(size_t num_slots, size_t batch_size) {
+        // Pad each slot out to whole cache lines, so slots don't false share
+        size_t elem_align = std::max(alignof(T), alignof(size_t));
+        this->num_slots = num_slots;
+        this->batch_size = batch_size;
+        this->count_size = (sizeof(size_t) + elem_align - 1) / elem_align *
+                elem_align;
+        this->slot_size = (count_size + batch_size * sizeof(T) +
+                CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+
+        // Align the first slot to a cache line, and so all of the others
+        storage.assign(num_slots * slot_size + CACHE_LINE_SIZE, 0);
+        uintptr_t address = reinterpret_cast<uintptr_t>(storage.data());
+        slots = storage.data() + (CACHE_LINE_SIZE - address % CACHE_LINE_SIZE) %
+                CACHE_LINE_SIZE;
+        for (size_t slot = 0; slot < num_slots; slot++) {
+            new (slot_start(slot)) size_t(0);
+            new (slot_elems(slot)) T[batch_size]();
+        }
+
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+        cached_head = 0;
+        cached_tail = 0;
+    }
+
+    // Returns the start of a slot, which is aligned to a cache line
+    char *slot_start(size_t slot) {
+        return slots + (slot % num_slots) * slot_size;
+    }
+
+    // Returns the count of elements stored at the start of a slot
+    size_t& slot_count(size_t slot) {
+        return *reinterpret_cast<size_t *>(slot_start(slot));
+    }
+
+    // Returns the elements of a slot, which follow its count
+    T *slot_elems(size_t slot) {
+        return reinterpret_cast<T *>(slot_start(slot) + count_size);
+    }
+
+    /*------------------------------------------------------------------------
+     * Producer Interface
+     *------------------------------------------------------------------------*/
+
+    /**
+     * Returns the next free slot to fill in, holding up to batch_size
+     * elements, or NULL if the ring is full.
+     **/
+    T *try_begin_write() {
+        size_t slot = tail.load(std::memory_order_relaxed);
+        if (slot - cached_head == num_slots) {
+            cached_head = head.load(std::memory_order_acquire);
+            if (slot - cached_head == num_slots) {
+                return NULL;
+            }
+        }
+
+        return slot_elems(slot);
+    }
+
+    // Returns the next free slot to fill in, waiting until one is available
+    T *begin_write() {
+        T *batch;
+        while ((batch = try_begin_write()) == NULL) {
+            std::this_thread::yield();
+        }
+
+        return batch;
+    }
+
+    // Publishes the slot from begin_write() to the consumer, with count elems
+    void end_write(size_t count) {
+        size_t slot = tail.load(std::memory_order_relaxed);
+        slot_count(slot) = count;
+        tail.store(slot + 1, std::memory_order_release);
+    }
+
+    // Copies the elements into the ring, splitting them into full batches
+    void write(const T *data, size_t count) {
+        while (count > 0) {
+            size_t batch_count = std::min(count, batch_size);
+            std::copy(data, data + batch_count, begin_write());
+            end_write(batch_count);
+            data += batch_count;
+            count -= batch_count;
+        }
+    }
+
+    /*------------------------------------------------------------------------
+     * Consumer Interface
+     *------------------------------------------------------------------------*/
+
+    /**
+     * Returns the next full slot, and the number of elements in it, or NULL if
+     * the ring is empty.
+     **/
+    const T *try_begin_read(size_t& count) {
+        size_t slot = head.load(std::memory_order_relaxed);
+        if (slot == cached_tail) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            if (slot == cached_tail) {
+                return NULL;
+            }
+        }
+
+        count = slot_count(slot);
+        return slot_elems(slot);
+    }
+
+    // Returns the next full slot, waiting until one is available
+    const T *begin_read(size_t& count) {
+        const T *batch;
+        while ((batch = try_begin_read(count)) == NULL) {
+            std::this_thread::yield();
+        }
+
+        return batch;
+    }
+
+    // Releases the slot from begin_read() back to the producer
+    void end_read() {
+        size_t slot = head.load(std::memory_order_relaxed);
+        head.store(slot + 1, std::memory_order_release);
+    }
+
+    /**
+     * Copies up to count elements out of the ring, consuming whole batches.
+     * The output buffer must have room for count rounded up to a full batch.
+     * Returns the number of elements read.
+     **/
+    size_t read(T *data, size_t count) {
+        size_t total = 0;
+        while (total < count) {
+            size_t batch_count;
+            const T *batch = begin_read(batch_count);
+            std::copy(batch, batch + batch_count, data + total);
+            end_read();
+            total += batch_count;
+        }
+
+        return total;
+    }
+
+    // Returns true if the ring has no full slots (consumer only)
+    bool empty() {
+        return head.load(std::memory_order_relaxed) ==
+                tail.load(std::memory_order_acquire);
+    }
+};
+
+#endif /* SPSC_RING_H_ */
@@ -0,0 +1,105 @@
+/**
+ * @file spsc_ring_test.cpp
+ * @date Tuesday, October 20, 2026 at 11:02:51 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for the single-producer, single-consumer ring.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+
+#include <thread>                   // Thread class
+#include <vector>                   // Vector container
+
+#include "spsc_ring.h"              // SPSC ring definition
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The dimensions of the ring under test
+static const size_t NUM_SLOTS   = 4;
+static const size_t BATCH_SIZE  = 37;
+
+// The number of values sent through the ring
+static const size_t NUM_VALUES  = 1000000;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+// Sends increasing values through the ring, in batches of varying size
+static void producer(spsc_ring<int>& ring)
+{
+    size_t value = 0;
+    for (size_t batch = 0; value < NUM_VALUES; batch++) {
+        size_t count = std::min(1 + batch % BATCH_SIZE, NUM_VALUES - value);
+        int *elems = ring.begin_write();
+        for (size_t i = 0; i < count; i++) {
+            elems[i] = value++;
+        }
+        ring.end_write(count);
+    }
+}
+
+int main()
+{
+    spsc_ring<int> ring;
+    ring.init(NUM_SLOTS, BATCH_SIZE);
+
+    // A full ring refuses new batches, and an empty one has nothing to read
+    size_t count;
+    assert(ring.empty() && ring.try_begin_read(count) == NULL);
+    for (size_t i = 0; i < NUM_SLOTS; i++) {
+        assert(ring.try_begin_write() != NULL);
+        ring.end_write(0);
+    }
+    assert(ring.try_begin_write() == NULL);
+    for (size_t i = 0; i < NUM_SLOTS; i++) {
+        assert(ring.try_begin_read(count) != NULL && count == 0);
+        ring.end_read();
+    }
+    assert(ring.empty());
+
+    /* Each slot, with its count, is on cache lines of its own, so no two slots
+     * share a line. */
+    for (size_t i = 0; i < NUM_SLOTS; i++) {
+        uintptr_t slot = reinterpret_cast<uintptr_t>(ring.slot_start(i));
+        uintptr_t elems = reinterpret_cast<uintptr_t>(ring.slot_elems(i));
+        assert(slot % CACHE_LINE_SIZE == 0);
+        assert(elems > slot && elems + BATCH_SIZE * sizeof(int) <=
+                slot + ring.slot_size);
+        assert(ring.slot_size % CACHE_LINE_SIZE == 0);
+    }
+
+    // Stream values across threads, and check they arrive in order
+    std::thread producer_thread(producer, std::ref(ring));
+    size_t expected = 0;
+    while (expected < NUM_VALUES) {
+        const int *elems = ring.begin_read(count);
+        for (size_t i = 0; i < count; i++) {
+            assert(elems[i] == (int)expected++);
+        }
+        ring.end_read();
+    }
+    producer_thread.join();
+    assert(ring.empty());
+
+    // The bulk interface splits the data into full batches
+    std::vector<int> data(3 * BATCH_SIZE);
+    std::vector<int> output(data.size());
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = i;
+    }
+    std::thread writer_thread(&spsc_ring<int>::write, &ring, data.data(),
+            data.size());
+    assert(ring.read(output.data(), output.size()) == output.size());
+    writer_thread.join();
+    assert(output == data);
+
+    printf("SPSC ring test passed.\n");
+    return 0;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file stream_mux.cpp
+ * @date Sunday, October 25, 2026 at 11:03:18 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of the stream multiplexer.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstddef>                  // Definition of NULL
+
+#include "stream_mux.h"             // Our interface
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Returns true if the source is one of the multiplexer's sources
+static bool valid_source(const stream_mux_t& mux, int source)
+{
+    return source >= 0 && source < mux.num_sources;
+}
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+int stream_mux_init(stream_mux_t& mux, int num_sources, int credits)
+{
+    if (num_sources < 1 || num_sources > STREAM_MUX_MAX_SOURCES ||
+            credits < 1 || credits > STREAM_MUX_MAX_CREDITS) {
+        return -1;
+    }
+
+    mux.num_sources = num_sources;
+    mux.credits = credits;
+    mux.next_source = 0;
+    for (int i = 0; i < num_sources; i++) {
+        stream_source_t& source = mux.sources[i];
+        source.head = 0;
+        source.queued = 0;
+        source.in_flight = 0;
+        source.next_frame = 0;
+        source.completed = 0;
+        source.rejected = 0;
+    }
+
+    return 0;
+}
+
+bool stream_mux_can_push(const stream_mux_t& mux, int source)
+{
+    if (!valid_source(mux, source)) {
+        return false;
+    }
+
+    const stream_source_t& state = mux.sources[source];
+    return state.queued + state.in_flight < mux.credits;
+}
+
+int stream_mux_push(stream_mux_t& mux, int source, void *frame,
+        stream_tag_t& tag)
+{
+    if (!valid_source(mux, source)) {
+        return -1;
+    }
+
+    stream_source_t& state = mux.sources[source];
+    if (!stream_mux_can_push(mux, source)) {
+        state.rejected++;
+        return -1;
+    }
+
+    // The credits bound the queue, so it never overflows
+    int slot = (state.head + state.queued) % STREAM_MUX_MAX_CREDITS;
+    state.queue[slot] = frame;
+    state.frames[slot] = state.next_frame;
+    state.queued++;
+
+    tag.source = source;
+    tag.frame = state.next_frame++;
+    return 0;
+}
+
+void *stream_mux_pop(stream_mux_t& mux, stream_tag_t& tag)
+{
+    for (int i = 0; i < mux.num_sources; i++) {
+        int source = (mux.next_source + i) % mux.num_sources;
+        stream_source_t& state = mux.sources[source];
+        if (state.queued == 0) {
+            continue;
+        }
+
+        // Take the oldest frame, and start the next scan after this source
+        void *frame = state.queue[state.head];
+        tag.source = source;
+        tag.frame = state.frames[state.head];
+        state.head = (state.head + 1) % STREAM_MUX_MAX_CREDITS;
+        state.queued--;
+        state.in_flight++;
+        mux.next_source = (source + 1) % mux.num_sources;
+        return frame;
+    }
+
+    return NULL;
+}
+
+int stream_mux_complete(stream_mux_t& mux, const stream_tag_t& tag)
+{
+    if (!valid_source(mux, tag.source)) {
+        return -1;
+    }
+
+    stream_source_t& state = mux.sources[tag.source];
+    if (state.in_flight == 0) {
+        return -1;
+    }
+
+    state.in_flight--;
+    state.completed++;
+    return 0;
+}
+
+bool stream_mux_idle(const stream_mux_t& mux)
+{
+    for (int i = 0; i < mux.num_sources; i++) {
+        if (mux.sources[i].queued > 0 || mux.sources[i].in_flight > 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file stream_mux.h
+ * @date Sunday, October 25, 2026 at 10:12:40 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the stream multiplexer, which shares a
+ * single detector between the frames of several cameras.
+ *
+ * Each camera is a source, which pushes its frames into the multiplexer as
+ * they are captured. The detector pops frames from the multiplexer, which
+ * takes them round-robin from the sources with frames queued, so every camera
+ * gets its turn on the detector, regardless of how fast the others are. Each
+ * frame is tagged with its source and its frame number within the source,
+ * which identify the list of boxes the detector produces for it.
+ *
+ * Each source has a fixed number of credits, and a frame holds one of its
+ * source's credits from when it is pushed until the detector completes it.
+ * When a source has no credits left, pushing fails, and the camera has to
+ * hold or drop its frame. This is the per-source backpressure: a camera that
+ * is faster than its share of the detector backs up on its own credits,
+ * rather than filling the detector's queue and starving the other cameras.
+ *
+ * The multiplexer does no allocation or locking, and only passes frames
+ * around as opaque pointers, so it can be used both by the Zynq application
+ * (with the hardware detector) and by the host detector. It is not thread-safe,
+ * so threaded cameras must push through a single thread, or hold a lock.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef STREAM_MUX_H_
+#define STREAM_MUX_H_
+
+#include <stdint.h>             // Fixed-size integer types
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The maximum number of sources, and the maximum credits for each source.
+ **/
+static const int STREAM_MUX_MAX_SOURCES = 8;
+static const int STREAM_MUX_MAX_CREDITS = 8;
+
+/**
+ * The tag identifying a frame, and the list of boxes detected for it.
+ **/
+typedef struct stream_tag {
+    int source;                         // The source the frame came from
+    uint32_t frame;                     // The frame's number in its source
+} stream_tag_t;
+
+/**
+ * The state of a single source. The queue holds the frames that have been
+ * pushed, but not yet popped by the detector.
+ **/
+typedef struct stream_source {
+    void *queue[STREAM_MUX_MAX_CREDITS]; // Frames waiting for the detector
+    uint32_t frames[STREAM_MUX_MAX_CREDITS]; // Numbers of the queued frames
+    int head;                           // Index of the oldest queued frame
+    int queued;                         // Number of frames in the queue
+    int in_flight;                      // Frames popped, but not completed
+    uint32_t next_frame;                // Number of the next frame pushed
+    uint64_t completed;                 // Frames completed by the detector
+    uint64_t rejected;                  // Pushes that failed for no credits
+} stream_source_t;
+
+/**
+ * The state of the multiplexer.
+ **/
+typedef struct stream_mux {
+    int num_sources;                    // The number of sources
+    int credits;                        // The credits of each source
+    int next_source;                    // Where the round-robin scan starts
+    stream_source_t sources[STREAM_MUX_MAX_SOURCES]; // The sources
+} stream_mux_t;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Initializes the multiplexer, with no frames queued.
+ *
+ * @param[out] mux The multiplexer to initialize.
+ * @param num_sources The number of sources, up to STREAM_MUX_MAX_SOURCES.
+ * @param credits The number of frames each source can have queued or in
+ *        flight at once, up to STREAM_MUX_MAX_CREDITS.
+ * @return 0 on success, -1 if either count is out of range.
+ **/
+int stream_mux_init(stream_mux_t& mux, int num_sources, int credits);
+
+/**
+ * Returns true if the source has a credit left, so a push would succeed, and
+ * false if it has none, or is not one of the multiplexer's sources.
+ **/
+bool stream_mux_can_push(const stream_mux_t& mux, int source);
+
+/**
+ * Queues a frame from a source for the detector, numbering it after the
+ * source's last frame. Rejected frames are counted, but not numbered.
+ *
+ * @param mux The multiplexer.
+ * @param source The source the frame came from.
+ * @param frame The frame, which is returned by stream_mux_pop().
+ * @param[out] tag The tag of the frame, if it was queued.
+ * @return 0 on success, -1 if the source has no credits left, or is not one
+ *         of the multiplexer's sources.
+ **/
+int stream_mux_push(stream_mux_t& mux, int source, void *frame,
+        stream_tag_t& tag);
+
+/**
+ * Takes the next frame for the detector. The sources are scanned round-robin,
+ * starting after the source of the last frame popped, and the oldest frame
+ * of the first source with one queued is returned.
+ *
+ * @param mux The multiplexer.
+ * @param[out] tag The tag of the frame, if one was queued.
+ * @return The frame, or NULL if no frames are queued.
+ **/
+void *stream_mux_pop(stream_mux_t& mux, stream_tag_t& tag);
+
+/**
+ * Marks a frame from stream_mux_pop() as completed, returning its credit to
+ * its source. Frames may complete in any order.
+ *
+ * @param mux The multiplexer.
+ * @param tag The tag of the completed frame.
+ * @return 0 on success, -1 if the source has no frames in flight, or is not
+ *         one of the multiplexer's sources.
+ **/
+int stream_mux_complete(stream_mux_t& mux, const stream_tag_t& tag);
+
+/**
+ * Returns true if no frames are queued or in flight from any source.
+ **/
+bool stream_mux_idle(const stream_mux_t& mux);
+
+#endif /* STREAM_MUX_H_ */
@@ -0,0 +1,120 @@
+/**
+ * @file stream_mux_test.cpp
+ * @date Sunday, October 25, 2026 at 11:41:52 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for the stream multiplexer.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+
+#include "stream_mux.h"             // Stream multiplexer
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The number of sources, and the credits of each source
+static const int TEST_SOURCES       = 3;
+static const int TEST_CREDITS       = 2;
+
+// The number of frames the detector runs in the simulated stream
+static const int TEST_FRAMES        = 300;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+int main()
+{
+    stream_mux_t mux;
+    assert(stream_mux_init(mux, 0, 1) == -1);
+    assert(stream_mux_init(mux, 1, STREAM_MUX_MAX_CREDITS + 1) == -1);
+    assert(stream_mux_init(mux, TEST_SOURCES, TEST_CREDITS) == 0);
+    assert(stream_mux_idle(mux));
+
+    // Frames are numbered per source, and rejected once the credits run out
+    int frames[TEST_SOURCES][TEST_CREDITS];
+    stream_tag_t tag;
+    assert(stream_mux_push(mux, 0, &frames[0][0], tag) == 0);
+    assert(tag.source == 0 && tag.frame == 0);
+    assert(stream_mux_push(mux, 0, &frames[0][1], tag) == 0);
+    assert(tag.source == 0 && tag.frame == 1);
+    assert(!stream_mux_can_push(mux, 0));
+    assert(stream_mux_push(mux, 0, &frames[0][0], tag) == -1);
+    assert(mux.sources[0].rejected == 1);
+    assert(stream_mux_push(mux, 2, &frames[2][0], tag) == 0);
+    assert(tag.source == 2 && tag.frame == 0);
+
+    // The sources take turns, even though source 0 queued first
+    assert(stream_mux_pop(mux, tag) == &frames[0][0] && tag.frame == 0);
+    assert(stream_mux_pop(mux, tag) == &frames[2][0] && tag.source == 2);
+    assert(stream_mux_pop(mux, tag) == &frames[0][1] && tag.frame == 1);
+    assert(stream_mux_pop(mux, tag) == NULL);
+
+    // Credits only come back when frames complete, in any order
+    assert(!stream_mux_can_push(mux, 0));
+    stream_tag_t done = {0, 1};
+    assert(stream_mux_complete(mux, done) == 0);
+    assert(stream_mux_can_push(mux, 0));
+    assert(stream_mux_complete(mux, done) == 0);
+    assert(stream_mux_complete(mux, done) == -1);
+    done.source = 2;
+    assert(stream_mux_complete(mux, done) == 0);
+    assert(stream_mux_idle(mux));
+
+    // Sources out of range are rejected, without touching any source
+    assert(!stream_mux_can_push(mux, -1));
+    assert(!stream_mux_can_push(mux, TEST_SOURCES));
+    assert(stream_mux_push(mux, TEST_SOURCES, &frames[0][0], tag) == -1);
+    assert(stream_mux_push(mux, -1, &frames[0][0], tag) == -1);
+    done.source = STREAM_MUX_MAX_SOURCES;
+    assert(stream_mux_complete(mux, done) == -1);
+    assert(mux.sources[0].rejected == 1 && stream_mux_idle(mux));
+
+    /* Simulate a fast camera that always has a frame ready, and two slower
+     * ones, sharing a detector with room for four frames in flight. The slow
+     * cameras still get a share of the detector, and the fast one backs up
+     * on its own credits. */
+    assert(stream_mux_init(mux, TEST_SOURCES, TEST_CREDITS) == 0);
+    stream_tag_t in_flight[4];
+    int num_in_flight = 0;
+    uint32_t last_frame[TEST_SOURCES] = {0, 0, 0};
+    for (int t = 0; t < TEST_FRAMES; t++) {
+        for (int source = 0; source < TEST_SOURCES; source++) {
+            if (source == 0 || t % (2 * source + 2) == 0) {
+                stream_mux_push(mux, source, &frames[source][0], tag);
+            }
+        }
+
+        // Fill the detector, then complete its oldest frame
+        while (num_in_flight < 4 &&
+                stream_mux_pop(mux, in_flight[num_in_flight]) != NULL) {
+            const stream_tag_t& popped = in_flight[num_in_flight++];
+            assert(popped.frame == 0 || popped.frame ==
+                    last_frame[popped.source] + 1);
+            last_frame[popped.source] = popped.frame;
+        }
+        assert(num_in_flight > 0);
+        assert(stream_mux_complete(mux, in_flight[0]) == 0);
+        for (int i = 1; i < num_in_flight; i++) {
+            in_flight[i-1] = in_flight[i];
+        }
+        num_in_flight--;
+    }
+
+    // The slow cameras never lost a frame, and the fast one got the rest
+    const stream_source_t *sources = mux.sources;
+    assert(sources[1].rejected == 0 && sources[2].rejected == 0);
+    assert(sources[1].completed >= TEST_FRAMES / 4 - 2);
+    assert(sources[2].completed >= TEST_FRAMES / 6 - 2);
+    assert(sources[0].rejected > 0);
+    assert(sources[0].completed + sources[1].completed + sources[2].completed
+            == TEST_FRAMES);
+
+    printf("Stream multiplexer test passed.\n");
+    return 0;
+}
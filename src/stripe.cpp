@@ -0,0 +1,106 @@
+/**
+ * @file stripe.cpp
+ * @date Friday, October 30, 2026 at 11:02:37 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of splitting frames into vertical
+ * stripes.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstring>                  // Memory copy function
+
+#include <algorithm>                // Min, max, and sort functions
+
+#include "stripe.h"                 // Our interface
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Returns true if the box comes before the other in the canonical order
+static bool bbox_before(const bbox_t& a, const bbox_t& b)
+{
+    int a_size = a.x2 - a.x1;
+    int b_size = b.x2 - b.x1;
+    if (a_size != b_size) {
+        return a_size < b_size;
+    } else if (a.y1 + a.y2 != b.y1 + b.y2) {
+        return a.y1 + a.y2 < b.y1 + b.y2;
+    }
+    return a.x1 + a.x2 < b.x1 + b.x2;
+}
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+int stripe_split(int frame_width, int stripe_width,
+        std::vector<stripe_t>& stripes)
+{
+    if (frame_width <= 0 || frame_width % STRIPE_ALIGN != 0) {
+        log_err("Frame width %d is not a multiple of %d.\n", frame_width,
+                STRIPE_ALIGN);
+        return -1;
+    } else if (stripe_width <= 0 || stripe_width % STRIPE_ALIGN != 0) {
+        log_err("Stripe width %d is not a multiple of %d.\n", stripe_width,
+                STRIPE_ALIGN);
+        return -1;
+    }
+
+    stripes.clear();
+    int width = stripe_width + 2 * STRIPE_HALO;
+    if (frame_width <= width) {
+        stripe_t stripe = {0, frame_width, 0, frame_width};
+        stripes.push_back(stripe);
+        return frame_width;
+    }
+
+    // The hardware places its ROI mask the same way (see stripe_halo.h)
+    for (int i = 0; i * stripe_width < frame_width; i++) {
+        int keep_x0 = i * stripe_width;
+        int keep_x1 = std::min(keep_x0 + stripe_width, frame_width);
+        int x0 = stripe_origin(frame_width, stripe_width, i);
+        stripe_t stripe = {x0, width, keep_x0, keep_x1};
+        stripes.push_back(stripe);
+    }
+
+    return width;
+}
+
+void stripe_copy(const void *frame, int frame_width, int height,
+        size_t pixel_size, const stripe_t& stripe, void *image)
+{
+    const uint8_t *frame_row = static_cast<const uint8_t *>(frame) +
+            stripe.x0 * pixel_size;
+    uint8_t *image_row = static_cast<uint8_t *>(image);
+    size_t row_size = stripe.width * pixel_size;
+    for (int y = 0; y < height; y++) {
+        memcpy(image_row, frame_row, row_size);
+        frame_row += frame_width * pixel_size;
+        image_row += row_size;
+    }
+}
+
+int stripe_stitch(const stripe_t& stripe, const bbox_t *stripe_bboxes,
+        int num_stripe_bboxes, bbox_t *bboxes, int max_bboxes)
+{
+    int num_bboxes = 0;
+    for (int i = 0; i < num_stripe_bboxes && num_bboxes < max_bboxes; i++) {
+        const bbox_t& bbox = stripe_bboxes[i];
+        int cx = stripe.x0 + (bbox.x1 + bbox.x2) / 2;
+        if (cx >= stripe.keep_x0 && cx < stripe.keep_x1) {
+            bboxes[num_bboxes++] = bbox_t(stripe.x0 + bbox.x1, bbox.y1,
+                    stripe.x0 + bbox.x2, bbox.y2);
+        }
+    }
+
+    return num_bboxes;
+}
+
+void stripe_sort(bbox_t *bboxes, int num_bboxes)
+{
+    std::stable_sort(bboxes, bboxes + num_bboxes, bbox_before);
+}
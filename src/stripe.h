@@ -0,0 +1,105 @@
+/**
+ * @file stripe.h
+ * @date Friday, October 30, 2026 at 10:14:52 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to splitting frames into vertical stripes.
+ *
+ * The line buffers of the detector's pipeline hold whole rows, so their size
+ * grows with the width of the frame. To bound them, a wide frame can be split
+ * into stripes of columns, and each stripe run through a detector built for
+ * the stripe's width, as if it were a frame of its own.
+ *
+ * Each stripe keeps the boxes centered in its own columns, and is widened by a
+ * halo on either side, so every window the filter sees around those centers,
+ * at every scale level, is the same as in the whole frame. The stripes start
+ * on the blocks of the coarsest level, so the pyramid is downscaled the same
+ * way, and the stitched boxes are exactly those found in the whole frame. The
+ * stripes are all the same width, so the last one is moved left to fit in the
+ * frame, and overlaps its neighbor by more than the halo.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef STRIPE_H_
+#define STRIPE_H_
+
+#include <stddef.h>             // Definition of size_t
+
+#include <vector>               // Vector container
+
+#include "bbox.h"               // Definition of a bounding box
+#include "stripe_halo.h"        // Stripe alignment and halo
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * A stripe of the frame. The columns [x0, x0 + width) are run through the
+ * detector, and the boxes centered in [keep_x0, keep_x1) are kept.
+ **/
+typedef struct stripe {
+    int x0;                     // The first column of the stripe
+    int width;                  // The number of columns, with the halos
+    int keep_x0;                // The first column whose boxes are kept
+    int keep_x1;                // One past the last column whose boxes are kept
+} stripe_t;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Splits a frame into stripes that each keep the boxes of up to stripe_width
+ * columns, widened by the halos. A frame no wider than a stripe with its halos
+ * is a single stripe covering the whole frame.
+ *
+ * @param frame_width The width of the frame.
+ * @param stripe_width The number of columns whose boxes each stripe keeps.
+ * @param[out] stripes The stripes, from left to right.
+ * @return The width of every stripe, with the halos, or -1 if either width
+ *         is not a positive multiple of STRIPE_ALIGN.
+ **/
+int stripe_split(int frame_width, int stripe_width,
+        std::vector<stripe_t>& stripes);
+
+/**
+ * Copies the columns of a stripe out of a frame, into an image of their own.
+ *
+ * @param[in] frame The pixels of the frame, in row-major order.
+ * @param frame_width The width of the frame.
+ * @param height The height of the frame.
+ * @param pixel_size The size of a pixel, in bytes.
+ * @param stripe The stripe to copy.
+ * @param[out] image The image to copy the stripe to, stripe.width wide.
+ **/
+void stripe_copy(const void *frame, int frame_width, int height,
+        size_t pixel_size, const stripe_t& stripe, void *image);
+
+/**
+ * Moves the boxes found in a stripe into the frame, and appends the ones
+ * centered in the stripe's columns to the frame's boxes. At most max_bboxes
+ * are appended.
+ *
+ * @param stripe The stripe the boxes were found in.
+ * @param[in] stripe_bboxes The boxes found in the stripe.
+ * @param num_stripe_bboxes The number of boxes found in the stripe.
+ * @param[out] bboxes The buffer to append the frame's boxes to.
+ * @param max_bboxes The number of boxes left in the buffer.
+ * @return The number of boxes appended.
+ **/
+int stripe_stitch(const stripe_t& stripe, const bbox_t *stripe_bboxes,
+        int num_stripe_bboxes, bbox_t *bboxes, int max_bboxes);
+
+/**
+ * Sorts the stitched boxes of a frame in a canonical order: by size, then in
+ * row-major order of their centers. This does not depend on how the frame was
+ * split, so lists from different stripe widths can be compared directly.
+ *
+ * @param bboxes The boxes of the frame.
+ * @param num_bboxes The number of boxes.
+ **/
+void stripe_sort(bbox_t *bboxes, int num_bboxes);
+
+#endif /* STRIPE_H_ */
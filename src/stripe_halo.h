@@ -0,0 +1,64 @@
+/**
+ * @file stripe_halo.h
+ * @date Sunday, November 01, 2026 at 11:02:17 AM EST
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the alignment, halo, and placement of the stripes a frame
+ * is split into (see stripe.h).
+ *
+ * The processor splits the frames, and the hardware's line buffers are sized
+ * by the stripes, and its ROI mask is placed by them, so both must agree on
+ * where the stripes are. This file has no dependencies, so the hardware can
+ * include it as well, by adding the src directory to its include path.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef STRIPE_HALO_H_
+#define STRIPE_HALO_H_
+
+/**
+ * The alignment of the stripes, in full-resolution pixels, which is a pixel at
+ * the coarsest of the 5 scale levels. Stripe and frame widths must be
+ * multiples of it.
+ **/
+static const int STRIPE_ALIGN           = 16;
+
+/**
+ * The number of pixels the blob filter reaches to either side of its center,
+ * at each scale level. This is the 5x5 LoG filter's. The hardware's filter
+ * bank reaches further, and can't be built with stripes.
+ **/
+static const int STRIPE_FILTER_REACH    = 2;
+
+/**
+ * The halo on either side of a stripe, in full-resolution pixels. This is the
+ * filter's reach at the coarsest level, plus one more pixel there for the
+ * Bayer demosaic, which reads the sample to the right of each pixel.
+ **/
+static const int STRIPE_HALO            = (STRIPE_FILTER_REACH + 1) *
+        STRIPE_ALIGN;
+
+/**
+ * Returns the first column of a stripe in the frame. Each stripe is centered
+ * on the stripe_width columns whose boxes it keeps, unless that runs off the
+ * edge of the frame, where there is nothing for a halo to hold.
+ *
+ * @param frame_width The width of the frame, wider than a stripe with halos.
+ * @param stripe_width The number of columns whose boxes each stripe keeps.
+ * @param index The index of the stripe, from the left.
+ * @return The first column of the stripe, with its halo.
+ **/
+static inline int stripe_origin(int frame_width, int stripe_width, int index)
+{
+    int width = stripe_width + 2 * STRIPE_HALO;
+    int x0 = index * stripe_width - STRIPE_HALO;
+    if (x0 < 0) {
+        return 0;
+    } else if (x0 > frame_width - width) {
+        return frame_width - width;
+    }
+    return x0;
+}
+
+#endif /* STRIPE_HALO_H_ */
@@ -0,0 +1,173 @@
+/**
+ * @file stripe_test.cpp
+ * @date Friday, October 30, 2026 at 02:31:09 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for splitting frames into vertical stripes.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+#include <cstdlib>                  // Random number generator
+
+#include <algorithm>                // Min and max functions
+#include <vector>                   // Vector container
+
+#include "stripe.h"                 // Frame striping interface
+#include "host_detector.h"          // Host detector interface
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The size of the test frame, and of the stripes it is split into
+static const int TEST_WIDTH     = 960;
+static const int TEST_HEIGHT    = 384;
+static const int TEST_STRIPE    = 64;
+
+/* The size of the cells the blobs are drawn in, in pixels at their scale
+ * level, the number of rows of cells in each level's band, and the largest
+ * scale factor. */
+static const int BLOB_CELL      = 6;
+static const int BAND_CELLS     = 2;
+static const int MAX_SCALE      = 16;
+
+// The most boxes found in the frame
+static const int MAX_BBOXES     = 4096;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+/* Draws bright square blobs on a dim frame, in bands of rows for each scale
+ * level. Each band has a grid of cells, with a blob two or three pixels wide
+ * at its level drawn at a random offset in each cell, so there are blobs at
+ * every level straddling the edges of the stripes. */
+static void draw_blobs(std::vector<uint8_t>& luma)
+{
+    srand(49);
+    for (size_t i = 0; i < luma.size(); i++) {
+        luma[i] = rand() % 160;
+    }
+
+    int band_y0 = 0;
+    for (int scale = 1; scale <= MAX_SCALE; scale *= 2) {
+        int cell = BLOB_CELL * scale;
+        for (int y0 = band_y0; y0 < band_y0 + BAND_CELLS * cell; y0 += cell) {
+            for (int x0 = 0; x0 + cell <= TEST_WIDTH; x0 += cell) {
+                int size = scale * (2 + rand() % 2);
+                int bx = x0 + rand() % (cell - size);
+                int by = y0 + rand() % (cell - size);
+                uint8_t value = 240 + rand() % 16;
+                for (int y = by; y < by + size; y++) {
+                    for (int x = bx; x < bx + size; x++) {
+                        luma[y * TEST_WIDTH + x] = value;
+                    }
+                }
+            }
+        }
+        band_y0 += BAND_CELLS * cell;
+    }
+}
+
+/* Runs the detector on each stripe of the frame, and checks that the stitched
+ * boxes are the same as those found in the whole frame, with both sorted. */
+static void check_stripes(input_format_t format, const void *frame,
+        size_t pixel_size)
+{
+    host_detector_t detector;
+    assert(host_detector_init(detector, TEST_WIDTH, TEST_HEIGHT) == 0);
+    host_detector_set_format(detector, format);
+    std::vector<bbox_t> expected(MAX_BBOXES);
+    int num_expected = host_detect_blobs(detector, frame, expected.data(),
+            MAX_BBOXES);
+    assert(num_expected > 0 && num_expected < MAX_BBOXES);
+    stripe_sort(expected.data(), num_expected);
+
+    std::vector<stripe_t> stripes;
+    int width = stripe_split(TEST_WIDTH, TEST_STRIPE, stripes);
+    assert(width == TEST_STRIPE + 2 * STRIPE_HALO);
+    assert(host_detector_init(detector, width, TEST_HEIGHT) == 0);
+    host_detector_set_format(detector, format);
+
+    std::vector<uint8_t> image(width * TEST_HEIGHT * pixel_size);
+    std::vector<bbox_t> stripe_bboxes(MAX_BBOXES);
+    std::vector<bbox_t> bboxes(MAX_BBOXES);
+    int num_bboxes = 0;
+    for (size_t i = 0; i < stripes.size(); i++) {
+        stripe_copy(frame, TEST_WIDTH, TEST_HEIGHT, pixel_size, stripes[i],
+                image.data());
+        int num_stripe_bboxes = host_detect_blobs(detector, image.data(),
+                stripe_bboxes.data(), MAX_BBOXES);
+        num_bboxes += stripe_stitch(stripes[i], stripe_bboxes.data(),
+                num_stripe_bboxes, &bboxes[num_bboxes],
+                MAX_BBOXES - num_bboxes);
+    }
+    stripe_sort(bboxes.data(), num_bboxes);
+    host_detector_destroy(detector);
+
+    assert(num_bboxes == num_expected);
+    for (int i = 0; i < num_bboxes; i++) {
+        assert(bboxes[i].x1 == expected[i].x1 && bboxes[i].y1 ==
+                expected[i].y1);
+        assert(bboxes[i].x2 == expected[i].x2 && bboxes[i].y2 ==
+                expected[i].y2);
+    }
+}
+
+int main()
+{
+    // Invalid widths are rejected, and a narrow frame is a single stripe
+    std::vector<stripe_t> stripes;
+    assert(stripe_split(TEST_WIDTH, 0, stripes) == -1);
+    assert(stripe_split(TEST_WIDTH, TEST_STRIPE + 8, stripes) == -1);
+    assert(stripe_split(TEST_WIDTH + 8, TEST_STRIPE, stripes) == -1);
+    assert(stripe_split(TEST_WIDTH, TEST_WIDTH, stripes) == TEST_WIDTH);
+    assert(stripes.size() == 1 && stripes[0].x0 == 0);
+    assert(stripes[0].keep_x0 == 0 && stripes[0].keep_x1 == TEST_WIDTH);
+
+    /* The stripes keep every column once, are aligned, fit in the frame, and
+     * have a full halo wherever they are not at the frame's edge. */
+    int width = stripe_split(TEST_WIDTH, 3 * STRIPE_ALIGN, stripes);
+    assert(width == 3 * STRIPE_ALIGN + 2 * STRIPE_HALO);
+    int keep_x0 = 0;
+    for (size_t i = 0; i < stripes.size(); i++) {
+        const stripe_t& stripe = stripes[i];
+        assert(stripe.width == width && stripe.x0 % STRIPE_ALIGN == 0);
+        assert(stripe.x0 >= 0 && stripe.x0 + width <= TEST_WIDTH);
+        assert(stripe.keep_x0 == keep_x0 && stripe.keep_x1 > keep_x0);
+        assert(stripe.x0 == 0 || stripe.keep_x0 - stripe.x0 >= STRIPE_HALO);
+        assert(stripe.x0 + width == TEST_WIDTH ||
+                stripe.x0 + width - stripe.keep_x1 >= STRIPE_HALO);
+        keep_x0 = stripe.keep_x1;
+    }
+    assert(keep_x0 == TEST_WIDTH);
+
+    // Only the boxes centered in the stripe's columns are kept, and moved
+    const stripe_t stripe = {64, 160, 112, 176};
+    const bbox_t found[] = {
+        bbox_t(45, 7, 51, 13), bbox_t(-3, 0, 3, 6), bbox_t(109, 0, 115, 6),
+        bbox_t(90, 20, 114, 44),
+    };
+    bbox_t kept[4];
+    assert(stripe_stitch(stripe, found, 4, kept, 4) == 2);
+    assert(kept[0].x1 == 109 && kept[0].x2 == 115 && kept[0].y1 == 7);
+    assert(kept[1].x1 == 154 && kept[1].x2 == 178 && kept[1].y2 == 44);
+    assert(stripe_stitch(stripe, found, 4, kept, 1) == 1);
+
+    // The stitched stripes find the same blobs as the whole frame
+    std::vector<uint8_t> luma(TEST_WIDTH * TEST_HEIGHT);
+    draw_blobs(luma);
+    std::vector<pixel_t> rgba(luma.size());
+    for (size_t i = 0; i < luma.size(); i++) {
+        rgba[i] = pixel_t(luma[i], luma[i], luma[i], 255);
+    }
+    check_stripes(INPUT_RGBA, rgba.data(), sizeof(pixel_t));
+    check_stripes(INPUT_LUMA, luma.data(), 1);
+    check_stripes(INPUT_BAYER_RGGB, luma.data(), 1);
+
+    printf("Stripe test passed.\n");
+    return 0;
+}
@@ -0,0 +1,300 @@
+/**
+ * @file trace.cpp
+ * @date Thursday, October 22, 2026 at 02:51:09 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of the latency tracer.
+ *
+ * Each thread's buffer is pushed onto a global list the first time the thread
+ * records an event, with a compare-and-swap, and is never freed. Only the
+ * owning thread appends to a buffer, so recording needs no locks, and the
+ * buffers are only read once the recording threads have stopped.
+ *
+ * The host detector's threads run for many frames, so the buffers grow as
+ * events are recorded rather than being allocated up front. A detector that is
+ * initialized again starts new threads, so threads with the same name share an
+ * ID, so that they appear as one row in the viewer.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cstdio>                   // C standard I/O library
+#include <cstring>                  // String comparison
+
+#include <algorithm>                // Min function
+#include <atomic>                   // Atomic types and memory ordering
+#include <vector>                   // Vector container
+
+#ifdef TRACE_XTIME
+#include <xtime_l.h>                // Global timer of the Zynq
+#else
+#include <chrono>                   // Steady clock
+#include <mutex>                    // Mutex and lock guard
+#endif /* TRACE_XTIME */
+
+#include "trace.h"                  // Our interface
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The number of nanoseconds in a second, and in a microsecond
+static const uint64_t NS_PER_SEC    = 1000000000;
+static const uint64_t NS_PER_US     = 1000;
+
+// The maximum length of a single event in the JSON output
+static const size_t MAX_EVENT_LEN   = 256;
+
+// A single event recorded by a thread
+typedef struct trace_record {
+    const char *name;                   // The name of the event
+    int arg;                            // The event's argument, or -1
+    uint64_t begin_ns;                  // When the event began
+    uint64_t end_ns;                    // When the event ended
+} trace_record_t;
+
+// The buffer of events recorded by a single thread
+typedef struct trace_buffer {
+    trace_buffer *next;                 // The next buffer in the global list
+    int tid;                            // The thread's ID in the trace
+    const char *thread_name;            // The thread's name, or NULL
+    int thread_index;                   // The index appended to the name
+    size_t dropped;                     // Number of events that didn't fit
+    std::vector<trace_record_t> records; // The events recorded by the thread
+} trace_buffer_t;
+
+// The state shared by all of the threads
+static std::atomic<bool> TRACE_ENABLED(false);
+static size_t TRACE_CAPACITY        = 0;
+static uint64_t TRACE_START_NS      = 0;
+static std::atomic<trace_buffer_t *> TRACE_BUFFERS(NULL);
+static std::atomic<int> TRACE_NEXT_TID(1);
+
+/* Protects the names of the threads, which are set while others are running.
+ * The Zynq application is single-threaded, so it doesn't need the lock. */
+#ifndef TRACE_XTIME
+static std::mutex TRACE_NAME_LOCK;
+#endif /* TRACE_XTIME */
+
+// The buffer of the calling thread, allocated when it first records an event
+static thread_local trace_buffer_t *THREAD_BUFFER = NULL;
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Returns the calling thread's buffer, allocating it if necessary
+static trace_buffer_t *thread_buffer()
+{
+    if (THREAD_BUFFER != NULL) {
+        return THREAD_BUFFER;
+    }
+
+    trace_buffer_t *buffer = new trace_buffer_t();
+    buffer->tid = TRACE_NEXT_TID.fetch_add(1, std::memory_order_relaxed);
+    buffer->thread_name = NULL;
+    buffer->thread_index = -1;
+    buffer->dropped = 0;
+
+    // Allocate every record up front, so recording never calls the allocator
+    buffer->records.reserve(TRACE_CAPACITY);
+
+    // Push the buffer onto the global list
+    buffer->next = TRACE_BUFFERS.load(std::memory_order_relaxed);
+    while (!TRACE_BUFFERS.compare_exchange_weak(buffer->next, buffer,
+                std::memory_order_release, std::memory_order_relaxed)) {
+    }
+
+    THREAD_BUFFER = buffer;
+    return buffer;
+}
+
+// Formats a time in nanoseconds as microseconds
+static int format_us(char *text, size_t size, uint64_t ns)
+{
+    return snprintf(text, size, "%llu.%03llu",
+            (unsigned long long)(ns / NS_PER_US),
+            (unsigned long long)(ns % NS_PER_US));
+}
+
+// Writes out a single event of a thread as a complete ("X") event
+static int write_record(const trace_buffer_t *buffer,
+        const trace_record_t& record, bool first, trace_write_t write,
+        void *arg)
+{
+    // Timestamps are relative to the start of the trace
+    char ts[32], dur[32], args[32] = "";
+    uint64_t begin_ns = record.begin_ns - std::min(record.begin_ns,
+            TRACE_START_NS);
+    format_us(ts, sizeof(ts), begin_ns);
+    format_us(dur, sizeof(dur), record.end_ns - record.begin_ns);
+    if (record.arg >= 0) {
+        snprintf(args, sizeof(args), ",\"args\":{\"arg\":%d}", record.arg);
+    }
+
+    char event[MAX_EVENT_LEN];
+    int len = snprintf(event, sizeof(event), "%s\n{\"name\":\"%s\","
+            "\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%s,\"dur\":%s%s}",
+            first ? "" : ",", record.name, buffer->tid, ts, dur, args);
+    return write(event, len, arg);
+}
+
+// Writes out the metadata ("M") event naming a thread
+static int write_thread_name(const trace_buffer_t *buffer, bool first,
+        trace_write_t write, void *arg)
+{
+    char name[64];
+    if (buffer->thread_name == NULL) {
+        snprintf(name, sizeof(name), "thread %d", buffer->tid);
+    } else if (buffer->thread_index < 0) {
+        snprintf(name, sizeof(name), "%s", buffer->thread_name);
+    } else {
+        snprintf(name, sizeof(name), "%s %d", buffer->thread_name,
+                buffer->thread_index);
+    }
+
+    char event[MAX_EVENT_LEN];
+    int len = snprintf(event, sizeof(event), "%s\n{\"name\":\"thread_name\","
+            "\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\","
+            "\"dropped_events\":%zu}}", first ? "" : ",", buffer->tid, name,
+            buffer->dropped);
+    return write(event, len, arg);
+}
+
+// Writes the JSON text to a file, for trace_save()
+static int write_file(const char *data, size_t size, void *arg)
+{
+    FILE *file = (FILE *)arg;
+    return (fwrite(data, 1, size, file) == size) ? 0 : -1;
+}
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+trace_scope::trace_scope(const char *name, int arg) : name(name), arg(arg)
+{
+    begin_ns = TRACE_ENABLED.load(std::memory_order_relaxed) ? trace_now() :
+            0;
+}
+
+trace_scope::~trace_scope()
+{
+    if (begin_ns != 0) {
+        trace_event(name, begin_ns, trace_now(), arg);
+    }
+}
+
+void trace_init(size_t events_per_thread)
+{
+    TRACE_CAPACITY = events_per_thread;
+    TRACE_START_NS = trace_now();
+    TRACE_ENABLED.store(true, std::memory_order_release);
+}
+
+uint64_t trace_now()
+{
+#ifdef TRACE_XTIME
+    // Convert in two parts, so the counts don't overflow when scaled
+    XTime counts;
+    XTime_GetTime(&counts);
+    return (counts / COUNTS_PER_SECOND) * NS_PER_SEC +
+            (counts % COUNTS_PER_SECOND) * NS_PER_SEC / COUNTS_PER_SECOND;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif /* TRACE_XTIME */
+}
+
+void trace_event(const char *name, uint64_t begin_ns, uint64_t end_ns,
+        int arg)
+{
+    // Pairs with trace_init(), so the capacity and start time are visible
+    if (!TRACE_ENABLED.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    trace_buffer_t *buffer = thread_buffer();
+    if (buffer->records.size() == TRACE_CAPACITY) {
+        buffer->dropped += 1;
+        return;
+    }
+
+    trace_record_t record = {name, arg, begin_ns, end_ns};
+    buffer->records.push_back(record);
+}
+
+void trace_thread_name(const char *name, int index)
+{
+    if (!TRACE_ENABLED.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // Reuse the ID of an earlier thread with the same name and index
+    trace_buffer_t *buffer = thread_buffer();
+#ifndef TRACE_XTIME
+    std::lock_guard<std::mutex> guard(TRACE_NAME_LOCK);
+#endif /* TRACE_XTIME */
+    trace_buffer_t *other = TRACE_BUFFERS.load(std::memory_order_acquire);
+    for (; other != NULL; other = other->next) {
+        if (other != buffer && other->thread_name != NULL &&
+                strcmp(other->thread_name, name) == 0 &&
+                other->thread_index == index) {
+            buffer->tid = other->tid;
+            break;
+        }
+    }
+
+    buffer->thread_name = name;
+    buffer->thread_index = index;
+}
+
+int trace_write_json(trace_write_t write, void *arg)
+{
+    const char header[] = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    const char footer[] = "\n]}\n";
+    if (write(header, sizeof(header) - 1, arg) != 0) {
+        return -1;
+    }
+
+    bool first = true;
+    trace_buffer_t *buffer = TRACE_BUFFERS.load(std::memory_order_acquire);
+    for (; buffer != NULL; buffer = buffer->next) {
+        if (write_thread_name(buffer, first, write, arg) != 0) {
+            return -1;
+        }
+        first = false;
+
+        for (size_t i = 0; i < buffer->records.size(); i++) {
+            if (write_record(buffer, buffer->records[i], false, write,
+                        arg) != 0) {
+                return -1;
+            }
+        }
+    }
+
+    return write(footer, sizeof(footer) - 1, arg);
+}
+
+int trace_save(const char *path)
+{
+#ifdef TRACE_XTIME
+    log_err("%s: Traces must be saved with trace_write_json().\n", path);
+    return -1;
+#else
+    FILE *file = fopen(path, "w");
+    if (file == NULL) {
+        log_err("%s: Unable to open trace file for writing.\n", path);
+        return -1;
+    }
+
+    int rc = trace_write_json(write_file, file);
+    if (fclose(file) != 0 || rc != 0) {
+        log_err("%s: Unable to write trace file.\n", path);
+        return -1;
+    }
+
+    return 0;
+#endif /* TRACE_XTIME */
+}
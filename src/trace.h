@@ -0,0 +1,114 @@
+/**
+ * @file trace.h
+ * @date Thursday, October 22, 2026 at 02:07:31 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the latency tracer.
+ *
+ * The tracer records the begin and end timestamps of the steps of processing a
+ * frame, such as reading the image, the DMA transfers, or the stages of the
+ * host detector, and writes them out in the Chrome trace event format (JSON),
+ * which can be viewed in chrome://tracing or Perfetto.
+ *
+ * Each thread records its events into its own buffer, so recording an event
+ * never takes a lock. A thread's buffer is allocated the first time it records
+ * an event, and events are dropped once it reaches the capacity given to
+ * trace_init(). Tracing is disabled until trace_init() is called, and a
+ * disabled trace scope costs a single branch.
+ *
+ * Timestamps come from the standard steady clock, or from the Zynq's global
+ * timer (XTime_GetTime) when built with TRACE_XTIME defined.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <stddef.h>             // Definition of size_t
+#include <stdint.h>             // Fixed-size integer types
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The function used to write out the trace, which is called with successive
+ * pieces of the JSON text. It returns 0 on success, and -1 on failure.
+ **/
+typedef int (*trace_write_t)(const char *data, size_t size, void *arg);
+
+/**
+ * Records an event covering the lifetime of the scope, optionally tagged with
+ * an integer argument, such as the scale level. The name must be a string
+ * literal, or otherwise outlive the trace.
+ **/
+class trace_scope {
+public:
+    trace_scope(const char *name, int arg=-1);
+    ~trace_scope();
+
+private:
+    const char *name;                   // The name of the event
+    int arg;                            // The event's argument, or -1
+    uint64_t begin_ns;                  // When the scope began, or 0
+};
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Enables tracing, with the given number of events in each thread's buffer.
+ * This must be called before any other threads record events.
+ *
+ * @param events_per_thread The maximum number of events a thread can record.
+ **/
+void trace_init(size_t events_per_thread);
+
+/**
+ * Returns the current time of the trace clock, in nanoseconds.
+ **/
+uint64_t trace_now();
+
+/**
+ * Records an event on the calling thread, with the given begin and end times.
+ *
+ * @param name The name of the event, which must outlive the trace.
+ * @param begin_ns The time the event began, from trace_now().
+ * @param end_ns The time the event ended, from trace_now().
+ * @param arg An integer argument for the event, or -1 for none.
+ **/
+void trace_event(const char *name, uint64_t begin_ns, uint64_t end_ns,
+        int arg=-1);
+
+/**
+ * Names the calling thread in the trace, optionally with an index, such as
+ * the scale level the thread handles. Threads given the same name and index
+ * share a row in the trace, so this should be called once the thread's
+ * predecessor with that name has stopped.
+ *
+ * @param name The name of the thread, which must outlive the trace.
+ * @param index The index appended to the name, or -1 for none.
+ **/
+void trace_thread_name(const char *name, int index=-1);
+
+/**
+ * Writes out the events recorded by every thread as Chrome trace JSON. The
+ * threads that are recording events should be stopped first.
+ *
+ * @param write The function used to write out the JSON text.
+ * @param arg The argument passed through to the write function.
+ * @return 0 on success, -1 if the write function fails.
+ **/
+int trace_write_json(trace_write_t write, void *arg);
+
+/**
+ * Saves the trace as Chrome trace JSON to the given file. This is not
+ * available on the Zynq, where files are written with trace_write_json().
+ *
+ * @return 0 on success, -1 if the file cannot be written.
+ **/
+int trace_save(const char *path);
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,112 @@
+/**
+ * @file trace_test.cpp
+ * @date Thursday, October 22, 2026 at 03:40:26 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for the latency tracer.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cstdio>                   // C standard I/O library
+
+#include <string>                   // String class
+#include <thread>                   // Thread class
+
+#include "trace.h"                  // Latency tracer
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The number of events each thread can record
+static const size_t TEST_EVENTS     = 4;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+// Appends the JSON text to a string
+static int write_string(const char *data, size_t size, void *arg)
+{
+    std::string *text = (std::string *)arg;
+    text->append(data, size);
+    return 0;
+}
+
+// Fails the write, to check that errors are passed through
+static int write_fail(const char *data, size_t size, void *arg)
+{
+    (void)data;
+    (void)size;
+    (void)arg;
+    return -1;
+}
+
+// Records more events than fit in the thread's buffer
+static void worker(int index)
+{
+    trace_thread_name("worker", index);
+    for (size_t i = 0; i < TEST_EVENTS + 2; i++) {
+        trace_scope trace("work", i);
+    }
+}
+
+// Counts the number of occurrences of a substring in the text
+static int count(const std::string& text, const char *pattern)
+{
+    int matches = 0;
+    std::string::size_type pos = text.find(pattern);
+    for (; pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
+        matches += 1;
+    }
+    return matches;
+}
+
+int main()
+{
+    // Nothing is recorded before the tracer is enabled
+    {
+        trace_scope trace("disabled");
+    }
+
+    trace_init(TEST_EVENTS);
+    trace_thread_name("main");
+    uint64_t begin_ns = trace_now();
+    trace_event("explicit", begin_ns, begin_ns + 2500, 7);
+
+    // Run one worker at a time, so that the second shares the first's row
+    std::thread first(worker, 0);
+    first.join();
+    std::thread second(worker, 0);
+    second.join();
+    std::thread third(worker, 1);
+    third.join();
+
+    std::string text;
+    int rc = trace_write_json(write_string, &text);
+    assert(rc == 0);
+    assert(text.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+    assert(text.substr(text.size() - 4) == "\n]}\n");
+    assert(count(text, "\"disabled\"") == 0);
+    assert(count(text, "\"name\":\"explicit\"") == 1);
+    assert(count(text, "\"dur\":2.500,\"args\":{\"arg\":7}") == 1);
+
+    // Each worker drops the events past its buffer's capacity
+    assert(count(text, "\"name\":\"work\"") == 3 * TEST_EVENTS);
+    assert(count(text, "\"dropped_events\":2") == 3);
+    assert(count(text, "{\"name\":\"worker 0\"") == 2);
+    assert(count(text, "{\"name\":\"worker 1\"") == 1);
+    assert(count(text, "{\"name\":\"main\"") == 1);
+
+    // The two workers named "worker 0" share a thread ID, the other doesn't
+    assert(count(text, "\"tid\":2,") == 2 + 2 * TEST_EVENTS);
+    assert(count(text, "\"tid\":4,") == 1 + TEST_EVENTS);
+
+    rc = trace_write_json(write_fail, NULL);
+    assert(rc == -1);
+
+    printf("Trace test passed.\n");
+    return 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file tracker.cpp
+ * @date Wednesday, October 28, 2026 at 11:26:04 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the implementation of the blob tracker.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <algorithm>                // Min and max functions
+
+#include "tracker.h"                // Our interface
+#include "log.h"                    // Error and verbose logging macros
+
+/*----------------------------------------------------------------------------
+ * Helper Functions
+ *----------------------------------------------------------------------------*/
+
+// Returns the grid cell along one dimension of a point, clamped to the grid
+static int grid_cell(const blob_tracker_t& tracker, float coord, int cells)
+{
+    int cell = (coord < 0.0f) ? 0 : (int)coord / tracker.cell_size;
+    return std::min(cell, cells - 1);
+}
+
+// Returns the center of the box along x and y
+static float bbox_center_x(const bbox_t& bbox)
+{
+    return (bbox.x1 + bbox.x2) / 2.0f;
+}
+
+static float bbox_center_y(const bbox_t& bbox)
+{
+    return (bbox.y1 + bbox.y2) / 2.0f;
+}
+
+/* Returns the predicted center of the track in this frame, which has moved
+ * with its velocity for each frame since it was last seen. */
+static float predict_x(const track_t& track)
+{
+    return track.cx + track.vx * (track.misses + 1);
+}
+
+static float predict_y(const track_t& track)
+{
+    return track.cy + track.vy * (track.misses + 1);
+}
+
+/* Bins the predicted center of each track into the grid, chaining the tracks
+ * in each cell together, and marks every track as unclaimed. */
+static void bin_predictions(blob_tracker_t& tracker)
+{
+    int num_tracks = tracker.tracks.size();
+    std::fill(tracker.cells.begin(), tracker.cells.end(), -1);
+    tracker.next.resize(num_tracks);
+    tracker.claimed.assign(num_tracks, 0);
+    for (int i = 0; i < num_tracks; i++) {
+        const track_t& track = tracker.tracks[i];
+        int col = grid_cell(tracker, predict_x(track), tracker.grid_cols);
+        int row = grid_cell(tracker, predict_y(track), tracker.grid_rows);
+        int cell = row * tracker.grid_cols + col;
+        tracker.next[i] = tracker.cells[cell];
+        tracker.cells[cell] = i;
+    }
+}
+
+/* Finds the unclaimed track whose prediction is nearest to the point, within
+ * the maximum distance, or returns -1 if there is none. The cells are as large
+ * as the maximum distance, so only the point's cell and its neighbors are
+ * searched. */
+static int nearest_track(const blob_tracker_t& tracker, float x, float y)
+{
+    int col = grid_cell(tracker, x, tracker.grid_cols);
+    int row = grid_cell(tracker, y, tracker.grid_rows);
+    int row_end = std::min(row + 1, tracker.grid_rows - 1);
+    int col_end = std::min(col + 1, tracker.grid_cols - 1);
+
+    int nearest = -1;
+    float nearest_distance = (float)tracker.max_distance *
+            tracker.max_distance;
+    for (int r = std::max(row - 1, 0); r <= row_end; r++) {
+        for (int c = std::max(col - 1, 0); c <= col_end; c++) {
+            int i = tracker.cells[r * tracker.grid_cols + c];
+            for (; i >= 0; i = tracker.next[i]) {
+                const track_t& track = tracker.tracks[i];
+                float dx = predict_x(track) - x;
+                float dy = predict_y(track) - y;
+                float distance = dx * dx + dy * dy;
+                if (!tracker.claimed[i] && distance <= nearest_distance) {
+                    nearest = i;
+                    nearest_distance = distance;
+                }
+            }
+        }
+    }
+
+    return nearest;
+}
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+int blob_tracker_init(blob_tracker_t& tracker, int width, int height,
+        int max_distance)
+{
+    if (width <= 0 || height <= 0) {
+        log_err("Invalid tracker frame size %dx%d.\n", width, height);
+        return -1;
+    } else if (max_distance <= 0) {
+        log_err("Tracker distance %d must be positive.\n", max_distance);
+        return -1;
+    }
+
+    tracker.max_distance = max_distance;
+    tracker.cell_size = max_distance;
+    tracker.grid_cols = (width + max_distance - 1) / max_distance;
+    tracker.grid_rows = (height + max_distance - 1) / max_distance;
+    tracker.next_id = 1;
+    tracker.tracks.clear();
+    tracker.cells.assign(tracker.grid_rows * tracker.grid_cols, -1);
+    return 0;
+}
+
+int blob_tracker_update(blob_tracker_t& tracker, const bbox_t *bboxes,
+        int num_bboxes, tracked_bbox_t *tracked)
+{
+    bin_predictions(tracker);
+
+    // Associate each box with a track, or start a new one for it
+    int num_tracks = tracker.tracks.size();
+    int associated = 0;
+    for (int i = 0; i < num_bboxes; i++) {
+        float x = bbox_center_x(bboxes[i]);
+        float y = bbox_center_y(bboxes[i]);
+        int nearest = nearest_track(tracker, x, y);
+        if (nearest < 0) {
+            track_t track = {tracker.next_id++, bboxes[i], x, y, 0.0f, 0.0f,
+                    0};
+            nearest = tracker.tracks.size();
+            tracker.tracks.push_back(track);
+        } else {
+            /* The velocity moves toward the motion since the track was last
+             * seen, which is spread over the frames it missed. */
+            track_t& track = tracker.tracks[nearest];
+            float frames = track.misses + 1;
+            track.vx += TRACKER_VELOCITY_GAIN * ((x - track.cx) / frames -
+                    track.vx);
+            track.vy += TRACKER_VELOCITY_GAIN * ((y - track.cy) / frames -
+                    track.vy);
+            track.bbox = bboxes[i];
+            track.cx = x;
+            track.cy = y;
+            track.misses = 0;
+            tracker.claimed[nearest] = 1;
+            associated += 1;
+        }
+
+        const track_t& track = tracker.tracks[nearest];
+        tracked[i].bbox = bboxes[i];
+        tracked[i].id = track.id;
+        tracked[i].vx = track.vx;
+        tracked[i].vy = track.vy;
+    }
+
+    /* Tracks without a box keep coasting on their velocity, and are dropped
+     * once they have missed too many frames in a row. */
+    int live = 0;
+    for (int i = 0; i < (int)tracker.tracks.size(); i++) {
+        track_t& track = tracker.tracks[i];
+        if (i < num_tracks && !tracker.claimed[i]) {
+            track.misses += 1;
+            if (track.misses > TRACKER_MAX_MISSES) {
+                continue;
+            }
+        }
+        tracker.tracks[live++] = track;
+    }
+    tracker.tracks.resize(live);
+
+    return associated;
+}
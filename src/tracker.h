@@ -0,0 +1,126 @@
+/**
+ * @file tracker.h
+ * @date Wednesday, October 28, 2026 at 10:41:17 AM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the interface to the blob tracker.
+ *
+ * The tracker runs after the detector, and gives the boxes found in each frame
+ * persistent IDs. Each track predicts where its blob will be in the next frame
+ * from its velocity, and each box is associated with the nearest prediction
+ * within a maximum distance of its center. Boxes without a track start new
+ * tracks, and tracks without a box coast on their prediction for a few frames
+ * before they are dropped.
+ *
+ * The predictions are binned into a uniform grid with cells as large as the
+ * maximum distance, so each box only looks at the tracks in the 3x3 cells
+ * around it, and association takes linear time in the number of boxes, rather
+ * than comparing every box with every track.
+ *
+ * @bug No known bugs.
+ **/
+
+#ifndef TRACKER_H_
+#define TRACKER_H_
+
+#include <stdint.h>             // Fixed-size integer types
+
+#include <vector>               // Vector container
+
+#include "bbox.h"               // Definition of a bounding box
+
+/*----------------------------------------------------------------------------
+ * Definitions
+ *----------------------------------------------------------------------------*/
+
+/**
+ * The default maximum distance between a box's center and a track's predicted
+ * center for them to be associated, in full-resolution pixels.
+ **/
+static const int TRACKER_DEFAULT_MAX_DISTANCE   = 16;
+
+/**
+ * The number of frames in a row a track can go without a box before it is
+ * dropped.
+ **/
+static const int TRACKER_MAX_MISSES             = 3;
+
+/**
+ * The fraction of a track's velocity that is replaced by its latest motion in
+ * each frame it is associated with a box.
+ **/
+static const float TRACKER_VELOCITY_GAIN        = 0.5f;
+
+/**
+ * A box found in a frame, with the ID and velocity of the track it belongs to.
+ * The velocity is in full-resolution pixels per frame.
+ **/
+typedef struct tracked_bbox {
+    bbox_t bbox;                // The box found in the frame
+    uint32_t id;                // The ID of the box's track, starting at 1
+    float vx;                   // The track's velocity along x
+    float vy;                   // The track's velocity along y
+} tracked_bbox_t;
+
+/**
+ * A track, following a single blob across frames.
+ **/
+typedef struct track {
+    uint32_t id;                // The ID of the track
+    bbox_t bbox;                // The last box associated with the track
+    float cx, cy;               // The center of the blob in the last frame
+    float vx, vy;               // The velocity of the blob
+    int misses;                 // The number of frames since the last box
+} track_t;
+
+/**
+ * The tracker's state. The grid holds the tracks' predicted centers, with the
+ * tracks in each cell chained through the next array.
+ **/
+typedef struct blob_tracker {
+    int max_distance;           // The maximum distance for association
+    int cell_size;              // The size of a grid cell, in pixels
+    int grid_cols;              // The number of cells along the width
+    int grid_rows;              // The number of cells along the height
+    uint32_t next_id;           // The ID given to the next track
+
+    std::vector<track_t> tracks;    // The live tracks
+    std::vector<int> cells;         // The first track in each cell, or -1
+    std::vector<int> next;          // The next track in the same cell, or -1
+    std::vector<uint8_t> claimed;   // Whether a box has taken each track
+} blob_tracker_t;
+
+/*----------------------------------------------------------------------------
+ * Interface
+ *----------------------------------------------------------------------------*/
+
+/**
+ * Initializes the tracker for frames of the given size, with no tracks.
+ *
+ * @param[out] tracker The tracker to initialize.
+ * @param width The width of the full-resolution frames.
+ * @param height The height of the full-resolution frames.
+ * @param max_distance The maximum distance between a box's center and a
+ *        track's predicted center for them to be associated.
+ * @return 0 on success, -1 if the size or the distance is invalid.
+ **/
+int blob_tracker_init(blob_tracker_t& tracker, int width, int height,
+        int max_distance);
+
+/**
+ * Associates the boxes found in a frame with the tracks, and updates them.
+ *
+ * Each box, in order, takes the nearest track predicted within the maximum
+ * distance that no earlier box has taken, or starts a new track. The tracked
+ * boxes are written in the same order as the boxes.
+ *
+ * @param tracker The tracker to update.
+ * @param[in] bboxes The boxes found in the frame.
+ * @param num_bboxes The number of boxes found in the frame.
+ * @param[out] tracked The tracked boxes, which must hold num_bboxes boxes.
+ * @return The number of tracks that were associated with a box.
+ **/
+int blob_tracker_update(blob_tracker_t& tracker, const bbox_t *bboxes,
+        int num_bboxes, tracked_bbox_t *tracked);
+
+#endif /* TRACKER_H_ */
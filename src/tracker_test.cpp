@@ -0,0 +1,116 @@
+/**
+ * @file tracker_test.cpp
+ * @date Wednesday, October 28, 2026 at 01:52:38 PM EDT
+ * @author Brandon Perez (bmperez)
+ *
+ * This file contains the test for the blob tracker.
+ *
+ * @bug No known bugs.
+ **/
+
+#include <cassert>                  // Assert macro
+#include <cmath>                    // Absolute value function
+#include <cstdio>                   // C standard I/O library
+
+#include <vector>                   // Vector container
+
+#include "tracker.h"                // Blob tracker interface
+
+/*----------------------------------------------------------------------------
+ * Internal Definitions
+ *----------------------------------------------------------------------------*/
+
+// The size of the test frames
+static const int TEST_WIDTH     = 640;
+static const int TEST_HEIGHT    = 480;
+
+// The distance between the blobs in the crowded scene, and their speed
+static const int CROWD_SPACING  = 24;
+static const int CROWD_SPEED    = 5;
+
+/*----------------------------------------------------------------------------
+ * Testbench
+ *----------------------------------------------------------------------------*/
+
+// Returns a box of the given radius around the center
+static bbox_t blob_bbox(int cx, int cy, int radius)
+{
+    return bbox_t(cx - radius, cy - radius, cx + radius, cy + radius);
+}
+
+int main()
+{
+    blob_tracker_t tracker;
+    assert(blob_tracker_init(tracker, 0, TEST_HEIGHT, 16) == -1);
+    assert(blob_tracker_init(tracker, TEST_WIDTH, TEST_HEIGHT, 0) == -1);
+    assert(blob_tracker_init(tracker, TEST_WIDTH, TEST_HEIGHT,
+            TRACKER_DEFAULT_MAX_DISTANCE) == 0);
+
+    /* One blob moves right at a steady speed, and another sits still in the
+     * corner, so they keep their IDs, and the moving blob's velocity converges
+     * to its speed. */
+    bbox_t bboxes[2];
+    tracked_bbox_t tracked[2];
+    const int speed = 8;
+    for (int frame = 0; frame < 8; frame++) {
+        bboxes[0] = blob_bbox(100 + speed * frame, 200, 3);
+        bboxes[1] = blob_bbox(2, 2, 3);
+        int associated = blob_tracker_update(tracker, bboxes, 2, tracked);
+        assert(associated == ((frame == 0) ? 0 : 2));
+        assert(tracked[0].id == 1 && tracked[1].id == 2);
+        assert(tracked[0].bbox.x1 == bboxes[0].x1);
+        assert(tracked[1].vx == 0.0f && tracked[1].vy == 0.0f);
+        assert(tracked[0].vy == 0.0f);
+    }
+    assert(std::fabs(tracked[0].vx - speed) < 0.1f);
+
+    /* The moving blob is missed for two frames, and is found again where its
+     * velocity predicts, beyond the maximum distance of where it was last. */
+    int x = 100 + speed * 7;
+    for (int frame = 0; frame < 2; frame++) {
+        assert(blob_tracker_update(tracker, &bboxes[1], 1, tracked) == 1);
+    }
+    x += 3 * speed;
+    bboxes[0] = blob_bbox(x, 200, 3);
+    assert(blob_tracker_update(tracker, bboxes, 2, tracked) == 2);
+    assert(tracked[0].id == 1 && tracked[1].id == 2);
+
+    // A blob missed for too many frames is dropped, and comes back as new
+    for (int frame = 0; frame <= TRACKER_MAX_MISSES; frame++) {
+        blob_tracker_update(tracker, &bboxes[1], 1, tracked);
+    }
+    bboxes[0] = blob_bbox(x + (TRACKER_MAX_MISSES + 1) * speed, 200, 3);
+    assert(blob_tracker_update(tracker, bboxes, 2, tracked) == 1);
+    assert(tracked[0].id == 3 && tracked[1].id == 2);
+
+    /* A crowd of blobs, closer together than the grid's cells, all moving
+     * diagonally, each keep their IDs from frame to frame. */
+    assert(blob_tracker_init(tracker, TEST_WIDTH, TEST_HEIGHT,
+            TRACKER_DEFAULT_MAX_DISTANCE) == 0);
+    std::vector<bbox_t> crowd;
+    std::vector<tracked_bbox_t> crowd_tracked;
+    for (int frame = 0; frame < 10; frame++) {
+        crowd.clear();
+        int offset = CROWD_SPEED * frame;
+        for (int cy = CROWD_SPACING; cy < TEST_HEIGHT - 64;
+                cy += CROWD_SPACING) {
+            for (int cx = CROWD_SPACING; cx < TEST_WIDTH - 64;
+                    cx += CROWD_SPACING) {
+                crowd.push_back(blob_bbox(cx + offset, cy + offset, 2));
+            }
+        }
+
+        int num_blobs = crowd.size();
+        crowd_tracked.resize(num_blobs);
+        int associated = blob_tracker_update(tracker, crowd.data(), num_blobs,
+                crowd_tracked.data());
+        assert(associated == ((frame == 0) ? 0 : num_blobs));
+        for (int i = 0; i < num_blobs; i++) {
+            assert(crowd_tracked[i].id == (uint32_t)i + 1);
+        }
+    }
+    assert(tracker.tracks.size() == crowd.size());
+
+    printf("Tracker test passed.\n");
+    return 0;
+}